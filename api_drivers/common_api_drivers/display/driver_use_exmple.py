@@ -145,17 +145,12 @@ display.set_backlight(100)
 
 # task_handler.TaskHandler()
 
-# This is my prefered method of updating the display. This has time keeping
-# that is accurate to the nanosecond.
+# This is my prefered method of updating the display. LVGL gets its time from
+# MicroPython's millisecond clock (lv.init() sets that up) so there is no
+# need to call lv.tick_inc. Calling it hands the time keeping back to Python.
 
 import time
-time_passed = 1000000
 
 while True:
-    start_time = time.time_ns()
-    time.sleep_ns(1000000)
-    lv.tick_inc(int(time_passed // 1000000))
-    time_passed -= int(time_passed // 1000000) * 1000000
+    time.sleep_ms(1)
     lv.task_handler()
-    end_time = time.time_ns()
-    time_passed += time.ticks_diff(end_time, start_time)
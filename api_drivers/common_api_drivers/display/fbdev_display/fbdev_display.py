@@ -0,0 +1,149 @@
+# Copyright (c) 2024 - 2025 Kevin G. Schlosser
+
+import lvgl as lv  # NOQA
+import display_driver_framework
+
+
+BYTE_ORDER_RGB = display_driver_framework.BYTE_ORDER_RGB
+BYTE_ORDER_BGR = display_driver_framework.BYTE_ORDER_BGR
+
+
+class FBDevDisplay(display_driver_framework.DisplayDriver):
+    """
+    Display driver for `lcd_bus.FBDevBus`.
+
+    The frame buffers are the mapped device memory so LVGL renders in direct
+    mode right into the memory that is being shown. If the bus was created
+    with `page_flip=True` and the device has room for 2 screens the second
+    screen becomes the second frame buffer.
+
+    display_width, display_height and color_space have to match the mode the
+    frame buffer device is set to.
+    """
+
+    def __init__(
+        self,
+        data_bus,
+        display_width,
+        display_height,
+        frame_buffer1=None,
+        frame_buffer2=None,
+        reset_pin=None,  # NOQA
+        reset_state=display_driver_framework.STATE_HIGH,  # NOQA
+        power_pin=None,  # NOQA
+        power_on_state=display_driver_framework.STATE_HIGH,  # NOQA
+        backlight_pin=None,  # NOQA
+        backlight_on_state=display_driver_framework.STATE_HIGH,  # NOQA
+        offset_x=0,
+        offset_y=0,
+        color_byte_order=BYTE_ORDER_RGB,  # NOQA
+        color_space=lv.COLOR_FORMAT.XRGB8888,  # NOQA
+        rgb565_byte_swap=False  # NOQA
+    ):
+        super().__init__(
+            data_bus=None,
+            display_width=display_width,
+            display_height=display_height,
+            frame_buffer1=frame_buffer1,
+            frame_buffer2=frame_buffer2,
+            reset_pin=None,
+            reset_state=display_driver_framework.STATE_HIGH,
+            power_pin=None,
+            power_on_state=display_driver_framework.STATE_HIGH,
+            backlight_pin=None,
+            backlight_on_state=display_driver_framework.STATE_HIGH,
+            offset_x=offset_x,
+            offset_y=offset_y,
+            color_byte_order=color_byte_order,
+            color_space=color_space,
+            rgb565_byte_swap=False,
+            _init_bus=False
+        )
+
+        self._data_bus = data_bus
+
+        buffer_size = lv.color_format_get_size(color_space)
+        buffer_size *= display_width * display_height
+
+        # the device has to be mapped before the frame buffers are able to
+        # be handed out
+        data_bus.init(
+            display_width,
+            display_height,
+            lv.color_format_get_size(color_space) * 8,
+            buffer_size,
+            False,
+            8,
+            8
+        )
+
+        if frame_buffer1 is None:
+            frame_buffer1 = data_bus.allocate_framebuffer(buffer_size, 0)
+
+            if frame_buffer2 is None and data_bus.get_page_count() > 1:
+                frame_buffer2 = data_bus.allocate_framebuffer(buffer_size, 0)
+
+        if frame_buffer2 is not None:
+            if len(frame_buffer1) != len(frame_buffer2):
+                raise RuntimeError('Frame buffer sizes are not equal.')
+
+        self._frame_buffer1 = frame_buffer1
+        self._frame_buffer2 = frame_buffer2
+
+        self._disp_drv = lv.display_create(display_width, display_height)  # NOQA
+
+        self._disp_drv.set_color_format(color_space)
+        self._disp_drv.set_driver_data(self)
+        self._disp_drv.set_flush_cb(self._flush_cb)
+
+        # buffers that are passed in and are smaller than the screen get
+        # copied into the device memory by the bus
+        if len(frame_buffer1) == buffer_size:
+            render_mode = lv.DISPLAY_RENDER_MODE.DIRECT  # NOQA
+        else:
+            render_mode = lv.DISPLAY_RENDER_MODE.PARTIAL  # NOQA
+
+        self._disp_drv.set_buffers(
+            frame_buffer1,
+            frame_buffer2,
+            len(frame_buffer1),
+            render_mode
+        )
+
+        data_bus.register_callback(self._flush_ready_cb)
+
+        self._displays.append(self)
+
+    def invert_colors(self):
+        pass
+
+    def set_rotation(self, value):
+        self._disp_drv.set_rotation(value)
+        self._rotation = value
+
+    def init(self):
+        self._initilized = True
+
+    def set_params(self, cmd, params=None):
+        pass
+
+    def get_params(self, cmd, params):
+        pass
+
+    def get_power(self):
+        return True
+
+    def reset(self):
+        pass
+
+    def get_backlight(self):
+        return 100.0
+
+    def _dummy_set_memory_location(self, *_, **__):  # NOQA
+        return 0
+
+    def _set_memory_location(self, x1, y1, x2, y2):
+        return 0
+
+    def _madctl(self, colormode, rotations, rotation=None):
+        return 0
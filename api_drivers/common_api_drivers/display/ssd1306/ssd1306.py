@@ -4,6 +4,7 @@ from micropython import const  # NOQA
 import display_driver_framework
 
 import lcd_bus
+import lcd_utils
 import gc
 import lvgl as lv
 
@@ -19,6 +20,9 @@ _DISP_ON = const(0xAF)
 _SET_COL_ADDR = const(0x21)
 _SET_PAGE_ADDR = const(0x22)
 
+# LVGL puts a 2 color palette in front of the pixels when rendering I1
+_PALETTE_SIZE = const(8)
+
 
 class SSD1306(display_driver_framework.DisplayDriver):
 
@@ -43,7 +47,7 @@ class SSD1306(display_driver_framework.DisplayDriver):
         if not isinstance(data_bus, (lcd_bus.SPIBus, lcd_bus.I2CBus)):
             raise ValueError('Only SPI and I2C lcd busses allowed')
 
-        buf_size = int(display_width * display_height // 8)
+        buf_size = int(display_width * display_height // 8) + _PALETTE_SIZE
 
         if frame_buffer1 is None:
 
@@ -77,9 +81,32 @@ class SSD1306(display_driver_framework.DisplayDriver):
 
         self._pages = int(display_height // 8)
 
-        if len(frame_buffer1) != buf_size:
+        if len(frame_buffer1) < buf_size:
             raise ValueError(f'Framebuffer is too small ({buf_size}')
 
+        # copy of the display ram in page format. An area LVGL flushes
+        # doesn't have to line up with the pages so the rows of a page that
+        # are outside of the area need to be kept.
+        self._page_buf = bytearray(display_width * self._pages)
+
+        page_buf_size = display_width * self._pages
+        self._tx_buf = None
+
+        for flags in (
+            lcd_bus.MEMORY_INTERNAL | lcd_bus.MEMORY_DMA,
+            lcd_bus.MEMORY_INTERNAL
+        ):
+            try:
+                self._tx_buf = data_bus.allocate_framebuffer(page_buf_size, flags)
+                break
+            except MemoryError:
+                pass
+
+        if self._tx_buf is None:
+            raise MemoryError(
+                f'Unable to allocate memory for transfer buffer ({page_buf_size})'  # NOQA
+            )
+
         super().__init__(
             data_bus=data_bus,
             display_width=display_width,
@@ -122,32 +149,38 @@ class SSD1306(display_driver_framework.DisplayDriver):
             self.set_params(_DISP_OFF)
 
     def _flush_cb(self, _, area, color_p):
-        # display ram is 8192 bits in size. the is evenly divided into 8 pages.
-        # each page holds
-        # 8 pages 1024 bits (128 bytes)
-        x1 = 0
-        x2 = self.display_width - 1
+        # display ram is divided into pages that are 8 rows tall. Each byte in
+        # a page is a column of 8 pixels. Only the columns and pages the area
+        # touches get packed and sent, the column and page address window is
+        # set to match so the controller puts the data in the right place.
+        x1 = area.x1
+        x2 = area.x2
+        y1 = area.y1
+        y2 = area.y2
+
+        size = ((x2 - x1 + 8) // 8) * (y2 - y1 + 1) + _PALETTE_SIZE
+
+        # we have to use the __dereference__ method because this method is
+        # what converts from the C_Array object the binding passes into a
+        # memoryview object that can be passed to the bus drivers
+        data_view = color_p.__dereference__(size)
+
+        size = lcd_utils.i1_to_pages(
+            data_view[_PALETTE_SIZE:], self._page_buf, self.display_width,
+            x1, y1, x2, y2, out=self._tx_buf
+        )
 
         if self.display_width == 64:
             # displays with width of 64 pixels are shifted by 32
             x1 += 32
             x2 += 32
 
-        y1 = 0
-        y2 = self._pages - 1
-
         self._param_buf[0] = x1
         self._param_buf[1] = x2
         self.set_params(_SET_COL_ADDR, self._param_mv[:2])
 
-        self._param_buf[0] = y1
-        self._param_buf[1] = y2
+        self._param_buf[0] = y1 >> 3
+        self._param_buf[1] = y2 >> 3
         self.set_params(_SET_PAGE_ADDR, self._param_mv[:2])
 
-        size = int((area.x2 - area.x1 + 1) * (area.y2 - area.y1 + 1) / 8)
-
-        # we have to use the __dereference__ method because this method is
-        # what converts from the C_Array object the binding passes into a
-        # memoryview object that can be passed to the bus drivers
-        data_view = color_p.__dereference__(size)
-        self._data_bus.tx_color(-1, data_view, x1, y1, x2, y2, self._rotation, self._disp_drv.flush_is_last())
+        self._data_bus.tx_color(-1, self._tx_buf[:size], x1, y1, x2, y2, self._rotation, self._disp_drv.flush_is_last())
@@ -1,7 +1,12 @@
 # Copyright (c) 2024 - 2025 Kevin G. Schlosser
 
+from micropython import const  # NOQA
 import display_driver_framework
 
+import lcd_bus
+import lcd_utils
+import lvgl as lv
+
 
 STATE_HIGH = display_driver_framework.STATE_HIGH
 STATE_LOW = display_driver_framework.STATE_LOW
@@ -10,6 +15,120 @@ STATE_PWM = display_driver_framework.STATE_PWM
 BYTE_ORDER_RGB = display_driver_framework.BYTE_ORDER_RGB
 BYTE_ORDER_BGR = display_driver_framework.BYTE_ORDER_BGR
 
+_PAGE = const(0xB0)
+_COLUMN_UPPER = const(0x10)
+_COLUMN_LOWER = const(0x00)
+
+# LVGL puts a 2 color palette in front of the pixels when rendering I1
+_PALETTE_SIZE = const(8)
+
 
 class ST7565(display_driver_framework.DisplayDriver):
-    pass
+
+    def __init__(
+        self,
+        data_bus,
+        display_width,
+        display_height,
+        frame_buffer1=None,
+        frame_buffer2=None,
+        reset_pin=None,
+        reset_state=STATE_HIGH,
+        power_pin=None,
+        power_on_state=STATE_HIGH,
+        backlight_pin=None,
+        backlight_on_state=STATE_HIGH,
+        offset_x=0,
+        offset_y=0,
+        color_byte_order=BYTE_ORDER_RGB,
+        color_space=lv.COLOR_FORMAT.I1,  # NOQA
+        rgb565_byte_swap=False
+    ):
+        self._pages = int(display_height // 8)
+
+        # copy of the display ram in page format. An area LVGL flushes
+        # doesn't have to line up with the pages so the rows of a page that
+        # are outside of the area need to be kept.
+        self._page_buf = bytearray(display_width * self._pages)
+
+        page_buf_size = display_width * self._pages
+        self._tx_buf = None
+
+        for flags in (
+            lcd_bus.MEMORY_INTERNAL | lcd_bus.MEMORY_DMA,
+            lcd_bus.MEMORY_INTERNAL
+        ):
+            try:
+                self._tx_buf = data_bus.allocate_framebuffer(page_buf_size, flags)
+                break
+            except MemoryError:
+                pass
+
+        if self._tx_buf is None:
+            raise MemoryError(
+                f'Unable to allocate memory for transfer buffer ({page_buf_size})'  # NOQA
+            )
+
+        super().__init__(
+            data_bus=data_bus,
+            display_width=display_width,
+            display_height=display_height,
+            frame_buffer1=frame_buffer1,
+            frame_buffer2=frame_buffer2,
+            reset_pin=reset_pin,
+            reset_state=reset_state,
+            power_pin=power_pin,
+            power_on_state=power_on_state,
+            backlight_pin=backlight_pin,
+            backlight_on_state=backlight_on_state,
+            offset_x=offset_x,
+            offset_y=offset_y,
+            color_byte_order=color_byte_order,
+            color_space=color_space,  # NOQA
+            rgb565_byte_swap=rgb565_byte_swap
+        )
+
+    def _flush_cb(self, _, area, color_p):
+        # the ST7565 doesn't have a column/page address window like the
+        # SSD1306 does. The page and starting column get set and the columns
+        # for that page are written, this gets repeated for each page the
+        # area touches. Only the columns in the area are sent.
+        x1 = area.x1
+        x2 = area.x2
+        y1 = area.y1
+        y2 = area.y2
+
+        size = ((x2 - x1 + 8) // 8) * (y2 - y1 + 1) + _PALETTE_SIZE
+
+        # we have to use the __dereference__ method because this method is
+        # what converts from the C_Array object the binding passes into a
+        # memoryview object that can be passed to the bus drivers
+        data_view = color_p.__dereference__(size)
+
+        lcd_utils.i1_to_pages(
+            data_view[_PALETTE_SIZE:], self._page_buf, self.display_width,
+            x1, y1, x2, y2, out=self._tx_buf
+        )
+
+        width = x2 - x1 + 1
+        column = x1 + self._offset_x
+        last_page = y2 >> 3
+        offset = 0
+
+        for page in range(y1 >> 3, last_page + 1):
+            self.set_params(_PAGE | (page & 0x0F))
+            self.set_params(_COLUMN_UPPER | ((column >> 4) & 0x0F))
+            self.set_params(_COLUMN_LOWER | (column & 0x0F))
+
+            page_view = self._tx_buf[offset:offset + width]
+            offset += width
+
+            if page == last_page:
+                # only the last page goes out using tx_color so the flush
+                # ready callback gets called a single time.
+                self._data_bus.tx_color(
+                    -1, page_view, x1, y1, x2, y2,
+                    self._rotation, self._disp_drv.flush_is_last()
+                )
+            else:
+                self._data_bus.tx_param(-1, page_view)
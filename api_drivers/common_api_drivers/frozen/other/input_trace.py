@@ -0,0 +1,369 @@
+# Copyright (c) 2024 - 2025 Kevin G. Schlosser
+
+# Input trace recording and replay.
+#
+# `Recorder` is attached to indev drivers and writes what their `_read`
+# methods hand to LVGL into a small binary file. `Player` creates indevs that
+# feed a recorded file back to LVGL with the same timing it was recorded with
+# and measures how long it takes from each event until the first flush that
+# touches the area the event caused to be redrawn.
+#
+# File layout, all values are little endian:
+#
+#   header:  b'LVIT', version (uint8), record size (uint8)
+#   records: time in ms since the recording started (uint32),
+#            indev type (uint8), state (uint8), x (int16), y (int16),
+#            key or encoder steps (int32)
+
+import struct
+import time
+import json
+
+import lvgl as lv  # NOQA
+import _indev_base
+
+
+_MAGIC = b'LVIT'
+_VERSION = 1
+_RECORD_FMT = '<IBBhhi'
+_RECORD_SIZE = struct.calcsize(_RECORD_FMT)
+_HEADER_FMT = '<4sBB'
+_HEADER_SIZE = struct.calcsize(_HEADER_FMT)
+
+# records are kept in memory and written once this many bytes are waiting
+_WRITE_SIZE = 4096
+
+_TYPE_NAMES = {
+    lv.INDEV_TYPE.POINTER: 'pointer',  # NOQA
+    lv.INDEV_TYPE.KEYPAD: 'keypad',  # NOQA
+    lv.INDEV_TYPE.BUTTON: 'button',  # NOQA
+    lv.INDEV_TYPE.ENCODER: 'encoder'  # NOQA
+}
+
+
+class Recorder(object):
+
+    def __init__(self, path):
+        self._file = open(path, 'wb')
+        self._file.write(struct.pack(_HEADER_FMT, _MAGIC, _VERSION, _RECORD_SIZE))
+        self._buf = bytearray()
+        self._start = time.ticks_ms()  # NOQA
+        self._attached = []
+
+    def attach(self, indev):
+        """
+        Starts recording what `indev` passes to LVGL. indev is any of the
+        indev drivers (pointer, keypad, encoder or button).
+        """
+        indev_type = indev.get_type()
+        last = [None]
+
+        def _read_cb(drv, data):
+            indev._read(drv, data)  # NOQA
+
+            if indev_type == lv.INDEV_TYPE.ENCODER:  # NOQA
+                value = data.enc_diff
+            elif indev_type == lv.INDEV_TYPE.BUTTON:  # NOQA
+                value = data.btn_id
+            else:
+                value = data.key
+
+            if indev_type == lv.INDEV_TYPE.POINTER:  # NOQA
+                x, y = data.point.x, data.point.y
+            else:
+                x = y = 0
+
+            state = data.state
+            current = (state, x, y, value)
+
+            # only changes are recorded, an encoder that has been turned is
+            # always a change
+            if current == last[0] and not (indev_type == lv.INDEV_TYPE.ENCODER and value):  # NOQA
+                return
+
+            last[0] = current
+            self._buf.extend(struct.pack(
+                _RECORD_FMT,
+                time.ticks_diff(time.ticks_ms(), self._start),  # NOQA
+                indev_type,
+                state,
+                x,
+                y,
+                value
+            ))
+
+            if len(self._buf) >= _WRITE_SIZE:
+                self.flush()
+
+        indev._indev_drv.set_read_cb(_read_cb)  # NOQA
+        self._attached.append(indev)
+
+    def flush(self):
+        if self._file is not None and self._buf:
+            self._file.write(self._buf)
+            self._buf = bytearray()
+
+    def close(self):
+        for indev in self._attached:
+            indev._indev_drv.set_read_cb(indev._read)  # NOQA
+
+        self._attached = []
+
+        if self._file is not None:
+            self.flush()
+            self._file.close()
+            self._file = None
+
+
+def load(path):
+    """
+    Reads a trace file and returns a list of
+    (time_ms, indev_type, state, x, y, value) tuples.
+    """
+    with open(path, 'rb') as f:
+        data = f.read()
+
+    magic, version, record_size = struct.unpack_from(_HEADER_FMT, data, 0)
+    if magic != _MAGIC or version != _VERSION:
+        raise ValueError('not an input trace file')
+
+    records = []
+    for offset in range(_HEADER_SIZE, len(data) - record_size + 1, record_size):
+        records.append(struct.unpack_from(_RECORD_FMT, data, offset))
+
+    return records
+
+
+class _ReplayIndev(_indev_base.IndevBase):
+
+    def __init__(self, player, indev_type, records):
+        self._player = player
+        self._records = records
+        self._index = 0
+        self._state = self.RELEASED
+        self._x = 0
+        self._y = 0
+        self._value = 0
+        self._indev_type = indev_type
+
+        super().__init__()
+
+        self._set_type(indev_type)
+
+        if indev_type in (lv.INDEV_TYPE.KEYPAD, lv.INDEV_TYPE.ENCODER):  # NOQA
+            group = lv.group_get_default()  # NOQA
+            if group is not None:
+                self.set_group(group)
+
+        # the read timer has to run more often than the events were recorded
+        # for the timing to be kept
+        self.get_read_timer().set_period(1)  # NOQA
+        self._indev_drv.enable(True)  # NOQA
+
+    def _read(self, drv, data):  # NOQA
+        records = self._records
+        now = self._player.elapsed_ms()
+        enc_diff = 0
+
+        if self._index < len(records) and records[self._index][0] <= now:
+            record_index, record = records[self._index][1]
+            self._index += 1
+
+            _, _, self._state, self._x, self._y, self._value = record
+            if self._indev_type == lv.INDEV_TYPE.ENCODER:  # NOQA
+                enc_diff = self._value
+
+            self._player._injected(record_index)  # NOQA
+
+        data.state = self._state
+
+        if self._indev_type == lv.INDEV_TYPE.POINTER:  # NOQA
+            data.point.x = self._x
+            data.point.y = self._y
+        elif self._indev_type == lv.INDEV_TYPE.ENCODER:  # NOQA
+            data.enc_diff = enc_diff
+        elif self._indev_type == lv.INDEV_TYPE.BUTTON:  # NOQA
+            data.btn_id = self._value
+        else:
+            data.key = self._value
+
+        # events that were due at the same time are handed over right away
+        data.continue_reading = (
+            self._index < len(records) and records[self._index][0] <= now
+        )
+
+    @property
+    def done(self):
+        return self._index >= len(self._records)
+
+
+class Player(object):
+    """
+    Replays a trace that was made using `Recorder`. The display driver has
+    to be created before the player. Real indev drivers for the same types
+    should not be created, or be disabled, while a trace is replayed.
+    """
+
+    def __init__(self, path):
+        self._records = load(path)
+        self._events = []
+        self._collecting = []
+        self._waiting = []
+        self._start = None
+
+        by_type = {}
+        for i, record in enumerate(self._records):
+            # the index goes along with the record so the result is able to
+            # be matched to it
+            by_type.setdefault(record[1], []).append((record[0], (i, record)))
+
+        self._disp = lv.display_get_default()  # NOQA
+        self._disp.add_event_cb(self._invalidate_cb, lv.EVENT.INVALIDATE_AREA, None)  # NOQA
+        self._disp.add_event_cb(self._flush_cb, lv.EVENT.FLUSH_START, None)  # NOQA
+
+        self._indevs = [
+            _ReplayIndev(self, indev_type, records)
+            for indev_type, records in by_type.items()
+        ]
+
+    def start(self):
+        self._start = time.ticks_ms()  # NOQA
+
+    def elapsed_ms(self):
+        if self._start is None:
+            return -1
+
+        return time.ticks_diff(time.ticks_ms(), self._start)  # NOQA
+
+    @property
+    def done(self):
+        for indev in self._indevs:
+            if not indev.done:
+                return False
+        return not self._collecting and not self._waiting
+
+    def _injected(self, record_index):
+        event = {
+            'index': record_index,
+            'time_us': time.ticks_us(),  # NOQA
+            'area': None,
+            'latency_us': None
+        }
+        self._events.append(event)
+        self._collecting.append(event)
+
+    def _invalidate_cb(self, e):
+        if not self._collecting:
+            return
+
+        area = lv.area_t.__cast__(e.get_param())  # NOQA
+        x1, y1, x2, y2 = area.x1, area.y1, area.x2, area.y2
+
+        # everything that gets invalidated between an event and the next
+        # flush is the area the event has changed
+        for event in self._collecting:
+            if event['area'] is None:
+                event['area'] = [x1, y1, x2, y2]
+            else:
+                a = event['area']
+                a[0] = min(a[0], x1)
+                a[1] = min(a[1], y1)
+                a[2] = max(a[2], x2)
+                a[3] = max(a[3], y2)
+
+    def _flush_cb(self, e):
+        now = time.ticks_us()  # NOQA
+
+        for event in self._collecting:
+            if event['area'] is not None:
+                self._waiting.append(event)
+
+        self._collecting = []
+
+        if not self._waiting:
+            return
+
+        area = lv.area_t.__cast__(e.get_param())  # NOQA
+        x1, y1, x2, y2 = area.x1, area.y1, area.x2, area.y2
+
+        waiting = []
+        for event in self._waiting:
+            a = event['area']
+            if x1 <= a[2] and x2 >= a[0] and y1 <= a[3] and y2 >= a[1]:
+                event['latency_us'] = time.ticks_diff(now, event['time_us'])  # NOQA
+            else:
+                waiting.append(event)
+
+        self._waiting = waiting
+
+    def run(self, timeout_ms=None):
+        """
+        Replays the whole trace running LVGL's timer handler and returns the
+        report. This is for use without a task handler running.
+        """
+        if self._start is None:
+            self.start()
+
+        if timeout_ms is None:
+            timeout_ms = (self._records[-1][0] if self._records else 0) + 2000
+
+        while not self.done and self.elapsed_ms() < timeout_ms:
+            lv.timer_handler()  # NOQA
+            time.sleep_ms(1)  # NOQA
+
+        return self.report()
+
+    def report(self, output=None):
+        """
+        Returns the latency of every replayed event. Events that did not
+        cause anything to be redrawn have a latency of None. If output is a
+        file name the report is also written to it as JSON.
+        """
+        events = []
+        latencies = []
+
+        for event in self._events:
+            t, indev_type, state, x, y, value = self._records[event['index']]
+            latency = event['latency_us']
+
+            if latency is not None:
+                latency /= 1000.0
+                latencies.append(latency)
+
+            events.append({
+                'time_ms': t,
+                'type': _TYPE_NAMES.get(indev_type, indev_type),
+                'state': state,
+                'x': x,
+                'y': y,
+                'value': value,
+                'area': event['area'],
+                'latency_ms': latency
+            })
+
+        summary = {
+            'events': len(events),
+            'measured': len(latencies)
+        }
+
+        if latencies:
+            latencies.sort()
+            summary['latency_ms_min'] = latencies[0]
+            summary['latency_ms_avg'] = sum(latencies) / len(latencies)
+            summary['latency_ms_p95'] = latencies[min(len(latencies) - 1, int(len(latencies) * 0.95))]
+            summary['latency_ms_max'] = latencies[-1]
+
+        result = {'summary': summary, 'events': events}
+
+        if output is not None:
+            with open(output, 'w') as f:
+                f.write(json.dumps(result))
+
+        return result
+
+    def delete(self):
+        for indev in self._indevs:
+            indev.enable(False)
+            indev._indev_drv.delete()  # NOQA
+
+        self._indevs = []
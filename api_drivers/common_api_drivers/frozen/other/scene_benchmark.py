@@ -0,0 +1,392 @@
+# Copyright (c) 2024 - 2025 Kevin G. Schlosser
+
+# Scripted scene benchmarks for the unix port.
+#
+# Every scene runs for a fixed number of frames on a `lcd_bus.MemoryBus` so
+# nothing depends on a window or a display being attached. LVGL's clock is
+# stepped by a fixed amount for every frame which makes the work done in each
+# frame the same from one run to the next. The results are written as JSON so
+# runs made with different versions of LVGL and MicroPython can be compared.
+#
+# ./lvgl_micropy_unix -c "import scene_benchmark; scene_benchmark.run()"
+
+import gc
+import json
+import sys
+import time
+import struct
+import binascii
+
+import lvgl as lv  # NOQA
+import lcd_bus  # NOQA
+import _task_handler  # NOQA
+
+
+_FRAME_PERIOD = 16
+
+_IMAGE_SIZE = 96
+
+
+class _Display(object):
+
+    def __init__(self, width, height):
+        self.width = width
+        self.height = height
+
+        buffer_size = width * height * 2
+
+        self.bus = lcd_bus.MemoryBus(crc=False)
+        self.bus.init(width, height, 16, buffer_size, False, 8, 8)
+
+        # partial buffers that are a 10th of the screen is what most of the
+        # MCU boards use
+        partial_size = buffer_size // 10
+        self.buf1 = self.bus.allocate_framebuffer(partial_size, lcd_bus.MEMORY_INTERNAL)  # NOQA
+        self.buf2 = self.bus.allocate_framebuffer(partial_size, lcd_bus.MEMORY_INTERNAL)  # NOQA
+
+        self.disp = lv.display_create(width, height)  # NOQA
+        self.disp.set_color_format(lv.COLOR_FORMAT.RGB565)  # NOQA
+        self.disp.set_flush_cb(self._flush_cb)  # NOQA
+        self.disp.set_buffers(
+            self.buf1,
+            self.buf2,
+            partial_size,
+            lv.DISPLAY_RENDER_MODE.PARTIAL  # NOQA
+        )
+        self.bus.register_callback(self._flush_ready_cb)
+
+        self.flush_us = 0
+
+    def _flush_cb(self, _, area, color_p):
+        start = time.ticks_us()  # NOQA
+        x1, y1, x2, y2 = area.x1, area.y1, area.x2, area.y2
+        size = (x2 - x1 + 1) * (y2 - y1 + 1) * 2
+
+        data_view = color_p.__dereference__(size)
+        self.bus.tx_color(0, data_view, x1, y1, x2, y2, 0,
+                          self.disp.flush_is_last())
+
+        self.flush_us += time.ticks_diff(time.ticks_us(), start)  # NOQA
+
+    def _flush_ready_cb(self, *_):
+        self.disp.flush_ready()
+
+    def delete(self):
+        self.disp.delete()  # NOQA
+        self.bus.free_framebuffer(self.buf1)
+        self.bus.free_framebuffer(self.buf2)
+        self.bus.deinit()
+
+
+# ---------------------------------------------------------------------------
+# scenes
+#
+# Each scene is a class that builds its widgets on the screen it is given in
+# __init__ and changes something in step(). step() is called once before
+# each frame is rendered with the frame number.
+
+
+class WidgetsScene(object):
+    name = 'widgets'
+
+    def __init__(self, scr):
+        scr.set_flex_flow(lv.FLEX_FLOW.ROW_WRAP)  # NOQA
+        scr.set_style_pad_all(4, 0)
+
+        self.sliders = []
+        self.arcs = []
+        self.bars = []
+        self.switches = []
+
+        for i in range(6):
+            btn = lv.button(scr)  # NOQA
+            lv.label(btn).set_text('Button %d' % i)  # NOQA
+
+            slider = lv.slider(scr)  # NOQA
+            slider.set_width(100)
+            self.sliders.append(slider)
+
+            arc = lv.arc(scr)  # NOQA
+            arc.set_size(60, 60)
+            self.arcs.append(arc)
+
+            bar = lv.bar(scr)  # NOQA
+            bar.set_size(80, 12)
+            self.bars.append(bar)
+
+            sw = lv.switch(scr)  # NOQA
+            self.switches.append(sw)
+
+            cb = lv.checkbox(scr)  # NOQA
+            cb.set_text('Check %d' % i)
+
+    def step(self, frame):
+        value = frame % 100
+
+        for slider in self.sliders:
+            slider.set_value(value, lv.ANIM.OFF)  # NOQA
+        for arc in self.arcs:
+            arc.set_value(100 - value)
+        for bar in self.bars:
+            bar.set_value(value, lv.ANIM.OFF)  # NOQA
+
+        sw = self.switches[frame % len(self.switches)]
+        if sw.has_state(lv.STATE.CHECKED):  # NOQA
+            sw.remove_state(lv.STATE.CHECKED)  # NOQA
+        else:
+            sw.add_state(lv.STATE.CHECKED)  # NOQA
+
+
+class ListScrollScene(object):
+    name = 'list_scroll'
+
+    def __init__(self, scr):
+        self.list = lv.list(scr)  # NOQA
+        self.list.set_size(lv.pct(100), lv.pct(100))  # NOQA
+
+        for i in range(200):
+            self.list.add_button(None, 'List item %d' % i)
+
+        self.list.update_layout()
+
+    def step(self, _):
+        if self.list.get_scroll_bottom() <= 0:
+            self.list.scroll_to_y(0, lv.ANIM.OFF)  # NOQA
+        else:
+            self.list.scroll_by(0, -12, lv.ANIM.OFF)  # NOQA
+
+
+class AnimationScene(object):
+    name = 'animations'
+
+    def __init__(self, scr):
+        width = scr.get_width()
+        self.anims = []
+
+        for i in range(20):
+            obj = lv.obj(scr)  # NOQA
+            obj.set_size(30, 30)
+            obj.set_pos(0, i * 14)
+
+            anim = lv.anim_t()  # NOQA
+            anim.init()
+            anim.set_var(obj)
+            anim.set_values(0, width - 30)
+            anim.set_duration(800 + i * 40)
+            anim.set_repeat_count(lv.ANIM_REPEAT_INFINITE)  # NOQA
+            anim.set_path_cb(lv.anim_t.path_ease_in_out)  # NOQA
+            anim.set_custom_exec_cb(lambda _, value, o=obj: o.set_x(value))
+            anim.start()
+
+            self.anims.append(anim)
+
+    def step(self, _):
+        # LVGL runs the animations from the clock
+        pass
+
+
+def _png_chunk(tag, data):
+    chunk = tag + data
+    return (
+        struct.pack('>I', len(data)) +
+        chunk +
+        struct.pack('>I', binascii.crc32(chunk) & 0xFFFFFFFF)
+    )
+
+
+def _make_png(width, height):
+    # RGBA gradient stored with deflate blocks that are not compressed so the
+    # image is able to be made without a compressor being available
+    raw = bytearray()
+    for y in range(height):
+        raw.append(0)
+        for x in range(width):
+            raw.extend(bytes((
+                (x * 255) // width,
+                (y * 255) // height,
+                ((x + y) * 127) // (width + height),
+                0xFF
+            )))
+
+    a = 1
+    b = 0
+    for byte in raw:
+        a = (a + byte) % 65521
+        b = (b + a) % 65521
+
+    stream = bytearray(b'\x78\x01')
+    pos = 0
+    while pos < len(raw):
+        block = raw[pos:pos + 65535]
+        pos += len(block)
+        stream.append(1 if pos >= len(raw) else 0)
+        stream.extend(struct.pack('<HH', len(block), len(block) ^ 0xFFFF))
+        stream.extend(block)
+
+    stream.extend(struct.pack('>I', (b << 16) | a))
+
+    return (
+        b'\x89PNG\r\n\x1a\n' +
+        _png_chunk(b'IHDR', struct.pack('>IIBBBBB', width, height, 8, 6, 0, 0, 0)) +
+        _png_chunk(b'IDAT', bytes(stream)) +
+        _png_chunk(b'IEND', b'')
+    )
+
+
+class ImageDecodeScene(object):
+    name = 'image_decode'
+
+    def __init__(self, scr):
+        self.png = _make_png(_IMAGE_SIZE, _IMAGE_SIZE)
+        self.dsc = lv.image_dsc_t({'data_size': len(self.png), 'data': self.png})  # NOQA
+
+        self.images = []
+        for i in range(4):
+            img = lv.image(scr)  # NOQA
+            img.set_src(self.dsc)
+            img.set_pos(i * (_IMAGE_SIZE + 8), 10)
+            self.images.append(img)
+
+    def step(self, frame):
+        # dropping the cache makes the PNG get decoded again when it is drawn
+        lv.image_cache_drop(self.dsc)  # NOQA
+
+        for i, img in enumerate(self.images):
+            img.set_y(10 + (frame + i * 10) % 40)
+
+
+class LabelChurnScene(object):
+    name = 'label_churn'
+
+    def __init__(self, scr):
+        scr.set_flex_flow(lv.FLEX_FLOW.COLUMN_WRAP)  # NOQA
+        self.labels = [lv.label(scr) for _ in range(40)]  # NOQA
+
+    def step(self, frame):
+        for i, label in enumerate(self.labels):
+            label.set_text('label %d frame %d value %d' % (i, frame, (frame * 7 + i) % 1000))
+
+
+SCENES = (
+    WidgetsScene,
+    ListScrollScene,
+    AnimationScene,
+    ImageDecodeScene,
+    LabelChurnScene
+)
+
+
+def _run_scene(display, scene_cls, frames):
+    scr = lv.obj()  # NOQA
+    lv.screen_load(scr)  # NOQA
+    scene = scene_cls(scr)
+
+    # the first frame draws the whole screen, it is not part of the results
+    lv.refr_now(display.disp)  # NOQA
+
+    render_us = []
+    flush_us = []
+    alloc = []
+    peak_heap = 0
+
+    display.bus.reset_stats()
+    total_start = time.ticks_us()  # NOQA
+
+    for frame in range(frames):
+        gc.collect()
+        heap_start = gc.mem_alloc()  # NOQA
+        gc.disable()
+
+        display.flush_us = 0
+        start = time.ticks_us()  # NOQA
+
+        scene.step(frame)
+        # this takes LVGL's clock off of mp_hal_ticks_ms so every frame
+        # is the same amount of time
+        lv.tick_inc(_FRAME_PERIOD)  # NOQA
+        lv.refr_now(display.disp)  # NOQA
+
+        frame_us = time.ticks_diff(time.ticks_us(), start)  # NOQA
+
+        heap_end = gc.mem_alloc()  # NOQA
+        gc.enable()
+
+        render_us.append(frame_us - display.flush_us)
+        flush_us.append(display.flush_us)
+        alloc.append(heap_end - heap_start)
+        peak_heap = max(peak_heap, heap_end)
+
+    total_us = time.ticks_diff(time.ticks_us(), total_start)  # NOQA
+    busy_us = sum(render_us) + sum(flush_us)
+    stats = display.bus.stats()
+
+    scr.delete()  # NOQA
+    gc.collect()
+
+    def _avg(values):
+        return sum(values) / len(values) / 1000.0
+
+    return {
+        'name': scene_cls.name,
+        'frames': frames,
+        # FPS while LVGL was working, the time used by gc.collect between
+        # frames is not counted
+        'fps': frames * 1000000.0 / busy_us if busy_us else 0,
+        'wall_time_ms': total_us / 1000.0,
+        'render_ms_avg': _avg(render_us),
+        'render_ms_max': max(render_us) / 1000.0,
+        'flush_ms_avg': _avg(flush_us),
+        'flush_ms_max': max(flush_us) / 1000.0,
+        'alloc_bytes_avg': sum(alloc) / len(alloc),
+        'alloc_bytes_max': max(alloc),
+        'peak_heap_bytes': peak_heap,
+        'flush_count': stats['flush_count'],
+        'bytes_flushed': stats['bytes_sent']
+    }
+
+
+def run(frames=300, width=480, height=320, scenes=None, output=None):
+    """
+    Runs the scenes and returns the results. The results are printed as JSON
+    and are also written to `output` if a file name is given.
+
+    scenes is an optional list of scene names to run, all of them are run if
+    it is not given.
+    """
+    if not lv.is_initialized():
+        lv.init()
+
+    display = _Display(width, height)
+
+    results = {
+        'lvgl': '%d.%d.%d' % (lv.version_major(), lv.version_minor(), lv.version_patch()),  # NOQA
+        'micropython': '%d.%d.%d' % sys.implementation.version[:3],
+        'platform': sys.platform,
+        'width': width,
+        'height': height,
+        'color_depth': 16,
+        'draw_units': _task_handler.DRAW_UNITS,
+        'frames': frames,
+        'scenes': []
+    }
+
+    try:
+        for scene_cls in SCENES:
+            if scenes is not None and scene_cls.name not in scenes:
+                continue
+
+            results['scenes'].append(_run_scene(display, scene_cls, frames))
+    finally:
+        # the scenes step LVGL's clock with lv.tick_inc, it goes back to
+        # following time.ticks_ms so the rest of the program isn't affected
+        lv.tick_set_native()  # NOQA
+        display.delete()
+
+    data = json.dumps(results)
+    print(data)
+
+    if output is not None:
+        with open(output, 'w') as f:
+            f.write(data)
+
+    return results
@@ -3,15 +3,15 @@
 
 
 import lvgl as lv  # NOQA
-import micropython  # NOQA
+import _task_handler  # NOQA
 import sys
-import time
 
 from machine import Timer  # NOQA
 
 
-TASK_HANDLER_STARTED = 0x01
-TASK_HANDLER_FINISHED = 0x02
+TASK_HANDLER_STARTED = _task_handler.TASK_HANDLER_STARTED
+TASK_HANDLER_FINISHED = _task_handler.TASK_HANDLER_FINISHED
+THREADED = _task_handler.THREADED
 
 _default_timer_id = 0
 
@@ -29,14 +29,47 @@ def _default_exception_hook(e):
 
 
 class TaskHandler(object):
+    """
+    Runs LVGL from a `machine.Timer`.
+
+    Scheduling the update and calling `lv.task_handler()` is done by
+    `_task_handler` in C and LVGL gets its time from `time.ticks_ms()`, this
+    is set by `lv.init()`. The callbacks added with `add_event_cb` are the
+    only Python code that runs for a frame.
+
+    The timer period follows the time until the next LVGL timer is due so
+    the handler sleeps while the screen is idle. `duration` is the shortest
+    period that gets used and `max_period` is the longest. Invalidating an
+    area or anything else that starts an LVGL timer wakes the handler up,
+    `wake()` is able to be called from an ISR to do the same. Setting
+    `max_period` to `duration` makes the handler run at a fixed rate.
+
+    LVGL reads the input devices from timers of their own every 33ms which
+    would keep the handler from sleeping. Once none of the input devices is
+    pressed or scrolling their read timers are paused and they get read
+    every `input_idle_period` milliseconds instead, `wake()` reads them right
+    away. The read timers are resumed as soon as one of them has input.
+    Setting `input_idle_period` to 0 leaves the read timers running.
+
+    `max_scheduled` is no longer used, an update is never scheduled while
+    another one is waiting to run. It is kept so existing code doesn't break.
+
+    When the firmware was built with `--lvgl-threads` (`THREADED` is True)
+    no timer is used, LVGL runs on a thread of its own and the callbacks
+    added with `add_event_cb` are run by the thread the VM is running on.
+    Code that changes widgets outside of an LVGL callback has to do it
+    inside of a `with lv.lock():` block.
+    """
     _current_instance = None
 
     def __init__(
         self,
         duration=33,
         timer_id=_default_timer_id,
-        max_scheduled=2,
-        exception_hook=_default_exception_hook
+        max_scheduled=2,  # NOQA
+        exception_hook=_default_exception_hook,
+        max_period=1000,
+        input_idle_period=100
     ):
         if TaskHandler._current_instance is not None:
             self.__dict__.update(TaskHandler._current_instance.__dict__)
@@ -51,20 +84,26 @@ class TaskHandler(object):
             self.duration = duration
             self.exception_hook = exception_hook
 
-            self._timer = Timer(timer_id)
-
-            # Allocation occurs here
-            self._task_handler_ref = self._task_handler
-            self.max_scheduled = max_scheduled
-
-            self._start_time = time.ticks_ms()  # NOQA
-            self._timer.init(
-                mode=Timer.PERIODIC,
-                period=self.duration,
-                callback=self._timer_cb
+            if exception_hook == _default_exception_hook:
+                callback_exception_hook = None
+            else:
+                callback_exception_hook = exception_hook
+
+            if THREADED:
+                self._timer = None
+            else:
+                self._timer = Timer(timer_id)
+
+            # the native handler starts the timer and changes its period
+            self._handler = _task_handler.TaskHandler(
+                self._timer,
+                self._callbacks,
+                exception_hook,
+                callback_exception_hook,
+                duration=duration,
+                max_period=max_period,
+                input_idle_period=input_idle_period
             )
-            self._scheduled = 0
-            self._running = False
 
     def add_event_cb(self, callback, event, user_data=_DefaultUserData):
         for i, (cb, evt, data) in enumerate(self._callbacks):
@@ -84,93 +123,22 @@ class TaskHandler(object):
     def remove_event_cb(self, callback):
         for (cb, evt, data) in self._callbacks:
             if cb == callback:
-                self._callbacks.remove((cb,evt,data))
+                self._callbacks.remove((cb, evt, data))
                 break
 
     def deinit(self):
-        self._timer.deinit()
+        self._handler.deinit()
         TaskHandler._current_instance = None
 
     def disable(self):
-        self._scheduled += self.max_scheduled
+        self._handler.disable()
 
     def enable(self):
-        self._scheduled -= self.max_scheduled
+        self._handler.enable()
+
+    def wake(self):
+        self._handler.wake()
 
     @classmethod
     def is_running(cls):
         return cls._current_instance is not None
-
-    def _task_handler(self, _):
-        try:
-            self._scheduled -= 1
-
-            if lv._nesting.value == 0:  # NOQA
-                self._running = True
-
-                run_update = True
-                for cb, evt, data in self._callbacks:
-                    if not evt & TASK_HANDLER_STARTED:
-                        continue
-
-                    try:
-                        if cb(TASK_HANDLER_STARTED, data) is False:
-                            run_update = False
-
-                    except Exception as err:  # NOQA
-                        if (
-                            self.exception_hook and
-                            self.exception_hook != _default_exception_hook
-                        ):
-                            self.exception_hook(err)
-                        else:
-                            sys.print_exception(err)  # NOQA
-
-                stop_time = time.ticks_ms()  # NOQA
-
-                ticks_diff = time.ticks_diff(stop_time, self._start_time)  # NOQA
-                self._start_time = stop_time
-                lv.tick_inc(ticks_diff)
-
-                if run_update:
-                    lv.task_handler()
-                    start_time = time.ticks_ms()  # NOQA
-
-                    for cb, evt, data in self._callbacks:
-                        if not evt & TASK_HANDLER_FINISHED:
-                            continue
-
-                        try:
-                            cb(TASK_HANDLER_FINISHED, data)
-                        except Exception as err:  # NOQA
-                            if (
-                                self.exception_hook and
-                                self.exception_hook != _default_exception_hook
-                            ):
-                                self.exception_hook(err)
-                            else:
-                                sys.print_exception(err)  # NOQA
-
-                    stop_time = time.ticks_ms()  # NOQA
-                    ticks_diff = time.ticks_diff(stop_time, start_time)  # NOQA
-                    lv.tick_inc(ticks_diff)
-
-                self._running = False
-
-        except Exception as e:
-            self._running = False
-            
-            if self.exception_hook:
-                self.exception_hook(e)
-
-    def _timer_cb(self, _):
-        lv.tick_inc(self.duration)
-        if self._running:
-            return
-
-        if self._scheduled < self.max_scheduled:
-            try:
-                micropython.schedule(self._task_handler_ref, 0)
-                self._scheduled += 1
-            except:  # NOQA
-                pass
@@ -1,11 +1,48 @@
 # Copyright (c) 2024 - 2025 Kevin G. Schlosser
 
-import struct
-import select
+# LVGL indev driver for evdev keyboards
+# (for the unix micropython port)
+
+import _evdev
 import keypad_framework
 import lvgl as lv  # NOQA
 
 
-
 class EvdevKeyboardDriver(keypad_framework.KeypadDriver):
-    pass
+    """
+    Keyboard driver for /dev/input/event* devices. Keys are translated to
+    LVGL keys using a US layout by the `_evdev` module and queued there so
+    each key that gets pressed reaches LVGL even when several arrive between
+    2 reads.
+    """
+
+    def __init__(self, device, grab=False):
+        super().__init__()
+
+        if not device.startswith('/'):
+            device = f'/dev/input/{device}'
+
+        self._device = _evdev.Device(
+            device,
+            hor_res=self._width,
+            ver_res=self._height,
+            grab=grab
+        )
+
+        self.group = lv.group_create()
+        self.group.set_default()  # NOQA
+        self.set_group(self.group)
+
+    def _get_key(self):
+        # everything is done in _read
+        return None
+
+    def _read(self, drv, data):  # NOQA
+        self._device.read_key(data)
+
+    def get_name(self):
+        return self._device.get_name()
+
+    def delete(self):
+        self._indev_drv.enable(False)  # NOQA
+        self._device.close()
@@ -163,20 +163,21 @@ class SDLKeyboard(keypad_framework.KeypadDriver):
         super().__init__()
         self.__last_key = ord(' ')
         self.__current_state = self.RELEASED
+        self.__pending = 0
 
         self.group = lv.group_create()
         self.group.set_default()  # NOQA
         self.set_group(self.group)
         # self.set_mode(lv.INDEV_MODE.EVENT)  # NOQA
 
-        self._py_disp_drv._data_bus.register_keypad_callback(self._keypad_cb)  # NOQA
+        # keys get queued by the SDL bus and are read one at a time from
+        # LVGL's read callback
+        self._data_bus = self._py_disp_drv._data_bus  # NOQA
 
     def set_mode(self, mode):
         self._indev_drv.set_mode(mode)  # NOQA
 
-    def _keypad_cb(self, *args):
-        _, state, key, mod = args
-
+    def _keypad_cb(self, state, key, mod):
         if KEYPAD_0 <= key <= KEYPAD_EQUALS:
             if mod == MOD_KEY_NUM:
                 mapping = {
@@ -245,7 +246,17 @@ class SDLKeyboard(keypad_framework.KeypadDriver):
         else:
             self.__current_state = self.RELEASED
 
-        # micropython.schedule(SDLKeyboard.read, self)
+    def _read(self, drv, data):  # NOQA
+        super()._read(drv, data)
+        data.continue_reading = self.__pending > 0
 
     def _get_key(self):
+        event = self._data_bus.read_key()
+
+        if event is None:
+            self.__pending = 0
+        else:
+            state, key, mod, self.__pending = event
+            self._keypad_cb(state, key, mod)
+
         return self.__current_state, self.__last_key
@@ -25,9 +25,12 @@ class SDLPointer(pointer_framework.PointerDriver):
         self.__wheel_y = 0
         self.__scroll_obj = None
         self.__button_state = self.RELEASED
-        self.set_mode(lv.INDEV_MODE.EVENT)  # NOQA
+        self.__pending = 0
 
-        self._py_disp_drv._data_bus.register_mouse_callback(self._mouse_cb)  # NOQA
+        # the SDL bus queues the pointer events while it polls SDL. The read
+        # timer drains that queue so Python only gets involved once for each
+        # LVGL read instead of once for every mouse motion event.
+        self._data_bus = self._py_disp_drv._data_bus  # NOQA
 
     def set_mode(self, mode):
         self._indev_drv.set_mode(mode)  # NOQA
@@ -65,20 +68,27 @@ class SDLPointer(pointer_framework.PointerDriver):
         self.__wheel_x = 0
         self.__wheel_y = 0
 
-    def _mouse_cb(self, _, state, x, y, wheel_x, wheel_y):
-        self.__x = x
-        self.__y = y
-        self.__wheel_x = wheel_x
-        self.__wheel_y = wheel_y
+    def _read(self, drv, data):  # NOQA
+        super()._read(drv, data)
+        # button transitions that are still queued get read right away so
+        # a click that happened between 2 reads is not lost
+        data.continue_reading = self.__pending > 0
 
-        if state:
-            self.__button_state = self.PRESSED
+    def _get_coords(self):
+        event = self._data_bus.read_pointer()
+
+        if event is None:
+            self.__pending = 0
         else:
-            self.__button_state = self.RELEASED
+            state, self.__x, self.__y, wheel_x, wheel_y, self.__pending = event
+            self.__wheel_x += wheel_x
+            self.__wheel_y += wheel_y
 
-        self.read()
+            if state:
+                self.__button_state = self.PRESSED
+            else:
+                self.__button_state = self.RELEASED
 
-    def _get_coords(self):
         obj = self._get_object()
 
         if obj is not None:
@@ -10,6 +10,7 @@ from micropython import const  # NOQA
 import lvgl as lv  # NOQA
 import lcd_bus
 import io_expander_framework
+import task_handler
 
 
 try:
@@ -35,6 +36,13 @@ _MADCTL_MV = const(0x20)  # 0=Normal, 1=Row/column exchange
 _MADCTL_MX = const(0x40)  # 0=Left to Right, 1=Right to Left
 _MADCTL_MY = const(0x80)  # 0=Top to Bottom, 1=Bottom to Top
 
+# what it costs to start a new window (CASET, RASET and RAMWR) expressed as
+# the number of bytes of pixel data that could be sent in the same time.
+# 11 bytes go over the wire and the rest covers the per transaction
+# overhead of the bus. Compare tx_param_count and blocked_time_us from
+# the bus stats() to tune it for a specific bus.
+_COALESCE_CMD_OVERHEAD = const(96)
+
 
 STATE_HIGH = 1
 STATE_LOW = 0
@@ -127,6 +135,14 @@ class DisplayDriver:
         self._initilized = False
         self._backup_set_memory_location = None
 
+        self._coalesce_overhead = 0
+        self._coalesce_px_size = 0
+        self._coalesce_areas = []
+        self._coalesce_len = 0
+        self._coalesce_count = 0
+
+        self._native_flush = None
+
         self._rotation = lv.DISPLAY_ROTATION._0  # NOQA
 
         self._rgb565_byte_swap = rgb565_byte_swap
@@ -274,7 +290,28 @@ class DisplayDriver:
                 self._dummy_set_memory_location
             )
 
-        self._data_bus.register_callback(self._flush_ready_cb)
+        if (
+            isinstance(self._data_bus, lcd_bus.RGBBus) and
+            self._data_bus.get_vsync_stats()['enabled']
+        ):
+            # LVGL's refresh timer runs at the refresh rate of the panel and
+            # is made ready as soon as a frame has been swapped in
+            vsync_stats = self._data_bus.get_vsync_stats()
+            self._refr_timer = self._disp_drv.get_refr_timer()
+            self._refr_timer.set_period(
+                max(1, vsync_stats['refresh_period_us'] // 1000)
+            )
+            # bound once so scheduling it doesn't allocate
+            self._vsync_swapped_ref = self._vsync_swapped
+            self._data_bus.register_callback(self._vsync_flush_ready_cb)
+        else:
+            self._data_bus.register_callback(self._flush_ready_cb)
+
+        # LVGL runs on a thread of its own, flushing from C keeps it from
+        # having to wait on the VM thread for every area
+        if task_handler.THREADED and self._native_flush_window() is not None:
+            self.set_native_flush(True)
+
         self.set_default()
         self._disp_drv.add_event_cb(
             self._on_size_change,
@@ -284,6 +321,174 @@ class DisplayDriver:
 
         self._displays.append(self)
 
+    def set_flush_coalescing(self, enable, cmd_overhead=_COALESCE_CMD_OVERHEAD):
+        """
+        Merges the areas that get invalidated during a refresh so fewer and
+        larger windows get flushed. Two areas get merged when sending the
+        area that covers both costs less than sending them separately. The
+        cost of an area is the number of bytes in it plus `cmd_overhead`.
+
+        LVGL already merges areas when the merged area has fewer pixels,
+        which is the same thing with a `cmd_overhead` of 0.
+        """
+        if enable and not self._coalesce_overhead:
+            self._disp_drv.add_event_cb(
+                self._on_invalidate_area,
+                lv.EVENT.INVALIDATE_AREA,  # NOQA
+                None
+            )
+            self._disp_drv.add_event_cb(
+                self._on_refresh_ready,
+                lv.EVENT.REFR_READY,  # NOQA
+                None
+            )
+        elif not enable and self._coalesce_overhead:
+            self._disp_drv.remove_event_cb_with_user_data(
+                self._on_invalidate_area, None)
+            self._disp_drv.remove_event_cb_with_user_data(
+                self._on_refresh_ready, None)
+
+        if enable:
+            # 0 is used to mark coalescing as being turned off
+            self._coalesce_overhead = max(1, cmd_overhead)
+            self._coalesce_px_size = lv.color_format_get_size(self._color_space)
+        else:
+            self._coalesce_overhead = 0
+
+        self._coalesce_len = 0
+
+    def _native_flush_window(self):
+        # the commands the native flush sets the address window with, None
+        # when the driver flushes in a way the native flush doesn't know
+        if type(self)._flush_cb is not DisplayDriver._flush_cb:
+            return None
+
+        if isinstance(self._data_bus, lcd_bus.RGBBus):
+            if self._data_bus.get_vsync_stats()['enabled']:
+                return None
+            return -1, -1
+
+        if type(self)._set_memory_location is not DisplayDriver._set_memory_location:
+            return None
+
+        return _CASET, _RASET
+
+    def set_native_flush(self, enable):
+        """
+        Sends the areas LVGL renders to the bus from C instead of calling
+        `_flush_cb`, the bus tells LVGL the area has been sent from C as well.
+        This gets turned on by itself when LVGL runs on a thread of its own
+        (`task_handler.THREADED`).
+
+        Only drivers that use the flush and the address window of this class
+        are able to use it, NotImplementedError is raised for the others.
+        """
+        if enable:
+            window = self._native_flush_window()
+            if window is None:
+                raise NotImplementedError(
+                    'this driver sends the areas in a way the native flush '
+                    'does not support'
+                )
+
+            self._native_flush = lv.display_set_native_flush(
+                self._disp_drv,
+                self._data_bus,
+                self._offset_x,
+                self._offset_y,
+                _RAMWR,
+                window[0],
+                window[1]
+            )
+            self._data_bus.register_callback(self._native_flush)
+        elif self._native_flush is not None:
+            lv.display_set_native_flush(self._disp_drv, None)
+            self._native_flush = None
+
+            self._disp_drv.set_flush_cb(self._flush_cb)
+            self._data_bus.register_callback(self._flush_ready_cb)
+
+    def get_coalesce_count(self):
+        # number of times an area has been merged into another area
+        return self._coalesce_count
+
+    def _on_invalidate_area(self, e):
+        # The area passed with the event is what LVGL adds to the invalidated
+        # areas. Growing it so it covers an area that was already invalidated
+        # causes LVGL to drop the smaller area when it joins the areas.
+        area = lv.area_t.__cast__(e.get_param())  # NOQA
+
+        x1 = area.x1
+        y1 = area.y1
+        x2 = area.x2
+        y2 = area.y2
+
+        bpp = self._coalesce_px_size
+        overhead = self._coalesce_overhead
+        size = (x2 - x1 + 1) * (y2 - y1 + 1) * bpp
+
+        # This runs for every invalidated area so nothing gets allocated.
+        # The areas are stored one after the other as x1, y1, x2, y2 and
+        # size and only the first _coalesce_len ints are used, the list
+        # only grows when there are more areas than there have been before.
+        areas = self._coalesce_areas
+        end = self._coalesce_len
+        i = 0
+
+        while i < end:
+            ux1 = min(x1, areas[i])
+            uy1 = min(y1, areas[i + 1])
+            ux2 = max(x2, areas[i + 2])
+            uy2 = max(y2, areas[i + 3])
+
+            u_size = (ux2 - ux1 + 1) * (uy2 - uy1 + 1) * bpp
+
+            # one window instead of two saves one command overhead
+            if u_size <= size + areas[i + 4] + overhead:
+                x1 = ux1
+                y1 = uy1
+                x2 = ux2
+                y2 = uy2
+                size = u_size
+
+                # the last area takes the place of the one that was merged
+                # and the larger area gets checked against all of them again
+                end -= 5
+                areas[i] = areas[end]
+                areas[i + 1] = areas[end + 1]
+                areas[i + 2] = areas[end + 2]
+                areas[i + 3] = areas[end + 3]
+                areas[i + 4] = areas[end + 4]
+
+                self._coalesce_count += 1
+                i = 0
+            else:
+                i += 5
+
+        if end == len(areas):
+            areas.append(x1)
+            areas.append(y1)
+            areas.append(x2)
+            areas.append(y2)
+            areas.append(size)
+        else:
+            areas[end] = x1
+            areas[end + 1] = y1
+            areas[end + 2] = x2
+            areas[end + 3] = y2
+            areas[end + 4] = size
+
+        self._coalesce_len = end + 5
+
+        area.x1 = x1
+        area.y1 = y1
+        area.x2 = x2
+        area.y2 = y2
+
+    def _on_refresh_ready(self, _):
+        # everything that was invalidated has been flushed
+        self._coalesce_len = 0
+
     def _on_size_change(self, _):
         rotation = self._disp_drv.get_rotation()
         self._width = self._disp_drv.get_horizontal_resolution()
@@ -326,6 +531,9 @@ class DisplayDriver:
     def set_offset(self, x, y):
         self._offset_x, self._offset_y = x, y
 
+        if self._native_flush is not None:
+            self.set_native_flush(True)
+
     def get_offset_x(self):
         return self._disp_drv.get_offset_x()
 
@@ -342,6 +550,9 @@ class DisplayDriver:
         self._disp_drv.set_color_format(color_space)
         self._color_space = color_space
 
+        if self._coalesce_overhead:
+            self._coalesce_px_size = lv.color_format_get_size(color_space)
+
     def get_color_format(self):
         return self._color_space
 
@@ -514,6 +725,10 @@ class DisplayDriver:
     def __del__(self):
         if self in self._displays:
             self._displays.remove(self)
+
+            if self._native_flush is not None:
+                lv.display_set_native_flush(self._disp_drv, None)
+
             self._disp_drv.delete()
 
         if not self._displays and lv.is_initialized():
@@ -608,6 +823,28 @@ class DisplayDriver:
     def _flush_ready_cb(self, *_):
         self._disp_drv.flush_ready()
 
+    # used by the RGBBus when vsync_refresh is set, swapped is True once the
+    # last flush of a frame has been shown on the panel. This runs on the
+    # bus's copy task, the refresh timer is only able to be touched while
+    # holding the LVGL lock so that is handed over to the VM
+    def _vsync_flush_ready_cb(self, swapped=False):
+        self._disp_drv.flush_ready()
+
+        if swapped:
+            try:
+                micropython.schedule(self._vsync_swapped_ref, None)
+            except RuntimeError:
+                # the schedule queue is full, the refresh timer still runs
+                # once every refresh period
+                pass
+
+    def _vsync_swapped(self, _):
+        with lv.lock():
+            self._refr_timer.ready()
+
+        if task_handler.TaskHandler.is_running():
+            task_handler.TaskHandler._current_instance.wake()  # NOQA
+
     def _madctl(self, colormode, rotations, rotation=None):
         if rotation is None:
             rotation = ~self._rotation
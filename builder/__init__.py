@@ -12,6 +12,8 @@ _windows_env = None
 
 
 DO_NOT_SCRUB_BUILD_FOLDER = False
+# number of threads LVGL's software renderer draws with, set by make.py
+DRAW_UNITS = 1
 
 
 def scrub_build_folder():
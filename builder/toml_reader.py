@@ -85,6 +85,9 @@ class TOMLObject(metaclass=TOMLMeta):
         if self.name == 'SDLDisplay':
             return 'sdl_display.SDLDisplay'
 
+        if self.name == 'FBDevDisplay':
+            return 'fbdev_display.FBDevDisplay'
+
         if self.name == 'SDLPointer':
             return 'sdl_pointer.SDLPointer'
 
@@ -109,7 +112,9 @@ class TOMLObject(metaclass=TOMLMeta):
         if self.name in io_expanders:
             return self.name
 
-        if self.name in ('I80Bus', 'SPIBus', 'I2CBus', 'RGBBus'):
+        if self.name in (
+            'I80Bus', 'SPIBus', 'I2CBus', 'RGBBus', 'MemoryBus', 'FBDevBus'
+        ):
             return 'lcd_bus.' + self.name
 
         if self.parent is None:
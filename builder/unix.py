@@ -2,6 +2,7 @@
 
 import os
 import sys
+import json
 import shutil
 from . import spawn
 from . import generate_manifest
@@ -29,6 +30,10 @@ compile_cmd = []
 submodules_cmd = []
 heap_size = 4194304
 sdl_flags = ''
+benchmark = False
+benchmark_frames = 300
+benchmark_draw_units = []
+base_lv_cflags = ''
 
 REAL_PORT = 'unix'
 
@@ -36,6 +41,9 @@ REAL_PORT = 'unix'
 def parse_args(extra_args, lv_cflags, board):
     global heap_size
     global sdl_flags
+    global benchmark
+    global benchmark_frames
+    global benchmark_draw_units
 
     unix_argParser = ArgumentParser(prefix_chars='-S')
 
@@ -56,6 +64,38 @@ def parse_args(extra_args, lv_cflags, board):
         default='',
         action='store'
     )
+
+    unix_argParser.add_argument(
+        '--benchmark',
+        dest='benchmark',
+        help='freeze the scene benchmarks into the firmware and run them '
+             'once the build has finished. The results get written to '
+             'build/benchmark_unix.json',
+        default=False,
+        action='store_true'
+    )
+
+    unix_argParser.add_argument(
+        '--benchmark-frames',
+        dest='benchmark_frames',
+        help='number of frames each benchmark scene is run for. Default is 300',
+        default=300,
+        type=int,
+        action='store'
+    )
+
+    unix_argParser.add_argument(
+        '--benchmark-draw-units',
+        dest='benchmark_draw_units',
+        help='comma separated draw unit counts (1,2,4). The firmware is '
+             'built and the scene benchmarks are run once for each of them '
+             'and the results get written to '
+             'build/benchmark_unix_draw_units.json. Turns on --benchmark',
+        default='',
+        type=str,
+        action='store'
+    )
+
     unix_args, extra_args = unix_argParser.parse_known_args(extra_args)
 
     if unix_args.heap_size < 102400:
@@ -63,6 +103,17 @@ def parse_args(extra_args, lv_cflags, board):
 
     heap_size = unix_args.heap_size
     sdl_flags = unix_args.sdl_flags
+    benchmark = unix_args.benchmark
+    benchmark_frames = unix_args.benchmark_frames
+
+    if unix_args.benchmark_draw_units:
+        benchmark_draw_units = sorted(set(
+            int(count) for count in unix_args.benchmark_draw_units.split(',')
+        ))
+        if benchmark_draw_units[0] < 1:
+            raise RuntimeError('--benchmark-draw-units has to be 1 or more')
+
+        benchmark = True
 
     return extra_args, lv_cflags, board
 
@@ -73,11 +124,13 @@ SCRIPT_PATH = ''
 
 def build_commands(_, extra_args, script_dir, lv_cflags, board):
     global variant
+    global base_lv_cflags
 
     if board is None:
         board = 'standard'
 
     variant = board
+    base_lv_cflags = lv_cflags
 
     unix_cmd.append(f'{script_dir}/lib/micropython/ports/unix')
 
@@ -132,8 +185,19 @@ def build_manifest(
 
     manifest_path = 'lib/micropython/ports/unix/variants/manifest.py'
 
+    addl_manifest_files = [
+        f'{script_dir}/api_drivers/common_api_drivers/'
+        f'frozen/other/input_trace.py'
+    ]
+    if benchmark:
+        addl_manifest_files.append(
+            f'{script_dir}/api_drivers/common_api_drivers/'
+            f'frozen/other/scene_benchmark.py'
+        )
+
     generate_manifest(script_dir, lvgl_api, manifest_path, displays,
-                      indevs, expanders, imus, frozen_manifest)
+                      indevs, expanders, imus, frozen_manifest,
+                      *addl_manifest_files)
 
 
 def force_clean(clean_mpy_cross):
@@ -447,16 +511,180 @@ def compile(*args):  # NOQA
         revert_files(REAL_PORT)
         sys.exit(return_code)
 
-    scrub_build_folder()
-
     src = f'lib/micropython/ports/unix/build-{variant}/micropython'
     dst = f'build/lvgl_micropy_{REAL_PORT}'
     shutil.copyfile(src, dst)
 
+    # the other builds need the manifest and the headers the build folder
+    # gets scrubbed of
+    if benchmark_draw_units:
+        run_draw_units_benchmark(args)
+
+    scrub_build_folder()
+
     print(f'compiled binary is {os.path.abspath(os.path.split(dst)[0])}')
     print('You need to make the binary executable by running')
     print(f'"sudo chmod +x lvgl_micropy_{REAL_PORT}"')
 
+    if benchmark:
+        run_benchmark(dst)
+
+
+def run_scene_benchmark(binary, output):
+    os.chmod(binary, 0o755)
+
+    output = os.path.abspath(output)
+    code = (
+        'import scene_benchmark;'
+        f"scene_benchmark.run(frames={benchmark_frames}, output='{output}')"
+    )
+
+    return_code, _ = spawn([os.path.abspath(binary), '-c', f'"{code}"'])
+    if return_code != 0:
+        sys.exit(return_code)
+
+    print(f'benchmark results written to {output}')
+
+    with open(output, 'r') as f:
+        return json.loads(f.read())
+
+
+# The draw unit count is compiled into LVGL so the firmware gets built again
+# for every count. All of the builds run LVGL on its own thread so the number
+# of draw units is the only thing that is different between them
+def run_draw_units_benchmark(args):
+    results = {}
+
+    cflags = [
+        flag for flag in base_lv_cflags.split()
+        if not flag.startswith(('-DLV_DRAW_SW_DRAW_UNIT_CNT=', '-DLV_USE_OS='))
+    ]
+    cflags.append('-DLV_USE_OS=LV_OS_PTHREAD')
+
+    for draw_units in benchmark_draw_units:
+        lv_cflags = ' '.join(
+            cflags + [f'-DLV_DRAW_SW_DRAW_UNIT_CNT={draw_units}']
+        )
+
+        cmd_ = [
+            f'LV_CFLAGS="{lv_cflags}"' if item.startswith('LV_CFLAGS=')
+            else item for item in compile_cmd
+        ]
+        cmd_.extend(list(args))
+
+        # make doesn't see that LV_CFLAGS changed
+        spawn(clean_cmd)
+        return_code, _ = spawn(cmd_)
+        if return_code != 0:
+            revert_files(REAL_PORT)
+            sys.exit(return_code)
+
+        binary = f'build/lvgl_micropy_{REAL_PORT}_{draw_units}_draw_units'
+        shutil.copyfile(
+            f'lib/micropython/ports/unix/build-{variant}/micropython',
+            binary
+        )
+
+        results[draw_units] = run_scene_benchmark(
+            binary,
+            f'build/benchmark_{REAL_PORT}_{draw_units}_draw_units.json'
+        )
+
+    # the objects of the last build would otherwise end up in the next one
+    spawn(clean_cmd)
+
+    # FPS of each scene for every count and how it compares to the lowest count
+    base = benchmark_draw_units[0]
+    scenes = []
+
+    for scene in results[base]['scenes']:
+        fps = {}
+        render_ms_avg = {}
+        speedup = {}
+
+        for draw_units in benchmark_draw_units:
+            for other in results[draw_units]['scenes']:
+                if other['name'] == scene['name']:
+                    fps[str(draw_units)] = other['fps']
+                    render_ms_avg[str(draw_units)] = other['render_ms_avg']
+                    speedup[str(draw_units)] = (
+                        other['fps'] / scene['fps'] if scene['fps'] else 0
+                    )
+                    break
+
+        scenes.append({
+            'name': scene['name'],
+            'fps': fps,
+            'render_ms_avg': render_ms_avg,
+            'speedup': speedup
+        })
+
+    output = os.path.abspath(f'build/benchmark_{REAL_PORT}_draw_units.json')
+    with open(output, 'w') as f:
+        f.write(json.dumps({
+            'draw_units': benchmark_draw_units,
+            'scenes': scenes,
+            'results': {
+                str(draw_units): result
+                for draw_units, result in results.items()
+            }
+        }, indent=2))
+
+    print(f'draw unit benchmark results written to {output}')
+
+
+def run_benchmark(binary):
+    from . import DRAW_UNITS
+
+    # results for more than one draw unit are kept apart so they are able to
+    # be compared to a build that uses a single draw unit
+    if DRAW_UNITS > 1:
+        output = f'build/benchmark_{REAL_PORT}_{DRAW_UNITS}_draw_units.json'
+    else:
+        output = f'build/benchmark_{REAL_PORT}.json'
+
+    run_scene_benchmark(binary, output)
+
+    run_host_benchmark(
+        'rotation',
+        'lcd_rotation.c',
+        'rgb565_dither.c'
+    )
+
+    run_host_benchmark(
+        'convert',
+        'lcd_convert.c'
+    )
+
+
+# the portable lcd_bus code is built with the host compiler on its own and
+# checked/timed outside of MicroPython
+def run_host_benchmark(name, *sources):
+    lcd_bus_dir = os.path.abspath('ext_mod/lcd_bus')
+    binary = os.path.abspath(f'build/{name}_bench')
+    output = os.path.abspath(f'build/benchmark_{REAL_PORT}_{name}.json')
+
+    cmd_ = [
+        os.environ.get('CC', 'cc'),
+        '-O2',
+        '-std=gnu11',
+        f'-I{lcd_bus_dir}',
+        f'-I{lcd_bus_dir}/host_bench',
+        '-o', binary,
+        f'{lcd_bus_dir}/host_bench/{name}_bench.c'
+    ]
+    cmd_.extend(f'{lcd_bus_dir}/{source}' for source in sources)
+
+    return_code, _ = spawn(cmd_)
+    if return_code != 0:
+        sys.exit(return_code)
+
+    return_code, _ = spawn([binary, output])
+    if return_code != 0:
+        sys.exit(return_code)
+
+    print(f'{name} benchmark results written to {output}')
+
 
 def mpy_cross():
     _cmd = [
@@ -0,0 +1,95 @@
+// Copyright (c) 2024 - 2025 Kevin G. Schlosser
+
+#include "py/obj.h"
+#include "py/runtime.h"
+
+#ifndef __EVDEV_H__
+    #define __EVDEV_H__
+
+    #if defined(__linux__)
+        #include <linux/input.h>
+
+        // number of input_event structures a single read() is able to return
+        #define EVDEV_READ_COUNT    (64)
+        #define EVDEV_POINTER_QUEUE (16)
+        #define EVDEV_KEY_QUEUE     (32)
+        #define EVDEV_MT_SLOTS      (10)
+
+        typedef struct _evdev_point_t {
+            int32_t x;
+            int32_t y;
+            uint8_t state;
+            bool motion;
+        } evdev_point_t;
+
+        typedef struct _evdev_key_t {
+            uint32_t key;
+            uint8_t state;
+        } evdev_key_t;
+
+        typedef struct _evdev_axis_t {
+            int32_t min;
+            int32_t max;
+        } evdev_axis_t;
+
+        typedef struct _evdev_contact_t {
+            int32_t tracking_id;
+            int32_t x;
+            int32_t y;
+        } evdev_contact_t;
+
+        /*
+        The events that are read from the device get folded into the pending
+        state as they come in. SYN_REPORT commits the pending pointer state
+        to the pointer queue, key presses get queued as soon as they arrive.
+        The queues are what LVGL's read callback drains, one entry per read
+        with continue_reading set while there is more.
+        */
+        typedef struct _mp_evdev_device_obj_t {
+            mp_obj_base_t base;
+
+            int fd;
+            bool grab;
+
+            struct input_event events[EVDEV_READ_COUNT];
+
+            uint16_t hor_res;
+            uint16_t ver_res;
+            bool swap_xy;
+            bool mirror_x;
+            bool mirror_y;
+
+            evdev_axis_t abs_x;
+            evdev_axis_t abs_y;
+            evdev_axis_t mt_x;
+            evdev_axis_t mt_y;
+
+            // pending state, it becomes visible at the next SYN_REPORT
+            int32_t x;
+            int32_t y;
+            uint8_t state;
+            bool dropped;
+
+            evdev_contact_t contacts[EVDEV_MT_SLOTS];
+            int32_t mt_slot;
+            bool has_mt;
+
+            int32_t enc_diff;
+            bool shift;
+            bool caps_lock;
+
+            evdev_point_t points[EVDEV_POINTER_QUEUE];
+            uint8_t point_head;
+            uint8_t point_count;
+            evdev_point_t last_point;
+
+            evdev_key_t keys[EVDEV_KEY_QUEUE];
+            uint8_t key_head;
+            uint8_t key_count;
+            evdev_key_t last_key;
+        } mp_evdev_device_obj_t;
+    #endif
+
+    extern const mp_obj_type_t mp_evdev_device_type;
+
+#endif /* __EVDEV_H__ */
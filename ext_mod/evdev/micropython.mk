@@ -0,0 +1,11 @@
+# Copyright (c) 2024 - 2025 Kevin G. Schlosser
+
+################################################################################
+# evdev build rules
+#
+# Linux input devices for the unix port. The source compiles to nothing on
+# anything that is not Linux.
+
+MOD_DIR := $(USERMOD_DIR)
+
+SRC_USERMOD_C += $(MOD_DIR)/src/evdev.c
@@ -0,0 +1,548 @@
+// Copyright (c) 2024 - 2025 Kevin G. Schlosser
+
+#include "../include/evdev.h"
+
+#include "py/obj.h"
+#include "py/runtime.h"
+#include "py/mperrno.h"
+
+#if defined(__linux__)
+    #include "lvgl/lvgl.h"
+
+    #include <errno.h>
+    #include <fcntl.h>
+    #include <string.h>
+    #include <unistd.h>
+    #include <sys/ioctl.h>
+
+    #define EVDEV_TEST_BIT(bits, bit)  ((bits[(bit) / 8] >> ((bit) % 8)) & 1)
+
+    // US layout for the key codes that produce a character, indexed by the
+    // linux key code. 0 means the key code has to be handled some other way
+    static const char evdev_keymap[] =
+        "\0\0" "1234567890-=" "\0\0" "qwertyuiop[]" "\0\0" "asdfghjkl;'`"
+        "\0" "\\zxcvbnm,./" "\0" "*" "\0" " ";
+
+    static const char evdev_keymap_shift[] =
+        "\0\0" "!@#$%^&*()_+" "\0\0" "QWERTYUIOP{}" "\0\0" "ASDFGHJKL:\"~"
+        "\0" "|ZXCVBNM<>?" "\0" "*" "\0" " ";
+
+
+    static void evdev_get_axis(int fd, uint16_t code, evdev_axis_t *axis, uint16_t res)
+    {
+        struct input_absinfo info;
+
+        if (ioctl(fd, EVIOCGABS(code), &info) == 0 && info.maximum > info.minimum) {
+            axis->min = info.minimum;
+            axis->max = info.maximum;
+        } else {
+            axis->min = 0;
+            axis->max = (int32_t)res - 1;
+        }
+    }
+
+
+    static int32_t evdev_scale(int32_t value, evdev_axis_t *axis, uint16_t res)
+    {
+        if (value <= axis->min) return 0;
+        if (value >= axis->max) return (int32_t)res - 1;
+        return (int32_t)((int64_t)(value - axis->min) * (res - 1) / (axis->max - axis->min));
+    }
+
+
+    static uint32_t evdev_map_key(mp_evdev_device_obj_t *self, uint16_t code)
+    {
+        switch (code) {
+            case KEY_ESC:       return LV_KEY_ESC;
+            case KEY_BACKSPACE: return LV_KEY_BACKSPACE;
+            case KEY_TAB:       return LV_KEY_NEXT;
+            case KEY_ENTER:
+            case KEY_KPENTER:   return LV_KEY_ENTER;
+            case KEY_UP:        return LV_KEY_UP;
+            case KEY_DOWN:      return LV_KEY_DOWN;
+            case KEY_LEFT:      return LV_KEY_LEFT;
+            case KEY_RIGHT:     return LV_KEY_RIGHT;
+            case KEY_HOME:      return LV_KEY_HOME;
+            case KEY_END:       return LV_KEY_END;
+            case KEY_DELETE:    return LV_KEY_DEL;
+            case KEY_PAGEUP:    return LV_KEY_NEXT;
+            case KEY_PAGEDOWN:  return LV_KEY_PREV;
+            default:
+                break;
+        }
+
+        if (code >= sizeof(evdev_keymap) - 1) return 0;
+
+        char c = evdev_keymap[code];
+        bool shift = self->shift;
+
+        // caps lock only changes the letters
+        if (self->caps_lock && c >= 'a' && c <= 'z') shift = !shift;
+
+        if (shift) c = evdev_keymap_shift[code];
+        return (uint32_t)(uint8_t)c;
+    }
+
+
+    static void evdev_queue_key(mp_evdev_device_obj_t *self, uint32_t key, uint8_t state)
+    {
+        // drop the oldest key if nothing has been read for a while
+        if (self->key_count == EVDEV_KEY_QUEUE) {
+            self->key_head = (self->key_head + 1) % EVDEV_KEY_QUEUE;
+            self->key_count--;
+        }
+
+        evdev_key_t *tail = &self->keys[(self->key_head + self->key_count) % EVDEV_KEY_QUEUE];
+        tail->key = key;
+        tail->state = state;
+        self->key_count++;
+    }
+
+
+    static void evdev_queue_point(mp_evdev_device_obj_t *self, int32_t x, int32_t y, uint8_t state)
+    {
+        evdev_point_t *tail;
+
+        if (self->point_count) {
+            tail = &self->points[(self->point_head + self->point_count - 1) % EVDEV_POINTER_QUEUE];
+
+            // while the state stays the same only the last position matters
+            if (tail->state == state && (tail->motion || self->point_count == EVDEV_POINTER_QUEUE)) {
+                tail->x = x;
+                tail->y = y;
+                return;
+            }
+
+            if (self->point_count == EVDEV_POINTER_QUEUE) {
+                self->point_head = (self->point_head + 1) % EVDEV_POINTER_QUEUE;
+                self->point_count--;
+            }
+        } else if (self->last_point.state == state && self->last_point.x == x && self->last_point.y == y) {
+            return;
+        }
+
+        tail = &self->points[(self->point_head + self->point_count) % EVDEV_POINTER_QUEUE];
+        tail->x = x;
+        tail->y = y;
+        tail->state = state;
+        tail->motion = self->point_count ?
+            self->points[(self->point_head + self->point_count - 1) % EVDEV_POINTER_QUEUE].state == state :
+            self->last_point.state == state;
+        self->point_count++;
+    }
+
+
+    static void evdev_commit(mp_evdev_device_obj_t *self)
+    {
+        if (self->has_mt) {
+            // the lowest slot that has a contact is the one that gets reported
+            self->state = 0;
+            for (uint8_t i = 0; i < EVDEV_MT_SLOTS; i++) {
+                if (self->contacts[i].tracking_id >= 0) {
+                    self->x = self->contacts[i].x;
+                    self->y = self->contacts[i].y;
+                    self->state = 1;
+                    break;
+                }
+            }
+        }
+
+        int32_t x = self->x;
+        int32_t y = self->y;
+
+        if (self->swap_xy) {
+            x = self->y;
+            y = self->x;
+        }
+
+        if (self->mirror_x) x = (int32_t)self->hor_res - x - 1;
+        if (self->mirror_y) y = (int32_t)self->ver_res - y - 1;
+
+        evdev_queue_point(self, x, y, self->state);
+    }
+
+
+    static void evdev_process(mp_evdev_device_obj_t *self, struct input_event *event)
+    {
+        // the axis that events report in before swap_xy gets applied
+        uint16_t x_res = self->swap_xy ? self->ver_res : self->hor_res;
+        uint16_t y_res = self->swap_xy ? self->hor_res : self->ver_res;
+        evdev_contact_t *contact;
+
+        if (event->type == EV_SYN) {
+            if (event->code == SYN_DROPPED) {
+                self->dropped = true;
+            } else if (event->code == SYN_REPORT) {
+                // everything up to and including the report that follows a
+                // dropped event is incomplete and gets thrown away
+                if (self->dropped) self->dropped = false;
+                else evdev_commit(self);
+            }
+            return;
+        }
+
+        if (self->dropped) return;
+
+        switch (event->type) {
+            case EV_ABS:
+                switch (event->code) {
+                    case ABS_X:
+                        if (self->has_mt) break;
+                        self->x = evdev_scale(event->value, &self->abs_x, x_res);
+                        break;
+                    case ABS_Y:
+                        if (self->has_mt) break;
+                        self->y = evdev_scale(event->value, &self->abs_y, y_res);
+                        break;
+                    case ABS_MT_SLOT:
+                        self->mt_slot = event->value;
+                        break;
+                    case ABS_MT_TRACKING_ID:
+                    case ABS_MT_POSITION_X:
+                    case ABS_MT_POSITION_Y:
+                        if (self->mt_slot < 0 || self->mt_slot >= EVDEV_MT_SLOTS) break;
+                        contact = &self->contacts[self->mt_slot];
+
+                        if (event->code == ABS_MT_TRACKING_ID) {
+                            contact->tracking_id = event->value;
+                        } else if (event->code == ABS_MT_POSITION_X) {
+                            contact->x = evdev_scale(event->value, &self->mt_x, x_res);
+                        } else {
+                            contact->y = evdev_scale(event->value, &self->mt_y, y_res);
+                        }
+                        break;
+                    default:
+                        break;
+                }
+                break;
+
+            case EV_REL:
+                if (event->code == REL_X) {
+                    self->x = LV_CLAMP(0, self->x + event->value, (int32_t)x_res - 1);
+                } else if (event->code == REL_Y) {
+                    self->y = LV_CLAMP(0, self->y + event->value, (int32_t)y_res - 1);
+                }
+                break;
+
+            case EV_KEY:
+                switch (event->code) {
+                    case BTN_LEFT:
+                    case BTN_TOUCH:
+                        self->state = event->value ? 1 : 0;
+                        break;
+                    case KEY_LEFTSHIFT:
+                    case KEY_RIGHTSHIFT:
+                        self->shift = event->value ? true : false;
+                        break;
+                    case KEY_CAPSLOCK:
+                        if (event->value == 1) self->caps_lock = !self->caps_lock;
+                        break;
+                    default:
+                        // auto repeat (2) is done by LVGL
+                        if (event->code < BTN_MISC && event->value != 2) {
+                            uint32_t key = evdev_map_key(self, event->code);
+                            if (key) evdev_queue_key(self, key, event->value ? 1 : 0);
+                        }
+                        break;
+                }
+                break;
+
+            default:
+                break;
+        }
+    }
+
+
+    static void evdev_drain(mp_evdev_device_obj_t *self)
+    {
+        if (self->fd < 0) return;
+
+        ssize_t size;
+
+        do {
+            size = read(self->fd, self->events, sizeof(self->events));
+            if (size <= 0) break;
+
+            size_t count = (size_t)size / sizeof(struct input_event);
+
+            for (size_t i = 0; i < count; i++) {
+                evdev_process(self, &self->events[i]);
+            }
+        } while ((size_t)size == sizeof(self->events));
+    }
+
+
+    static lv_indev_data_t *evdev_get_indev_data(mp_obj_t data_in)
+    {
+        mp_buffer_info_t bufinfo;
+        mp_get_buffer_raise(data_in, &bufinfo, MP_BUFFER_READ);
+
+        // LVGL structures hand out the pointer to the C structure they wrap
+        // as their buffer
+        if (bufinfo.len != sizeof(void *)) {
+            mp_raise_TypeError(MP_ERROR_TEXT("expected lv.indev_data_t"));
+        }
+
+        return *(lv_indev_data_t **)bufinfo.buf;
+    }
+
+
+    static mp_evdev_device_obj_t *evdev_get_self(mp_obj_t self_in)
+    {
+        mp_evdev_device_obj_t *self = MP_OBJ_TO_PTR(self_in);
+        if (self->fd < 0) {
+            mp_raise_msg(&mp_type_RuntimeError, MP_ERROR_TEXT("device is closed"));
+        }
+        return self;
+    }
+
+
+    static mp_obj_t mp_evdev_device_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *all_args)
+    {
+        enum { ARG_path, ARG_hor_res, ARG_ver_res, ARG_swap_xy, ARG_mirror_x, ARG_mirror_y, ARG_grab };
+        const mp_arg_t make_new_args[] = {
+            { MP_QSTR_path,     MP_ARG_OBJ  | MP_ARG_REQUIRED },
+            { MP_QSTR_hor_res,  MP_ARG_INT  | MP_ARG_KW_ONLY | MP_ARG_REQUIRED },
+            { MP_QSTR_ver_res,  MP_ARG_INT  | MP_ARG_KW_ONLY | MP_ARG_REQUIRED },
+            { MP_QSTR_swap_xy,  MP_ARG_BOOL | MP_ARG_KW_ONLY, { .u_bool = false } },
+            { MP_QSTR_mirror_x, MP_ARG_BOOL | MP_ARG_KW_ONLY, { .u_bool = false } },
+            { MP_QSTR_mirror_y, MP_ARG_BOOL | MP_ARG_KW_ONLY, { .u_bool = false } },
+            { MP_QSTR_grab,     MP_ARG_BOOL | MP_ARG_KW_ONLY, { .u_bool = false } },
+        };
+
+        mp_arg_val_t args[MP_ARRAY_SIZE(make_new_args)];
+        mp_arg_parse_all_kw_array(
+            n_args,
+            n_kw,
+            all_args,
+            MP_ARRAY_SIZE(make_new_args),
+            make_new_args,
+            args
+        );
+
+        if (args[ARG_hor_res].u_int <= 0 || args[ARG_ver_res].u_int <= 0) {
+            mp_raise_ValueError(MP_ERROR_TEXT("invalid resolution"));
+        }
+
+        const char *path = mp_obj_str_get_str(args[ARG_path].u_obj);
+
+        int fd = open(path, O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+        if (fd < 0) mp_raise_OSError(errno);
+
+        if (args[ARG_grab].u_bool && ioctl(fd, EVIOCGRAB, 1) < 0) {
+            int err = errno;
+            close(fd);
+            mp_raise_OSError(err);
+        }
+
+        mp_evdev_device_obj_t *self = m_new_obj_with_finaliser(mp_evdev_device_obj_t);
+        memset(self, 0x00, sizeof(mp_evdev_device_obj_t));
+
+        self->base.type = &mp_evdev_device_type;
+        self->fd = fd;
+        self->grab = args[ARG_grab].u_bool;
+        self->hor_res = (uint16_t)args[ARG_hor_res].u_int;
+        self->ver_res = (uint16_t)args[ARG_ver_res].u_int;
+        self->swap_xy = args[ARG_swap_xy].u_bool;
+        self->mirror_x = args[ARG_mirror_x].u_bool;
+        self->mirror_y = args[ARG_mirror_y].u_bool;
+
+        uint16_t x_res = self->swap_xy ? self->ver_res : self->hor_res;
+        uint16_t y_res = self->swap_xy ? self->hor_res : self->ver_res;
+
+        evdev_get_axis(fd, ABS_X, &self->abs_x, x_res);
+        evdev_get_axis(fd, ABS_Y, &self->abs_y, y_res);
+        evdev_get_axis(fd, ABS_MT_POSITION_X, &self->mt_x, x_res);
+        evdev_get_axis(fd, ABS_MT_POSITION_Y, &self->mt_y, y_res);
+
+        uint8_t abs_bits[ABS_MAX / 8 + 1] = { 0 };
+        if (ioctl(fd, EVIOCGBIT(EV_ABS, sizeof(abs_bits)), abs_bits) >= 0) {
+            self->has_mt = EVDEV_TEST_BIT(abs_bits, ABS_MT_POSITION_X) ? true : false;
+        }
+
+        for (uint8_t i = 0; i < EVDEV_MT_SLOTS; i++) {
+            self->contacts[i].tracking_id = -1;
+        }
+
+        // a relative device starts in the middle of the screen
+        self->x = x_res / 2;
+        self->y = y_res / 2;
+
+        return MP_OBJ_FROM_PTR(self);
+    }
+
+
+    /*
+    Reads everything the device has and fills the lv.indev_data_t that LVGL
+    passed to the read callback with the oldest queued pointer state.
+    */
+    static mp_obj_t mp_evdev_device_read_pointer(mp_obj_t self_in, mp_obj_t data_in)
+    {
+        mp_evdev_device_obj_t *self = evdev_get_self(self_in);
+        lv_indev_data_t *data = evdev_get_indev_data(data_in);
+
+        evdev_drain(self);
+
+        if (self->point_count) {
+            self->last_point = self->points[self->point_head];
+            self->point_head = (self->point_head + 1) % EVDEV_POINTER_QUEUE;
+            self->point_count--;
+        }
+
+        data->point.x = self->last_point.x;
+        data->point.y = self->last_point.y;
+        data->state = self->last_point.state ? LV_INDEV_STATE_PRESSED : LV_INDEV_STATE_RELEASED;
+        data->continue_reading = self->point_count > 0;
+
+        return mp_const_none;
+    }
+
+    static MP_DEFINE_CONST_FUN_OBJ_2(mp_evdev_device_read_pointer_obj, mp_evdev_device_read_pointer);
+
+
+    /*
+    Same as read_pointer but for the queued keys.
+    */
+    static mp_obj_t mp_evdev_device_read_key(mp_obj_t self_in, mp_obj_t data_in)
+    {
+        mp_evdev_device_obj_t *self = evdev_get_self(self_in);
+        lv_indev_data_t *data = evdev_get_indev_data(data_in);
+
+        evdev_drain(self);
+
+        if (self->key_count) {
+            self->last_key = self->keys[self->key_head];
+            self->key_head = (self->key_head + 1) % EVDEV_KEY_QUEUE;
+            self->key_count--;
+        }
+
+        data->key = self->last_key.key;
+        data->state = self->last_key.state ? LV_INDEV_STATE_PRESSED : LV_INDEV_STATE_RELEASED;
+        data->continue_reading = self->key_count > 0;
+
+        return mp_const_none;
+    }
+
+    static MP_DEFINE_CONST_FUN_OBJ_2(mp_evdev_device_read_key_obj, mp_evdev_device_read_key);
+
+
+    static mp_obj_t mp_evdev_device_get_name(mp_obj_t self_in)
+    {
+        mp_evdev_device_obj_t *self = evdev_get_self(self_in);
+        char name[256] = { 0 };
+
+        if (ioctl(self->fd, EVIOCGNAME(sizeof(name) - 1), name) < 0) {
+            mp_raise_OSError(errno);
+        }
+
+        return mp_obj_new_str(name, strlen(name));
+    }
+
+    static MP_DEFINE_CONST_FUN_OBJ_1(mp_evdev_device_get_name_obj, mp_evdev_device_get_name);
+
+
+    static mp_obj_t mp_evdev_device_has_multitouch(mp_obj_t self_in)
+    {
+        mp_evdev_device_obj_t *self = MP_OBJ_TO_PTR(self_in);
+        return mp_obj_new_bool(self->has_mt);
+    }
+
+    static MP_DEFINE_CONST_FUN_OBJ_1(mp_evdev_device_has_multitouch_obj, mp_evdev_device_has_multitouch);
+
+
+    static mp_obj_t mp_evdev_device_set_resolution(mp_obj_t self_in, mp_obj_t hor_res_in, mp_obj_t ver_res_in)
+    {
+        mp_evdev_device_obj_t *self = MP_OBJ_TO_PTR(self_in);
+        mp_int_t hor_res = mp_obj_get_int(hor_res_in);
+        mp_int_t ver_res = mp_obj_get_int(ver_res_in);
+
+        if (hor_res <= 0 || ver_res <= 0) {
+            mp_raise_ValueError(MP_ERROR_TEXT("invalid resolution"));
+        }
+
+        self->hor_res = (uint16_t)hor_res;
+        self->ver_res = (uint16_t)ver_res;
+
+        // the axis ranges that were not read from the device follow the
+        // resolution
+        uint16_t x_res = self->swap_xy ? self->ver_res : self->hor_res;
+        uint16_t y_res = self->swap_xy ? self->hor_res : self->ver_res;
+
+        if (self->fd >= 0) {
+            evdev_get_axis(self->fd, ABS_X, &self->abs_x, x_res);
+            evdev_get_axis(self->fd, ABS_Y, &self->abs_y, y_res);
+            evdev_get_axis(self->fd, ABS_MT_POSITION_X, &self->mt_x, x_res);
+            evdev_get_axis(self->fd, ABS_MT_POSITION_Y, &self->mt_y, y_res);
+        }
+
+        self->x = LV_MIN(self->x, (int32_t)x_res - 1);
+        self->y = LV_MIN(self->y, (int32_t)y_res - 1);
+
+        return mp_const_none;
+    }
+
+    static MP_DEFINE_CONST_FUN_OBJ_3(mp_evdev_device_set_resolution_obj, mp_evdev_device_set_resolution);
+
+
+    static mp_obj_t mp_evdev_device_fileno(mp_obj_t self_in)
+    {
+        mp_evdev_device_obj_t *self = evdev_get_self(self_in);
+        return mp_obj_new_int(self->fd);
+    }
+
+    static MP_DEFINE_CONST_FUN_OBJ_1(mp_evdev_device_fileno_obj, mp_evdev_device_fileno);
+
+
+    static mp_obj_t mp_evdev_device_close(mp_obj_t self_in)
+    {
+        mp_evdev_device_obj_t *self = MP_OBJ_TO_PTR(self_in);
+
+        if (self->fd >= 0) {
+            if (self->grab) ioctl(self->fd, EVIOCGRAB, 0);
+            close(self->fd);
+            self->fd = -1;
+        }
+
+        return mp_const_none;
+    }
+
+    static MP_DEFINE_CONST_FUN_OBJ_1(mp_evdev_device_close_obj, mp_evdev_device_close);
+
+
+    static const mp_rom_map_elem_t mp_evdev_device_locals_dict_table[] = {
+        { MP_ROM_QSTR(MP_QSTR_read_pointer),   MP_ROM_PTR(&mp_evdev_device_read_pointer_obj)   },
+        { MP_ROM_QSTR(MP_QSTR_read_key),       MP_ROM_PTR(&mp_evdev_device_read_key_obj)       },
+        { MP_ROM_QSTR(MP_QSTR_get_name),       MP_ROM_PTR(&mp_evdev_device_get_name_obj)       },
+        { MP_ROM_QSTR(MP_QSTR_has_multitouch), MP_ROM_PTR(&mp_evdev_device_has_multitouch_obj) },
+        { MP_ROM_QSTR(MP_QSTR_set_resolution), MP_ROM_PTR(&mp_evdev_device_set_resolution_obj) },
+        { MP_ROM_QSTR(MP_QSTR_fileno),         MP_ROM_PTR(&mp_evdev_device_fileno_obj)         },
+        { MP_ROM_QSTR(MP_QSTR_close),          MP_ROM_PTR(&mp_evdev_device_close_obj)          },
+        { MP_ROM_QSTR(MP_QSTR___del__),        MP_ROM_PTR(&mp_evdev_device_close_obj)          },
+    };
+
+    static MP_DEFINE_CONST_DICT(mp_evdev_device_locals_dict, mp_evdev_device_locals_dict_table);
+
+    MP_DEFINE_CONST_OBJ_TYPE(
+        mp_evdev_device_type,
+        MP_QSTR_Device,
+        MP_TYPE_FLAG_NONE,
+        make_new, mp_evdev_device_make_new,
+        locals_dict, (mp_obj_dict_t *)&mp_evdev_device_locals_dict
+    );
+
+
+    static const mp_rom_map_elem_t mp_module_evdev_globals_table[] = {
+        { MP_ROM_QSTR(MP_QSTR___name__), MP_OBJ_NEW_QSTR(MP_QSTR__evdev)     },
+        { MP_ROM_QSTR(MP_QSTR_Device),   MP_ROM_PTR(&mp_evdev_device_type) },
+    };
+
+    static MP_DEFINE_CONST_DICT(mp_module_evdev_globals, mp_module_evdev_globals_table);
+
+
+    const mp_obj_module_t mp_module_evdev = {
+        .base    = {&mp_type_module},
+        .globals = (mp_obj_dict_t *)&mp_module_evdev_globals,
+    };
+
+    MP_REGISTER_MODULE(MP_QSTR__evdev, mp_module_evdev);
+#endif /* defined(__linux__) */
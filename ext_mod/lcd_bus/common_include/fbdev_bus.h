@@ -0,0 +1,61 @@
+// Copyright (c) 2024 - 2025 Kevin G. Schlosser
+
+#ifndef _FBDEV_BUS_H_
+    #define _FBDEV_BUS_H_
+
+    //local_includes
+    #include "modlcd_bus.h"
+
+    // micropython includes
+    #include "py/obj.h"
+    #include "py/objarray.h"
+
+    /*
+    Linux frame buffer device (/dev/fbN). The device memory gets mapped and
+    handed to LVGL by allocate_framebuffer so the display is able to be used
+    in direct render mode with LVGL drawing right into the device memory.
+    If the device has room for 2 screens and page_flip is set the second
+    screen is the second frame buffer and the display gets panned to
+    whichever one was just finished.
+
+    Any file that can be mapped is able to be used as the device, it gets
+    sized to the display if it is smaller. That is so the bus is able to be
+    tested without a frame buffer device.
+    */
+    typedef struct _mp_lcd_fbdev_bus_obj_t {
+        mp_obj_base_t base;
+
+        mp_obj_t callback;
+
+        void *buf1;
+        void *buf2;
+        uint32_t buffer_flags;
+
+        bool trans_done;
+        bool rgb565_byte_swap;
+
+        lcd_panel_io_t panel_io_handle;
+
+        mp_obj_t device;
+        int fd;
+        bool is_fbdev;
+        bool vsync;
+        bool page_flip;
+
+        uint8_t *map;
+        size_t map_size;
+
+        uint16_t width;
+        uint16_t height;
+        uint8_t bytes_per_pixel;
+
+        // size of one screen, the mapping holds page_count of them
+        uint32_t page_size;
+        uint8_t page_count;
+        uint8_t pages_allocated;
+        uint8_t front_page;
+    } mp_lcd_fbdev_bus_obj_t;
+
+    extern const mp_obj_type_t mp_lcd_fbdev_bus_type;
+
+#endif /* _FBDEV_BUS_H_ */
@@ -0,0 +1,50 @@
+// Copyright (c) 2024 - 2025 Kevin G. Schlosser
+
+#ifndef _MEMORY_BUS_H_
+    #define _MEMORY_BUS_H_
+
+    //local_includes
+    #include "modlcd_bus.h"
+
+    // micropython includes
+    #include "py/obj.h"
+    #include "py/objarray.h"
+
+    /*
+    Display bus that has no display attached to it. tx_color copies the area
+    into a frame buffer that is the size of the display and the transfer is
+    finished as soon as the copy is done, or after delay_us if one has been
+    set. It is for running rendering tests and benchmarks on machines that
+    don't have a display or a window system.
+    */
+    typedef struct _mp_lcd_memory_bus_obj_t {
+        mp_obj_base_t base;
+
+        mp_obj_t callback;
+
+        void *buf1;
+        void *buf2;
+        uint32_t buffer_flags;
+
+        bool trans_done;
+        bool rgb565_byte_swap;
+
+        lcd_panel_io_t panel_io_handle;
+
+        uint8_t *framebuffer;
+        uint32_t framebuffer_size;
+        uint16_t width;
+        uint16_t height;
+        uint8_t bytes_per_pixel;
+
+        uint32_t delay_us;
+        bool crc_enabled;
+
+        // crc of the last completed frame and how many frames have completed
+        uint32_t crc;
+        uint32_t frame_count;
+    } mp_lcd_memory_bus_obj_t;
+
+    extern const mp_obj_type_t mp_lcd_memory_bus_type;
+
+#endif /* _MEMORY_BUS_H_ */
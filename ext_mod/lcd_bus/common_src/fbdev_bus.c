@@ -0,0 +1,401 @@
+// Copyright (c) 2024 - 2025 Kevin G. Schlosser
+
+/* includes */
+// local includes
+#include "lcd_types.h"
+#include "modlcd_bus.h"
+#include "../common_include/fbdev_bus.h"
+
+// micropython includes
+#include "py/obj.h"
+#include "py/runtime.h"
+#include "py/objarray.h"
+
+// stdlib includes
+#include <string.h>
+/* end includes */
+
+
+#if defined(MP_PORT_UNIX) && defined(__linux__)
+    #include <errno.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <sys/ioctl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <linux/fb.h>
+
+
+    /* forward declarations */
+    mp_lcd_err_t fbdev_rx_param(mp_obj_t obj, int lcd_cmd, void *param, size_t param_size);
+    mp_lcd_err_t fbdev_tx_param(mp_obj_t obj, int lcd_cmd, void *param, size_t param_size);
+    mp_lcd_err_t fbdev_tx_color(mp_obj_t obj, int lcd_cmd, void *color, size_t color_size, int x_start, int y_start, int x_end, int y_end, uint8_t rotation, bool last_update);
+    mp_lcd_err_t fbdev_del(mp_obj_t obj);
+    mp_lcd_err_t fbdev_init(mp_obj_t obj, uint16_t width, uint16_t height, uint8_t bpp, uint32_t buffer_size, bool rgb565_byte_swap, uint8_t cmd_bits, uint8_t param_bits);
+    mp_lcd_err_t fbdev_get_lane_count(mp_obj_t obj, uint8_t *lane_count);
+    mp_obj_t fbdev_allocate_framebuffer(mp_obj_t obj, uint32_t size, uint32_t caps);
+    mp_obj_t fbdev_free_framebuffer(mp_obj_t obj, mp_obj_t buf);
+    /* end forward declarations */
+
+
+    /* function definitions */
+    static mp_obj_t mp_lcd_fbdev_bus_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *all_args)
+    {
+        enum { ARG_device, ARG_vsync, ARG_page_flip };
+        const mp_arg_t make_new_args[] = {
+            { MP_QSTR_device,    MP_ARG_OBJ  | MP_ARG_KW_ONLY, { .u_obj = mp_const_none } },
+            { MP_QSTR_vsync,     MP_ARG_BOOL | MP_ARG_KW_ONLY, { .u_bool = false } },
+            { MP_QSTR_page_flip, MP_ARG_BOOL | MP_ARG_KW_ONLY, { .u_bool = false } },
+        };
+
+        mp_arg_val_t args[MP_ARRAY_SIZE(make_new_args)];
+        mp_arg_parse_all_kw_array(
+            n_args,
+            n_kw,
+            all_args,
+            MP_ARRAY_SIZE(make_new_args),
+            make_new_args,
+            args
+        );
+
+        // makes sure it is a string before it is needed
+        if (args[ARG_device].u_obj != mp_const_none) mp_obj_str_get_str(args[ARG_device].u_obj);
+
+        // create new object
+        mp_lcd_fbdev_bus_obj_t *self = m_new_obj(mp_lcd_fbdev_bus_obj_t);
+        self->base.type = &mp_lcd_fbdev_bus_type;
+
+        self->callback = mp_const_none;
+
+        self->device = args[ARG_device].u_obj;
+        self->fd = -1;
+        self->vsync = args[ARG_vsync].u_bool;
+        self->page_flip = args[ARG_page_flip].u_bool;
+
+        self->panel_io_handle.get_lane_count = fbdev_get_lane_count;
+        self->panel_io_handle.init = fbdev_init;
+        self->panel_io_handle.rx_param = fbdev_rx_param;
+        self->panel_io_handle.tx_param = fbdev_tx_param;
+        self->panel_io_handle.tx_color = fbdev_tx_color;
+        self->panel_io_handle.allocate_framebuffer = fbdev_allocate_framebuffer;
+        self->panel_io_handle.free_framebuffer = fbdev_free_framebuffer;
+        self->panel_io_handle.del = fbdev_del;
+
+        return MP_OBJ_FROM_PTR(self);
+    }
+
+
+    mp_lcd_err_t fbdev_rx_param(mp_obj_t obj, int lcd_cmd, void *param, size_t param_size)
+    {
+        LCD_UNUSED(obj);
+        LCD_UNUSED(lcd_cmd);
+        LCD_UNUSED(param);
+        LCD_UNUSED(param_size);
+        return LCD_OK;
+    }
+
+
+    mp_lcd_err_t fbdev_tx_param(mp_obj_t obj, int lcd_cmd, void *param, size_t param_size)
+    {
+        LCD_UNUSED(obj);
+        LCD_UNUSED(lcd_cmd);
+        LCD_UNUSED(param);
+        LCD_UNUSED(param_size);
+        return LCD_OK;
+    }
+
+
+    // shows page once the vertical blanking period starts if vsync is set
+    static void fbdev_show_page(mp_lcd_fbdev_bus_obj_t *self, uint8_t page)
+    {
+        if (self->is_fbdev) {
+            if (self->vsync) {
+                uint32_t crtc = 0;
+                ioctl(self->fd, FBIO_WAITFORVSYNC, &crtc);
+            }
+
+            if (self->page_count > 1 && page != self->front_page) {
+                struct fb_var_screeninfo var;
+
+                if (ioctl(self->fd, FBIOGET_VSCREENINFO, &var) == 0) {
+                    var.xoffset = 0;
+                    var.yoffset = (uint32_t)page * self->height;
+                    ioctl(self->fd, FBIOPAN_DISPLAY, &var);
+                }
+            }
+        }
+
+        self->front_page = page;
+    }
+
+
+    /*
+    In direct render mode color points into the mapped device memory so the
+    only thing that needs to be done is showing the page once the frame is
+    finished. Buffers that are not from allocate_framebuffer get copied into
+    the page that is being shown.
+    */
+    mp_lcd_err_t fbdev_tx_color(mp_obj_t obj, int lcd_cmd, void *color, size_t color_size, int x_start, int y_start, int x_end, int y_end, uint8_t rotation, bool last_update)
+    {
+        LCD_UNUSED(lcd_cmd);
+        LCD_UNUSED(rotation);
+
+        mp_lcd_fbdev_bus_obj_t *self = MP_OBJ_TO_PTR(obj);
+
+        if (self->map == NULL) return LCD_ERR_INVALID_STATE;
+
+        uint8_t *buf = (uint8_t *)color;
+        uint8_t page = self->front_page;
+
+        if (buf >= self->map && buf < self->map + self->map_size) {
+            page = (uint8_t)((size_t)(buf - self->map) / self->page_size);
+        } else {
+            mp_lcd_err_t ret = lcd_panel_io_copy_area(
+                self->map + (size_t)page * self->page_size, self->width, self->height, self->bytes_per_pixel,
+                color, color_size, x_start, y_start, x_end, y_end
+            );
+
+            if (ret != LCD_OK) return ret;
+        }
+
+        if (last_update) fbdev_show_page(self, page);
+
+        bus_trans_done_cb(&self->panel_io_handle, NULL, self);
+
+        return LCD_OK;
+    }
+
+
+    mp_lcd_err_t fbdev_del(mp_obj_t obj)
+    {
+        mp_lcd_fbdev_bus_obj_t *self = MP_OBJ_TO_PTR(obj);
+
+        if (self->map != NULL) {
+            // leave the console on the first page
+            if (self->front_page != 0) {
+                bool vsync = self->vsync;
+
+                self->vsync = false;
+                fbdev_show_page(self, 0);
+                self->vsync = vsync;
+            }
+
+            munmap(self->map, self->map_size);
+            self->map = NULL;
+            self->map_size = 0;
+        }
+
+        if (self->fd >= 0) {
+            close(self->fd);
+            self->fd = -1;
+        }
+
+        self->page_count = 0;
+        self->pages_allocated = 0;
+
+        return LCD_OK;
+    }
+
+
+    static void fbdev_init_failed(mp_lcd_fbdev_bus_obj_t *self, int err)
+    {
+        fbdev_del(MP_OBJ_FROM_PTR(self));
+        mp_raise_OSError(err);
+    }
+
+
+    mp_lcd_err_t fbdev_init(mp_obj_t obj, uint16_t width, uint16_t height, uint8_t bpp, uint32_t buffer_size, bool rgb565_byte_swap, uint8_t cmd_bits, uint8_t param_bits)
+    {
+        LCD_UNUSED(buffer_size);
+        LCD_UNUSED(cmd_bits);
+        LCD_UNUSED(param_bits);
+
+        mp_lcd_fbdev_bus_obj_t *self = MP_OBJ_TO_PTR(obj);
+
+        if (bpp == 0 || bpp % 8) return LCD_ERR_NOT_SUPPORTED;
+
+        if (self->fd >= 0) fbdev_del(obj);
+
+        self->width = width;
+        self->height = height;
+        self->bytes_per_pixel = bpp / 8;
+        self->rgb565_byte_swap = rgb565_byte_swap;
+        self->page_size = (uint32_t)width * (uint32_t)height * self->bytes_per_pixel;
+        self->page_count = 1;
+        self->front_page = 0;
+
+        const char *device = self->device == mp_const_none ? "/dev/fb0" : mp_obj_str_get_str(self->device);
+
+        self->fd = open(device, O_RDWR | O_CLOEXEC);
+        if (self->fd < 0) fbdev_init_failed(self, errno);
+
+        struct fb_var_screeninfo var;
+        struct fb_fix_screeninfo fix;
+
+        self->is_fbdev = ioctl(self->fd, FBIOGET_VSCREENINFO, &var) == 0 &&
+                         ioctl(self->fd, FBIOGET_FSCREENINFO, &fix) == 0;
+
+        if (self->is_fbdev) {
+            if (var.xres != width || var.yres != height || var.bits_per_pixel != bpp ||
+                fix.line_length != (uint32_t)width * self->bytes_per_pixel) {
+
+                fbdev_del(obj);
+                mp_raise_msg_varg(
+                    &mp_type_ValueError,
+                    MP_ERROR_TEXT("frame buffer is %dx%d %d bpp with a line length of %d"),
+                    (int)var.xres, (int)var.yres, (int)var.bits_per_pixel, (int)fix.line_length
+                );
+            }
+
+            if (self->page_flip) {
+                // the virtual screen has to be made taller to hold the second page
+                if (var.yres_virtual < var.yres * 2) {
+                    var.yres_virtual = var.yres * 2;
+                    var.yoffset = 0;
+
+                    if (ioctl(self->fd, FBIOPUT_VSCREENINFO, &var) == 0) {
+                        ioctl(self->fd, FBIOGET_VSCREENINFO, &var);
+                        ioctl(self->fd, FBIOGET_FSCREENINFO, &fix);
+                    }
+                }
+
+                if (var.yres_virtual >= var.yres * 2 && fix.smem_len >= self->page_size * 2) {
+                    self->page_count = 2;
+                }
+            }
+
+            if (var.yoffset != 0) {
+                var.xoffset = 0;
+                var.yoffset = 0;
+                ioctl(self->fd, FBIOPAN_DISPLAY, &var);
+            }
+        } else {
+            if (self->page_flip) self->page_count = 2;
+
+            // a regular file gets made large enough to hold the pages
+            struct stat st;
+            off_t size = (off_t)self->page_size * self->page_count;
+
+            if (fstat(self->fd, &st) != 0) fbdev_init_failed(self, errno);
+            if (st.st_size < size && ftruncate(self->fd, size) != 0) fbdev_init_failed(self, errno);
+        }
+
+        self->map_size = (size_t)self->page_size * self->page_count;
+        self->map = mmap(NULL, self->map_size, PROT_READ | PROT_WRITE, MAP_SHARED, self->fd, 0);
+
+        if (self->map == MAP_FAILED) {
+            int err = errno;
+            self->map = NULL;
+            fbdev_init_failed(self, err);
+        }
+
+        self->trans_done = true;
+
+        return LCD_OK;
+    }
+
+
+    mp_lcd_err_t fbdev_get_lane_count(mp_obj_t obj, uint8_t *lane_count)
+    {
+        LCD_UNUSED(obj);
+        *lane_count = 1;
+        return LCD_OK;
+    }
+
+
+    /*
+    Hands out the pages of the mapped device memory. init has to be called
+    before this. The first call returns the page being shown and the second
+    one returns the other page when page flipping is being used.
+    */
+    mp_obj_t fbdev_allocate_framebuffer(mp_obj_t obj, uint32_t size, uint32_t caps)
+    {
+        LCD_UNUSED(caps);
+
+        mp_lcd_fbdev_bus_obj_t *self = MP_OBJ_TO_PTR(obj);
+
+        if (self->map == NULL) {
+            mp_raise_msg(&mp_type_RuntimeError, MP_ERROR_TEXT("init has to be called before allocating the frame buffer"));
+        }
+
+        if (size > self->page_size) {
+            mp_raise_msg_varg(&mp_type_ValueError, MP_ERROR_TEXT("size is larger than the screen (%d)"), (int)self->page_size);
+        }
+
+        if (self->pages_allocated >= self->page_count) {
+            mp_raise_msg(&mp_type_MemoryError, MP_ERROR_TEXT("no more pages available"));
+        }
+
+        uint8_t *buf = self->map + (size_t)self->pages_allocated * self->page_size;
+        self->pages_allocated++;
+
+        mp_obj_array_t *view = MP_OBJ_TO_PTR(mp_obj_new_memoryview(BYTEARRAY_TYPECODE, size, buf));
+        view->typecode |= 0x80; // used to indicate writable buffer
+        return MP_OBJ_FROM_PTR(view);
+    }
+
+
+    // the pages belong to the mapping, they get released by deinit
+    mp_obj_t fbdev_free_framebuffer(mp_obj_t obj, mp_obj_t buf)
+    {
+        LCD_UNUSED(obj);
+        LCD_UNUSED(buf);
+        return mp_const_none;
+    }
+
+
+    static mp_obj_t mp_lcd_fbdev_bus_get_page_count(mp_obj_t self_in)
+    {
+        mp_lcd_fbdev_bus_obj_t *self = MP_OBJ_TO_PTR(self_in);
+        return mp_obj_new_int_from_uint(self->page_count);
+    }
+
+    MP_DEFINE_CONST_FUN_OBJ_1(mp_lcd_fbdev_bus_get_page_count_obj, mp_lcd_fbdev_bus_get_page_count);
+    /* end function definitions */
+
+#else
+    static mp_obj_t mp_lcd_fbdev_bus_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *all_args)
+    {
+        LCD_UNUSED(type);
+        LCD_UNUSED(n_args);
+        LCD_UNUSED(n_kw);
+        LCD_UNUSED(all_args);
+
+        mp_raise_msg(&mp_type_NotImplementedError, MP_ERROR_TEXT("FBDev display bus is only supported on Linux"));
+        return mp_const_none;
+    }
+#endif
+
+
+static const mp_rom_map_elem_t mp_lcd_fbdev_bus_locals_dict_table[] = {
+#if defined(MP_PORT_UNIX) && defined(__linux__)
+    { MP_ROM_QSTR(MP_QSTR_get_page_count),       MP_ROM_PTR(&mp_lcd_fbdev_bus_get_page_count_obj) },
+#endif
+    { MP_ROM_QSTR(MP_QSTR_get_lane_count),       MP_ROM_PTR(&mp_lcd_bus_get_lane_count_obj)       },
+    { MP_ROM_QSTR(MP_QSTR_allocate_framebuffer), MP_ROM_PTR(&mp_lcd_bus_allocate_framebuffer_obj) },
+    { MP_ROM_QSTR(MP_QSTR_free_framebuffer),     MP_ROM_PTR(&mp_lcd_bus_free_framebuffer_obj)     },
+    { MP_ROM_QSTR(MP_QSTR_set_rgb565_conversion), MP_ROM_PTR(&mp_lcd_bus_set_rgb565_conversion_obj) },
+    { MP_ROM_QSTR(MP_QSTR_set_wire_format),       MP_ROM_PTR(&mp_lcd_bus_set_wire_format_obj)       },
+    { MP_ROM_QSTR(MP_QSTR_stats),                MP_ROM_PTR(&mp_lcd_bus_stats_obj)                },
+    { MP_ROM_QSTR(MP_QSTR_reset_stats),          MP_ROM_PTR(&mp_lcd_bus_reset_stats_obj)          },
+    { MP_ROM_QSTR(MP_QSTR_register_callback),    MP_ROM_PTR(&mp_lcd_bus_register_callback_obj)    },
+    { MP_ROM_QSTR(MP_QSTR_tx_param),             MP_ROM_PTR(&mp_lcd_bus_tx_param_obj)             },
+    { MP_ROM_QSTR(MP_QSTR_tx_color),             MP_ROM_PTR(&mp_lcd_bus_tx_color_obj)             },
+    { MP_ROM_QSTR(MP_QSTR_rx_param),             MP_ROM_PTR(&mp_lcd_bus_rx_param_obj)             },
+    { MP_ROM_QSTR(MP_QSTR_init),                 MP_ROM_PTR(&mp_lcd_bus_init_obj)                 },
+    { MP_ROM_QSTR(MP_QSTR_deinit),               MP_ROM_PTR(&mp_lcd_bus_deinit_obj)               },
+    { MP_ROM_QSTR(MP_QSTR___del__),              MP_ROM_PTR(&mp_lcd_bus_deinit_obj)               },
+};
+
+static MP_DEFINE_CONST_DICT(mp_lcd_fbdev_bus_locals_dict, mp_lcd_fbdev_bus_locals_dict_table);
+
+
+/* create micropython class */
+MP_DEFINE_CONST_OBJ_TYPE(
+    mp_lcd_fbdev_bus_type,
+    MP_QSTR_FBDevBus,
+    MP_TYPE_FLAG_NONE,
+    make_new, mp_lcd_fbdev_bus_make_new,
+    locals_dict, (mp_obj_dict_t *)&mp_lcd_fbdev_bus_locals_dict
+);
+/* end create micropython class */
@@ -357,36 +357,41 @@
         mp_lcd_i80_bus_obj_t *self = MP_OBJ_TO_PTR(obj);
 
         CS_LOW();
-        DC_CMD();
 
-        if (self->bus_config.bus_width == 8) {
-            uint8_t *buf = NULL;
-            if (self->panel_io_config.lcd_cmd_bits == 8) {
-                buf[0] = (uint8_t)lcd_cmd;
-                WRITE8();
+        // the 3 byte wire formats send the area in chunks, only the first
+        // chunk has the command
+        if (lcd_cmd >= 0x00) {
+            DC_CMD();
+
+            if (self->bus_config.bus_width == 8) {
+                uint8_t *buf = NULL;
+                if (self->panel_io_config.lcd_cmd_bits == 8) {
+                    buf[0] = (uint8_t)lcd_cmd;
+                    WRITE8();
+                } else {
+                    buf[0] = (uint8_t)((uint16_t)lcd_cmd >> 8);
+                    WRITE8();
+                    WR_LOW();
+                    WR_HIGH();
+                    buf[0] = (uint8_t)((uint16_t)lcd_cmd & 0xFF);
+                    WRITE8();
+                }
             } else {
-                buf[0] = (uint8_t)((uint16_t)lcd_cmd >> 8);
-                WRITE8();
-                WR_LOW();
-                WR_HIGH();
-                buf[0] = (uint8_t)((uint16_t)lcd_cmd & 0xFF);
-                WRITE8();
+                uint16_t *buf = NULL;
+                buf[0] = (uint16_t)lcd_cmd;
+                WRITE16();
             }
-        } else {
-            uint16_t *buf = NULL;
-            buf[0] = (uint16_t)lcd_cmd;
-            WRITE16();
+            WR_LOW();
+            WR_HIGH();
+            DC_DATA();
         }
-        WR_LOW();
-        WR_HIGH();
-        DC_DATA();
 
         self->write_color(self, color, color_size);
 
-        if (self->callback != mp_const_none && mp_obj_is_callable(self->callback)) {
-            mp_call_function_n_kw(self->callback, 0, 0, NULL);
-        }
-        self->trans_done = true;
+        // the transfer is blocking so the callback gets called here the same
+        // way the SPI bus does it, that is also what counts the chunks of the
+        // 3 byte wire formats
+        bus_trans_done_cb(&self->panel_io_handle, NULL, self);
 
         return LCD_OK;
     }
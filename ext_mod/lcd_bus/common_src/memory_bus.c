@@ -0,0 +1,290 @@
+// Copyright (c) 2024 - 2025 Kevin G. Schlosser
+
+/* includes */
+// local includes
+#include "lcd_types.h"
+#include "modlcd_bus.h"
+#include "../common_include/memory_bus.h"
+
+// micropython includes
+#include "py/obj.h"
+#include "py/runtime.h"
+#include "py/objarray.h"
+#include "py/mphal.h"
+
+// stdlib includes
+#include <string.h>
+/* end includes */
+
+
+/* forward declarations */
+mp_lcd_err_t memory_rx_param(mp_obj_t obj, int lcd_cmd, void *param, size_t param_size);
+mp_lcd_err_t memory_tx_param(mp_obj_t obj, int lcd_cmd, void *param, size_t param_size);
+mp_lcd_err_t memory_tx_color(mp_obj_t obj, int lcd_cmd, void *color, size_t color_size, int x_start, int y_start, int x_end, int y_end, uint8_t rotation, bool last_update);
+mp_lcd_err_t memory_del(mp_obj_t obj);
+mp_lcd_err_t memory_init(mp_obj_t obj, uint16_t width, uint16_t height, uint8_t bpp, uint32_t buffer_size, bool rgb565_byte_swap, uint8_t cmd_bits, uint8_t param_bits);
+mp_lcd_err_t memory_get_lane_count(mp_obj_t obj, uint8_t *lane_count);
+/* end forward declarations */
+
+
+/* function definitions */
+static mp_obj_t mp_lcd_memory_bus_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *all_args)
+{
+    enum { ARG_delay_us, ARG_crc };
+    const mp_arg_t make_new_args[] = {
+        { MP_QSTR_delay_us, MP_ARG_INT  | MP_ARG_KW_ONLY, { .u_int = 0     } },
+        { MP_QSTR_crc,      MP_ARG_BOOL | MP_ARG_KW_ONLY, { .u_bool = true } },
+    };
+
+    mp_arg_val_t args[MP_ARRAY_SIZE(make_new_args)];
+    mp_arg_parse_all_kw_array(
+        n_args,
+        n_kw,
+        all_args,
+        MP_ARRAY_SIZE(make_new_args),
+        make_new_args,
+        args
+    );
+
+    if (args[ARG_delay_us].u_int < 0) {
+        mp_raise_msg(&mp_type_ValueError, MP_ERROR_TEXT("delay_us must be >= 0"));
+    }
+
+    // create new object
+    mp_lcd_memory_bus_obj_t *self = m_new_obj(mp_lcd_memory_bus_obj_t);
+    self->base.type = &mp_lcd_memory_bus_type;
+
+    self->callback = mp_const_none;
+
+    self->delay_us = (uint32_t)args[ARG_delay_us].u_int;
+    self->crc_enabled = args[ARG_crc].u_bool;
+
+    self->panel_io_handle.get_lane_count = memory_get_lane_count;
+    self->panel_io_handle.init = memory_init;
+    self->panel_io_handle.rx_param = memory_rx_param;
+    self->panel_io_handle.tx_param = memory_tx_param;
+    self->panel_io_handle.tx_color = memory_tx_color;
+    self->panel_io_handle.del = memory_del;
+
+    return MP_OBJ_FROM_PTR(self);
+}
+
+
+/*
+CRC-32 (the same one zlib and binascii.crc32 use) done a nibble at a time so
+the table stays small. Only gets run once per frame.
+*/
+static uint32_t memory_crc32(const uint8_t *buf, uint32_t len)
+{
+    static const uint32_t table[16] = {
+        0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC,
+        0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+        0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C,
+        0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C
+    };
+
+    uint32_t crc = 0xFFFFFFFF;
+
+    for (uint32_t i = 0; i < len; i++) {
+        crc ^= buf[i];
+        crc = (crc >> 4) ^ table[crc & 0x0F];
+        crc = (crc >> 4) ^ table[crc & 0x0F];
+    }
+
+    return crc ^ 0xFFFFFFFF;
+}
+
+
+mp_lcd_err_t memory_rx_param(mp_obj_t obj, int lcd_cmd, void *param, size_t param_size)
+{
+    LCD_UNUSED(obj);
+    LCD_UNUSED(lcd_cmd);
+
+    // there is no display to read from so reads come back as zeros
+    memset(param, 0, param_size);
+    return LCD_OK;
+}
+
+
+mp_lcd_err_t memory_tx_param(mp_obj_t obj, int lcd_cmd, void *param, size_t param_size)
+{
+    LCD_UNUSED(obj);
+    LCD_UNUSED(lcd_cmd);
+    LCD_UNUSED(param);
+    LCD_UNUSED(param_size);
+    return LCD_OK;
+}
+
+
+mp_lcd_err_t memory_tx_color(mp_obj_t obj, int lcd_cmd, void *color, size_t color_size, int x_start, int y_start, int x_end, int y_end, uint8_t rotation, bool last_update)
+{
+    LCD_UNUSED(lcd_cmd);
+    LCD_UNUSED(rotation);
+
+    mp_lcd_memory_bus_obj_t *self = MP_OBJ_TO_PTR(obj);
+
+    if (self->framebuffer == NULL) return LCD_ERR_INVALID_STATE;
+
+    mp_lcd_err_t ret = lcd_panel_io_copy_area(
+        self->framebuffer, self->width, self->height, self->bytes_per_pixel,
+        color, color_size, x_start, y_start, x_end, y_end
+    );
+
+    if (ret != LCD_OK) return ret;
+
+    if (self->delay_us) mp_hal_delay_us(self->delay_us);
+
+    if (last_update) {
+        if (self->crc_enabled) {
+            self->crc = memory_crc32(self->framebuffer, self->framebuffer_size);
+        }
+        self->frame_count++;
+    }
+
+    bus_trans_done_cb(&self->panel_io_handle, NULL, self);
+
+    return LCD_OK;
+}
+
+
+mp_lcd_err_t memory_del(mp_obj_t obj)
+{
+    mp_lcd_memory_bus_obj_t *self = MP_OBJ_TO_PTR(obj);
+
+    if (self->framebuffer != NULL) {
+        m_free(self->framebuffer);
+        self->framebuffer = NULL;
+        self->framebuffer_size = 0;
+    }
+
+    return LCD_OK;
+}
+
+
+mp_lcd_err_t memory_init(mp_obj_t obj, uint16_t width, uint16_t height, uint8_t bpp, uint32_t buffer_size, bool rgb565_byte_swap, uint8_t cmd_bits, uint8_t param_bits)
+{
+    LCD_UNUSED(buffer_size);
+    LCD_UNUSED(cmd_bits);
+    LCD_UNUSED(param_bits);
+
+    mp_lcd_memory_bus_obj_t *self = MP_OBJ_TO_PTR(obj);
+
+    // the copy is done in whole pixels so I1 and the other packed formats can't be used
+    if (bpp == 0 || bpp % 8) return LCD_ERR_NOT_SUPPORTED;
+
+    uint8_t bytes_per_pixel = bpp / 8;
+
+    if (self->framebuffer != NULL) memory_del(obj);
+
+    self->framebuffer_size = (uint32_t)width * (uint32_t)height * (uint32_t)bytes_per_pixel;
+    self->framebuffer = m_malloc0(self->framebuffer_size);
+
+    if (self->framebuffer == NULL) {
+        self->framebuffer_size = 0;
+        return LCD_ERR_NO_MEM;
+    }
+
+    self->width = width;
+    self->height = height;
+    self->bytes_per_pixel = bytes_per_pixel;
+    self->rgb565_byte_swap = rgb565_byte_swap;
+    self->trans_done = true;
+
+    self->crc = 0;
+    self->frame_count = 0;
+
+    return LCD_OK;
+}
+
+
+mp_lcd_err_t memory_get_lane_count(mp_obj_t obj, uint8_t *lane_count)
+{
+    LCD_UNUSED(obj);
+    *lane_count = 1;
+    return LCD_OK;
+}
+
+
+static mp_int_t mp_lcd_memory_bus_get_buffer(mp_obj_t self_in, mp_buffer_info_t *bufinfo, mp_uint_t flags)
+{
+    LCD_UNUSED(flags);
+
+    mp_lcd_memory_bus_obj_t *self = MP_OBJ_TO_PTR(self_in);
+
+    if (self->framebuffer == NULL) return 1;
+
+    bufinfo->buf = self->framebuffer;
+    bufinfo->len = self->framebuffer_size;
+    bufinfo->typecode = 'B';
+    return 0;
+}
+
+
+static mp_obj_t mp_lcd_memory_bus_get_crc(mp_obj_t self_in)
+{
+    mp_lcd_memory_bus_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    return mp_obj_new_int_from_uint(self->crc);
+}
+
+MP_DEFINE_CONST_FUN_OBJ_1(mp_lcd_memory_bus_get_crc_obj, mp_lcd_memory_bus_get_crc);
+
+
+static mp_obj_t mp_lcd_memory_bus_get_frame_count(mp_obj_t self_in)
+{
+    mp_lcd_memory_bus_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    return mp_obj_new_int_from_uint(self->frame_count);
+}
+
+MP_DEFINE_CONST_FUN_OBJ_1(mp_lcd_memory_bus_get_frame_count_obj, mp_lcd_memory_bus_get_frame_count);
+
+
+static mp_obj_t mp_lcd_memory_bus_set_delay(mp_obj_t self_in, mp_obj_t delay_us_in)
+{
+    mp_lcd_memory_bus_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    mp_int_t delay_us = mp_obj_get_int(delay_us_in);
+
+    if (delay_us < 0) {
+        mp_raise_msg(&mp_type_ValueError, MP_ERROR_TEXT("delay_us must be >= 0"));
+    }
+
+    self->delay_us = (uint32_t)delay_us;
+    return mp_const_none;
+}
+
+MP_DEFINE_CONST_FUN_OBJ_2(mp_lcd_memory_bus_set_delay_obj, mp_lcd_memory_bus_set_delay);
+/* end function definitions */
+
+
+static const mp_rom_map_elem_t mp_lcd_memory_bus_locals_dict_table[] = {
+    { MP_ROM_QSTR(MP_QSTR_get_crc),              MP_ROM_PTR(&mp_lcd_memory_bus_get_crc_obj)         },
+    { MP_ROM_QSTR(MP_QSTR_get_frame_count),      MP_ROM_PTR(&mp_lcd_memory_bus_get_frame_count_obj) },
+    { MP_ROM_QSTR(MP_QSTR_set_delay),            MP_ROM_PTR(&mp_lcd_memory_bus_set_delay_obj)       },
+    { MP_ROM_QSTR(MP_QSTR_get_lane_count),       MP_ROM_PTR(&mp_lcd_bus_get_lane_count_obj)       },
+    { MP_ROM_QSTR(MP_QSTR_allocate_framebuffer), MP_ROM_PTR(&mp_lcd_bus_allocate_framebuffer_obj) },
+    { MP_ROM_QSTR(MP_QSTR_free_framebuffer),     MP_ROM_PTR(&mp_lcd_bus_free_framebuffer_obj)     },
+    { MP_ROM_QSTR(MP_QSTR_set_rgb565_conversion), MP_ROM_PTR(&mp_lcd_bus_set_rgb565_conversion_obj) },
+    { MP_ROM_QSTR(MP_QSTR_set_wire_format),       MP_ROM_PTR(&mp_lcd_bus_set_wire_format_obj)       },
+    { MP_ROM_QSTR(MP_QSTR_stats),                MP_ROM_PTR(&mp_lcd_bus_stats_obj)                },
+    { MP_ROM_QSTR(MP_QSTR_reset_stats),          MP_ROM_PTR(&mp_lcd_bus_reset_stats_obj)          },
+    { MP_ROM_QSTR(MP_QSTR_register_callback),    MP_ROM_PTR(&mp_lcd_bus_register_callback_obj)    },
+    { MP_ROM_QSTR(MP_QSTR_tx_param),             MP_ROM_PTR(&mp_lcd_bus_tx_param_obj)             },
+    { MP_ROM_QSTR(MP_QSTR_tx_color),             MP_ROM_PTR(&mp_lcd_bus_tx_color_obj)             },
+    { MP_ROM_QSTR(MP_QSTR_rx_param),             MP_ROM_PTR(&mp_lcd_bus_rx_param_obj)             },
+    { MP_ROM_QSTR(MP_QSTR_init),                 MP_ROM_PTR(&mp_lcd_bus_init_obj)                 },
+    { MP_ROM_QSTR(MP_QSTR_deinit),               MP_ROM_PTR(&mp_lcd_bus_deinit_obj)               },
+    { MP_ROM_QSTR(MP_QSTR___del__),              MP_ROM_PTR(&mp_lcd_bus_deinit_obj)               },
+};
+
+static MP_DEFINE_CONST_DICT(mp_lcd_memory_bus_locals_dict, mp_lcd_memory_bus_locals_dict_table);
+
+
+/* create micropython class */
+MP_DEFINE_CONST_OBJ_TYPE(
+    mp_lcd_memory_bus_type,
+    MP_QSTR_MemoryBus,
+    MP_TYPE_FLAG_NONE,
+    make_new, mp_lcd_memory_bus_make_new,
+    buffer, mp_lcd_memory_bus_get_buffer,
+    locals_dict, (mp_obj_dict_t *)&mp_lcd_memory_bus_locals_dict
+);
+/* end create micropython class */
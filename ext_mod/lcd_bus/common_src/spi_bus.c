@@ -378,6 +378,10 @@ static const mp_rom_map_elem_t mp_lcd_spi_bus_locals_dict_table[] = {
     { MP_ROM_QSTR(MP_QSTR_get_lane_count),       MP_ROM_PTR(&mp_lcd_bus_get_lane_count_obj)       },
     { MP_ROM_QSTR(MP_QSTR_allocate_framebuffer), MP_ROM_PTR(&mp_lcd_bus_allocate_framebuffer_obj) },
     { MP_ROM_QSTR(MP_QSTR_free_framebuffer),     MP_ROM_PTR(&mp_lcd_bus_free_framebuffer_obj)     },
+    { MP_ROM_QSTR(MP_QSTR_set_rgb565_conversion), MP_ROM_PTR(&mp_lcd_bus_set_rgb565_conversion_obj) },
+    { MP_ROM_QSTR(MP_QSTR_set_wire_format),       MP_ROM_PTR(&mp_lcd_bus_set_wire_format_obj)       },
+    { MP_ROM_QSTR(MP_QSTR_stats),                MP_ROM_PTR(&mp_lcd_bus_stats_obj)                },
+    { MP_ROM_QSTR(MP_QSTR_reset_stats),          MP_ROM_PTR(&mp_lcd_bus_reset_stats_obj)          },
     { MP_ROM_QSTR(MP_QSTR_register_callback),    MP_ROM_PTR(&mp_lcd_bus_register_callback_obj)    },
     { MP_ROM_QSTR(MP_QSTR_tx_param),             MP_ROM_PTR(&mp_lcd_bus_tx_param_obj)             },
     { MP_ROM_QSTR(MP_QSTR_tx_color),             MP_ROM_PTR(&mp_lcd_bus_tx_color_obj)             },
@@ -8,6 +8,7 @@
 
         //local_includes
         #include "lcd_types.h"
+        #include "lcd_rotation.h"
 
         // esp-idf includes
         #include "hal/lcd_hal.h"
@@ -65,11 +66,48 @@
             StaticSemaphore_t buffer;
         } rgb_bus_lock_t;
 
+        typedef struct _rgb_bus_flush_t {
+            uint8_t *buf;
+            int x_start;
+            int y_start;
+            int x_end;
+            int y_end;
+            uint8_t rotation;
+            bool last_update;
+            uint32_t start_us;
+            // vsync count when LVGL started handing over the frame
+            uint32_t start_vsync;
+        } rgb_bus_flush_t;
+
         typedef struct _rgb_bus_event_t {
             EventGroupHandle_t handle;
             StaticEventGroup_t buffer;
         } rgb_bus_event_t;
 
+        /*
+        Maximum number of areas that are tracked between buffer swaps. Once all
+        of the slots are used new areas get merged into the area that grows the
+        least by doing so.
+        */
+        #ifndef RGB_BUS_DIRTY_AREA_COUNT
+            #define RGB_BUS_DIRTY_AREA_COUNT  (8)
+        #endif
+
+        /*
+        When the tracked areas cover more than this percentage of the frame
+        buffer a single copy of the entire frame buffer is done instead.
+        */
+        #ifndef RGB_BUS_DIRTY_FULL_COPY_PERCENT
+            #define RGB_BUS_DIRTY_FULL_COPY_PERCENT  (70)
+        #endif
+
+        typedef struct _rgb_bus_area_t {
+            int32_t x1;
+            int32_t y1;
+            int32_t x2;
+            int32_t y2;
+        } rgb_bus_area_t;
+
         typedef struct _mp_lcd_rgb_bus_obj_t {
             mp_obj_base_t base;
 
@@ -93,22 +131,47 @@
 
             uint8_t *active_fb;
             uint8_t *idle_fb;
-            uint8_t *partial_buf;
 
-            int x_start;
-            int y_start;
-            int x_end;
-            int y_end;
+            // areas of idle_fb that have been written to since the last swap
+            rgb_bus_area_t dirty_areas[RGB_BUS_DIRTY_AREA_COUNT];
+            uint8_t dirty_area_count;
+            uint32_t dirty_pixel_count;
+
+            lcd_pixel_pipeline_t pixel_pipeline;
+
             uint16_t width;
             uint16_t height;
-            uint8_t rotation: 2;
             uint8_t bytes_per_pixel: 2;
-            uint8_t last_update: 1;
             uint8_t rgb565_dither: 1;
 
+            // the area being handed over to the copy task. flush_ready is
+            // only called once it has been copied so LVGL never has more than
+            // one area waiting on the copy task.
+            rgb_bus_flush_t flush;
             rgb_bus_lock_t copy_lock;
-            rgb_bus_event_t copy_task_exit;
             rgb_bus_lock_t tx_color_lock;
+
+            /*
+            When vsync_refresh is set the callback for the last flush of a
+            frame is only called once the frame has been swapped in. LVGL is
+            not able to start on the next frame before then, so it never
+            renders more often than the panel refreshes.
+
+            A frame is late when it was swapped in more than one refresh after
+            LVGL started on it. skipped is the number of extra refreshes late
+            frames caused, the panel showed the previous frame again for
+            those.
+            */
+            bool vsync_refresh;
+            bool frame_started;
+            volatile uint32_t vsync_count;
+            uint32_t frame_start_vsync;
+            uint32_t last_shown_vsync;
+            uint32_t frames_shown;
+            uint32_t frames_late;
+            uint32_t frames_skipped;
+
+            rgb_bus_event_t copy_task_exit;
             rgb_bus_event_t swap_bufs;
             rgb_bus_lock_t init_lock;
 
@@ -52,6 +52,8 @@
         mp_lcd_dsi_bus_obj_t *self = (mp_lcd_dsi_bus_obj_t *)user_ctx;
 
         if (!self->trans_done && dpi_panel->fbs[dpi_panel->cur_fb_index] == self->transmitting_buf) {
+           lcd_panel_io_stats_flush_done(&self->panel_io_handle.stats, self->panel_io_handle.stats.flush_start_us);
+
            if (self->callback != mp_const_none && mp_obj_is_callable(self->callback)) {
                cb_isr(self->callback);
            }
@@ -398,8 +400,10 @@
         }
 
         if (self->callback == mp_const_none || self->panel_config.num_fbs != 2) {
+            uint32_t start = lcd_panel_io_ticks_us();
             while (!self->trans_done) {}
             self->trans_done = false;
+            self->panel_io_handle.stats.blocked_time_us += lcd_panel_io_ticks_us() - start;
         }
 
         return LCD_OK;
@@ -7,6 +7,8 @@ static bool led_rmt_bus_trans_done_cb(rmt_channel_handle_t tx_chan, const rmt_tx
     LCD_UNUSED(tx_chan);
     LCD_UNUSED(edata);
 
+    lcd_panel_io_stats_flush_done(&self->panel_io_handle.stats, self->panel_io_handle.stats.flush_start_us);
+
     if (self->callback != mp_const_none && mp_obj_is_callable(self->callback)) {
         cb_isr(self->callback);
     }
@@ -539,8 +541,10 @@ mp_lcd_err_t led_tx_color(mp_obj_t obj, int lcd_cmd, void *color, size_t color_s
     }
 
     if (err == LCD_OK && self->callback == mp_const_none) {
+        uint32_t start = lcd_panel_io_ticks_us();
         while (!self->trans_done) {}
         self->trans_done = false;
+        self->panel_io_handle.stats.blocked_time_us += lcd_panel_io_ticks_us() - start;
     }
 
     return err;
@@ -551,6 +555,10 @@ static const mp_rom_map_elem_t mp_lcd_led_locals_dict_table[] = {
     { MP_ROM_QSTR(MP_QSTR_get_lane_count),       MP_ROM_PTR(&mp_lcd_bus_get_lane_count_obj)       },
     { MP_ROM_QSTR(MP_QSTR_allocate_framebuffer), MP_ROM_PTR(&mp_lcd_bus_allocate_framebuffer_obj) },
     { MP_ROM_QSTR(MP_QSTR_free_framebuffer),     MP_ROM_PTR(&mp_lcd_bus_free_framebuffer_obj)     },
+    { MP_ROM_QSTR(MP_QSTR_set_rgb565_conversion), MP_ROM_PTR(&mp_lcd_bus_set_rgb565_conversion_obj) },
+    { MP_ROM_QSTR(MP_QSTR_set_wire_format),       MP_ROM_PTR(&mp_lcd_bus_set_wire_format_obj)       },
+    { MP_ROM_QSTR(MP_QSTR_stats),                MP_ROM_PTR(&mp_lcd_bus_stats_obj)                },
+    { MP_ROM_QSTR(MP_QSTR_reset_stats),          MP_ROM_PTR(&mp_lcd_bus_reset_stats_obj)          },
     { MP_ROM_QSTR(MP_QSTR_register_callback),    MP_ROM_PTR(&mp_lcd_bus_register_callback_obj)    },
     { MP_ROM_QSTR(MP_QSTR_tx_param),             MP_ROM_PTR(&mp_lcd_bus_tx_param_obj)             },
     { MP_ROM_QSTR(MP_QSTR_tx_color),             MP_ROM_PTR(&mp_lcd_bus_tx_color_obj)             },
@@ -102,7 +102,8 @@
             ARG_de_idle_high,
             ARG_pclk_idle_high,
             ARG_pclk_active_low,
-            ARG_rgb565_dither
+            ARG_rgb565_dither,
+            ARG_vsync_refresh
         };
 
         const mp_arg_t allowed_args[] = {
@@ -139,6 +140,7 @@
             { MP_QSTR_pclk_idle_high,     MP_ARG_BOOL | MP_ARG_KW_ONLY, { .u_bool = false  } },
             { MP_QSTR_pclk_active_low,    MP_ARG_BOOL | MP_ARG_KW_ONLY, { .u_bool = false  } },
             { MP_QSTR_rgb565_dither,      MP_ARG_BOOL | MP_ARG_KW_ONLY, { .u_bool = false  } },
+            { MP_QSTR_vsync_refresh,      MP_ARG_BOOL | MP_ARG_KW_ONLY, { .u_bool = false  } },
         };
 
         mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
@@ -151,6 +153,8 @@
         self->callback = mp_const_none;
 
         self->rgb565_dither = (uint8_t)args[ARG_rgb565_dither].u_bool;
+        self->vsync_refresh = args[ARG_vsync_refresh].u_bool;
+
 
         self->bus_config.pclk_hz = (uint32_t)args[ARG_freq].u_int;
         self->bus_config.hsync_pulse_width = (uint32_t)args[ARG_hsync_pulse_width].u_int;
@@ -259,8 +263,9 @@
         mp_lcd_rgb_bus_obj_t *self = (mp_lcd_rgb_bus_obj_t *)obj;
 
         if (self->panel_handle != NULL) {
+            // a flush without a buffer tells the copy task to stop
             rgb_bus_lock_acquire(&self->tx_color_lock, -1);
-            self->partial_buf = NULL;
+            self->flush.buf = NULL;
             rgb_bus_event_set(&self->copy_task_exit);
             rgb_bus_lock_release(&self->copy_lock);
             rgb_bus_lock_release(&self->tx_color_lock);
@@ -350,6 +355,8 @@
 
         if (bpp != 16 && self->rgb565_dither) self->rgb565_dither = 0;
 
+        bool pipeline_byte_swap = false;
+
         if (bpp == 16 && rgb565_byte_swap) {
             /*
             We change the pins aound when the bus width is 16 and wanting to
@@ -367,13 +374,17 @@
                     self->panel_io_config.data_gpio_nums[i] = self->panel_io_config.data_gpio_nums[i + 8];
                     self->panel_io_config.data_gpio_nums[i + 8] = temp_pin;
                 }
-
-                self->rgb565_byte_swap = false;
             } else {
-                self->rgb565_byte_swap = true;
+                // the bytes get swapped when the pixels are copied into the
+                // frame buffer instead of in place in the buffer LVGL renders to.
+                pipeline_byte_swap = true;
             }
-        } else {
-            self->rgb565_byte_swap = false;
+        }
+
+        self->rgb565_byte_swap = false;
+
+        if (self->rgb565_dither && !rgb565_dither_init()) {
+            mp_raise_msg(&mp_type_MemoryError, MP_ERROR_TEXT("Unable to allocate dither tables"));
         }
 
         self->panel_io_config.timings.h_res = (uint32_t)width;
@@ -383,10 +394,19 @@
         self->width = width;
         self->height = height;
         self->bytes_per_pixel = bpp / 8;
+        self->pixel_pipeline = lcd_rotation_get_pipeline(self->bytes_per_pixel, pipeline_byte_swap, (bool)self->rgb565_dither);
 
         self->panel_io_config.flags.fb_in_psram = 1;
         self->panel_io_config.flags.double_fb = 1;
 
+        self->frame_started = false;
+        self->vsync_count = 0;
+        self->frame_start_vsync = 0;
+        self->last_shown_vsync = 0;
+        self->frames_shown = 0;
+        self->frames_late = 0;
+        self->frames_skipped = 0;
+
         rgb_bus_lock_init(&self->copy_lock);
         rgb_bus_lock_init(&self->tx_color_lock);
         rgb_bus_event_init(&self->copy_task_exit);
@@ -439,18 +459,34 @@
         LCD_UNUSED(color_size);
 
         mp_lcd_rgb_bus_obj_t *self = (mp_lcd_rgb_bus_obj_t *)obj;
-        
-        rgb_bus_lock_acquire(&self->tx_color_lock, -1);
 
-        self->last_update = (uint8_t)last_update;
-        self->partial_buf = (uint8_t *)color;
-        self->x_start = x_start;
-        self->y_start = y_start;
-        self->x_end = x_end;
-        self->y_end = y_end;
-        self->rotation = rotation;
+        if (!self->frame_started) {
+            self->frame_start_vsync = self->vsync_count;
+            self->frame_started = true;
+        }
+
+        // only waits when tx_color gets called again before the copy task
+        // has finished the last area. LVGL waits on flush_ready so it doesn't
+        if (!rgb_bus_lock_acquire(&self->tx_color_lock, 0)) {
+            mp_uint_t start = mp_hal_ticks_us();
+            rgb_bus_lock_acquire(&self->tx_color_lock, -1);
+            self->panel_io_handle.stats.blocked_time_us += (uint64_t)(mp_hal_ticks_us() - start);
+        }
+
+        self->flush.buf = (uint8_t *)color;
+        self->flush.x_start = x_start;
+        self->flush.y_start = y_start;
+        self->flush.x_end = x_end;
+        self->flush.y_end = y_end;
+        self->flush.rotation = rotation;
+        self->flush.last_update = last_update;
+        self->flush.start_us = self->panel_io_handle.stats.flush_start_us;
+        self->flush.start_vsync = self->frame_start_vsync;
+
+        if (last_update) self->frame_started = false;
 
         rgb_bus_lock_release(&self->copy_lock);
+
 //        if (self->callback != mp_const_none) {
 //            mp_call_function_n_kw(self->callback, 0, 0, NULL);
 //        }
@@ -458,12 +494,63 @@
         return LCD_OK;
     }
 
+    /*
+    Returns a dict with whether vsync_refresh is set, the time it takes the
+    panel to refresh in microseconds, the number of vsyncs, the number of
+    frames that have been swapped in, how many of those were late and the
+    number of refreshes that were skipped because of late frames.
+    */
+    static mp_obj_t mp_lcd_rgb_bus_get_vsync_stats(mp_obj_t obj)
+    {
+        mp_lcd_rgb_bus_obj_t *self = (mp_lcd_rgb_bus_obj_t *)MP_OBJ_TO_PTR(obj);
+        esp_lcd_rgb_timing_t *timings = &self->panel_io_config.timings;
+
+        uint64_t h_total = (uint64_t)(timings->h_res + timings->hsync_pulse_width + timings->hsync_back_porch + timings->hsync_front_porch);
+        uint64_t v_total = (uint64_t)(timings->v_res + timings->vsync_pulse_width + timings->vsync_back_porch + timings->vsync_front_porch);
+        uint32_t refresh_period_us = 0;
+        if (timings->pclk_hz != 0) refresh_period_us = (uint32_t)(h_total * v_total * 1000000ULL / timings->pclk_hz);
+
+        mp_obj_t stats = mp_obj_new_dict(6);
+        mp_obj_dict_store(stats, MP_OBJ_NEW_QSTR(MP_QSTR_enabled), mp_obj_new_bool(self->vsync_refresh));
+        mp_obj_dict_store(stats, MP_OBJ_NEW_QSTR(MP_QSTR_refresh_period_us), mp_obj_new_int_from_uint(refresh_period_us));
+        mp_obj_dict_store(stats, MP_OBJ_NEW_QSTR(MP_QSTR_vsync_count), mp_obj_new_int_from_uint(self->vsync_count));
+        mp_obj_dict_store(stats, MP_OBJ_NEW_QSTR(MP_QSTR_frames), mp_obj_new_int_from_uint(self->frames_shown));
+        mp_obj_dict_store(stats, MP_OBJ_NEW_QSTR(MP_QSTR_late), mp_obj_new_int_from_uint(self->frames_late));
+        mp_obj_dict_store(stats, MP_OBJ_NEW_QSTR(MP_QSTR_skipped), mp_obj_new_int_from_uint(self->frames_skipped));
+
+        return stats;
+    }
+
+    static MP_DEFINE_CONST_FUN_OBJ_1(mp_lcd_rgb_bus_get_vsync_stats_obj, mp_lcd_rgb_bus_get_vsync_stats);
+
+
+    static const mp_rom_map_elem_t mp_lcd_rgb_bus_locals_dict_table[] = {
+        { MP_ROM_QSTR(MP_QSTR_get_vsync_stats),      MP_ROM_PTR(&mp_lcd_rgb_bus_get_vsync_stats_obj)  },
+        { MP_ROM_QSTR(MP_QSTR_get_lane_count),       MP_ROM_PTR(&mp_lcd_bus_get_lane_count_obj)       },
+        { MP_ROM_QSTR(MP_QSTR_allocate_framebuffer), MP_ROM_PTR(&mp_lcd_bus_allocate_framebuffer_obj) },
+        { MP_ROM_QSTR(MP_QSTR_free_framebuffer),     MP_ROM_PTR(&mp_lcd_bus_free_framebuffer_obj)     },
+        { MP_ROM_QSTR(MP_QSTR_set_rgb565_conversion), MP_ROM_PTR(&mp_lcd_bus_set_rgb565_conversion_obj) },
+        { MP_ROM_QSTR(MP_QSTR_set_wire_format),       MP_ROM_PTR(&mp_lcd_bus_set_wire_format_obj)       },
+        { MP_ROM_QSTR(MP_QSTR_stats),                MP_ROM_PTR(&mp_lcd_bus_stats_obj)                },
+        { MP_ROM_QSTR(MP_QSTR_reset_stats),          MP_ROM_PTR(&mp_lcd_bus_reset_stats_obj)          },
+        { MP_ROM_QSTR(MP_QSTR_register_callback),    MP_ROM_PTR(&mp_lcd_bus_register_callback_obj)    },
+        { MP_ROM_QSTR(MP_QSTR_tx_param),             MP_ROM_PTR(&mp_lcd_bus_tx_param_obj)             },
+        { MP_ROM_QSTR(MP_QSTR_tx_color),             MP_ROM_PTR(&mp_lcd_bus_tx_color_obj)             },
+        { MP_ROM_QSTR(MP_QSTR_rx_param),             MP_ROM_PTR(&mp_lcd_bus_rx_param_obj)             },
+        { MP_ROM_QSTR(MP_QSTR_init),                 MP_ROM_PTR(&mp_lcd_bus_init_obj)                 },
+        { MP_ROM_QSTR(MP_QSTR_deinit),               MP_ROM_PTR(&mp_lcd_bus_deinit_obj)               },
+        { MP_ROM_QSTR(MP_QSTR___del__),              MP_ROM_PTR(&mp_lcd_bus_deinit_obj)               },
+    };
+
+    static MP_DEFINE_CONST_DICT(mp_lcd_rgb_bus_locals_dict, mp_lcd_rgb_bus_locals_dict_table);
+
+
     MP_DEFINE_CONST_OBJ_TYPE(
         mp_lcd_rgb_bus_type,
         MP_QSTR_RGBBus,
         MP_TYPE_FLAG_NONE,
         make_new, mp_lcd_rgb_bus_make_new,
-        locals_dict, (mp_obj_dict_t *)&mp_lcd_bus_locals_dict
+        locals_dict, (mp_obj_dict_t *)&mp_lcd_rgb_bus_locals_dict
     );
 
 #else
@@ -22,7 +22,8 @@
     #include "esp_lcd_panel_ops.h"
 
     #include "rgb_bus.h"
-    #include "rgb565_dither.h"
+    #include "lcd_rotation.h"
+    #include "lv_mp_profiler.h"
 
     #include <string.h>
 
@@ -115,38 +116,6 @@
     }
 
 
-    #define RGB_BUS_ROTATION_0    (0)
-    #define RGB_BUS_ROTATION_90   (1)
-    #define RGB_BUS_ROTATION_180  (2)
-    #define RGB_BUS_ROTATION_270  (3)
-
-
-    static void rotate0(uint8_t *src, uint8_t *dst, uint32_t x_start, uint32_t y_start,
-                        uint32_t x_end, uint32_t y_end, uint32_t dst_width, uint32_t dst_height,
-                        uint8_t bytes_per_pixel, uint8_t rgb565_dither);
-
-    static void rotate_8bpp(uint8_t *src, uint8_t *dst, uint32_t x_start, uint32_t y_start,
-                        uint32_t x_end, uint32_t y_end, uint32_t dst_width, uint32_t dst_height,
-                        uint8_t rotate);
-
-    static void rotate_16bpp(uint16_t *src, uint16_t *dst, uint32_t x_start, uint32_t y_start,
-                        uint32_t x_end, uint32_t y_end, uint32_t dst_width, uint32_t dst_height,
-                        uint8_t rotate, uint8_t rgb565_dither);
-
-    static void rotate_24bpp(uint8_t *src, uint8_t *dst, uint32_t x_start, uint32_t y_start,
-                        uint32_t x_end, uint32_t y_end, uint32_t dst_width, uint32_t dst_height,
-                        uint8_t rotate);
-
-    static void rotate_32bpp(uint32_t *src, uint32_t *dst, uint32_t x_start, uint32_t y_start,
-                        uint32_t x_end, uint32_t y_end, uint32_t dst_width, uint32_t dst_height,
-                        uint8_t rotate);
-
-
-    static void copy_pixels(void *dst, void *src, uint32_t x_start, uint32_t y_start,
-                        uint32_t x_end, uint32_t y_end, uint32_t dst_width, uint32_t dst_height,
-                        uint32_t bytes_per_pixel, uint8_t rotate, uint8_t rgb565_dither);
-
-
     static bool rgb_bus_trans_done_cb(esp_lcd_panel_handle_t panel,
                                     const esp_lcd_rgb_panel_event_data_t *edata, void *user_ctx)
     {
@@ -155,6 +124,8 @@
         rgb_panel_t *rgb_panel = __containerof(panel, rgb_panel_t, base);
         uint8_t *curr_buf = rgb_panel->fbs[rgb_panel->cur_fb_index];
 
+        self->vsync_count++;
+
         if (curr_buf != self->active_fb && !rgb_bus_event_isset_from_isr(&self->swap_bufs)) {
             uint8_t *idle_fb = self->idle_fb;
             self->idle_fb = self->active_fb;
@@ -166,6 +137,200 @@
     }
 
 
+    static inline int32_t rgb_bus_clamp(int32_t value, int32_t max)
+    {
+        if (value < 0) return 0;
+        if (value > max) return max;
+        return value;
+    }
+
+
+    static inline uint32_t rgb_bus_area_size(rgb_bus_area_t *area)
+    {
+        return (uint32_t)(area->x2 - area->x1 + 1) * (uint32_t)(area->y2 - area->y1 + 1);
+    }
+
+
+    // records the area of the frame buffer a flush has been copied to
+    static void rgb_bus_dirty_add(mp_lcd_rgb_bus_obj_t *self, rgb_bus_flush_t *flush)
+    {
+        int32_t w = (int32_t)self->width;
+        int32_t h = (int32_t)self->height;
+        rgb_bus_area_t area;
+
+        // convert from the rotated coordinates LVGL gives us to where the
+        // pixels actually land in the frame buffer.
+        switch (flush->rotation) {
+            case LCD_ROTATION_90:
+                area.x1 = flush->y_start;
+                area.x2 = flush->y_end;
+                area.y1 = h - 1 - flush->x_end;
+                area.y2 = h - 1 - flush->x_start;
+                break;
+            case LCD_ROTATION_180:
+                area.x1 = w - 1 - flush->x_end;
+                area.x2 = w - 1 - flush->x_start;
+                area.y1 = h - 1 - flush->y_end;
+                area.y2 = h - 1 - flush->y_start;
+                break;
+            case LCD_ROTATION_270:
+                area.x1 = w - 1 - flush->y_end;
+                area.x2 = w - 1 - flush->y_start;
+                area.y1 = flush->x_start;
+                area.y2 = flush->x_end;
+                break;
+            default:
+                area.x1 = flush->x_start;
+                area.x2 = flush->x_end;
+                area.y1 = flush->y_start;
+                area.y2 = flush->y_end;
+                break;
+        }
+
+        area.x1 = rgb_bus_clamp(area.x1, w - 1);
+        area.x2 = rgb_bus_clamp(area.x2, w - 1);
+        area.y1 = rgb_bus_clamp(area.y1, h - 1);
+        area.y2 = rgb_bus_clamp(area.y2, h - 1);
+
+        for (uint8_t i = 0; i < self->dirty_area_count; i++) {
+            if (area.x1 >= self->dirty_areas[i].x1 && area.x2 <= self->dirty_areas[i].x2 &&
+                area.y1 >= self->dirty_areas[i].y1 && area.y2 <= self->dirty_areas[i].y2) return;
+        }
+
+        if (self->dirty_area_count < RGB_BUS_DIRTY_AREA_COUNT) {
+            self->dirty_areas[self->dirty_area_count++] = area;
+            self->dirty_pixel_count += rgb_bus_area_size(&area);
+            return;
+        }
+
+        // all of the slots are used, merge the area into the one that
+        // ends up growing the least.
+        rgb_bus_area_t merged;
+        rgb_bus_area_t best;
+        uint32_t growth;
+        uint32_t best_growth = UINT32_MAX;
+        uint8_t best_index = 0;
+
+        for (uint8_t i = 0; i < self->dirty_area_count; i++) {
+            merged.x1 = MIN(area.x1, self->dirty_areas[i].x1);
+            merged.y1 = MIN(area.y1, self->dirty_areas[i].y1);
+            merged.x2 = MAX(area.x2, self->dirty_areas[i].x2);
+            merged.y2 = MAX(area.y2, self->dirty_areas[i].y2);
+
+            growth = rgb_bus_area_size(&merged) - rgb_bus_area_size(&self->dirty_areas[i]);
+            if (growth < best_growth) {
+                best_growth = growth;
+                best_index = i;
+                best = merged;
+            }
+        }
+
+        self->dirty_areas[best_index] = best;
+        self->dirty_pixel_count += best_growth;
+    }
+
+
+    /*
+    Copies the areas that were written to since the last swap from src to dst
+    and starts a new set of areas. After a swap that brings the idle frame
+    buffer up to date with the one that has just been swapped in. The whole
+    frame buffer is copied if the areas cover most of it.
+    */
+    static void rgb_bus_dirty_sync(mp_lcd_rgb_bus_obj_t *self, uint8_t bytes_per_pixel, uint8_t *dst, uint8_t *src)
+    {
+        uint32_t fb_pixel_count = (uint32_t)self->width * (uint32_t)self->height;
+
+        if (self->dirty_pixel_count * 100 >= fb_pixel_count * RGB_BUS_DIRTY_FULL_COPY_PERCENT) {
+            memcpy(dst, src, fb_pixel_count * bytes_per_pixel);
+        } else {
+            uint32_t line_size = (uint32_t)self->width * bytes_per_pixel;
+            uint32_t offset;
+            uint32_t size;
+            rgb_bus_area_t *area;
+
+            for (uint8_t i = 0; i < self->dirty_area_count; i++) {
+                area = &self->dirty_areas[i];
+                offset = (uint32_t)area->y1 * line_size + (uint32_t)area->x1 * bytes_per_pixel;
+                size = (uint32_t)(area->x2 - area->x1 + 1) * bytes_per_pixel;
+
+                if (size == line_size) {
+                    // full width areas are contiguous in memory
+                    memcpy(dst + offset, src + offset, size * (uint32_t)(area->y2 - area->y1 + 1));
+                } else {
+                    for (int32_t y = area->y1; y <= area->y2; y++) {
+                        memcpy(dst + offset, src + offset, size);
+                        offset += line_size;
+                    }
+                }
+            }
+        }
+
+        self->dirty_area_count = 0;
+        self->dirty_pixel_count = 0;
+    }
+
+
+    // calls the Python callback from the copy task. swapped is passed to the
+    // callback when vsync_refresh is set and the frame has been swapped in
+    static void rgb_bus_call_callback(mp_lcd_rgb_bus_obj_t *self, bool swapped)
+    {
+        volatile uint32_t sp = (uint32_t)esp_cpu_get_sp();
+
+        void *old_state = mp_thread_get_state();
+
+        mp_state_thread_t ts;
+        mp_thread_set_state(&ts);
+        mp_stack_set_top((void*)sp);
+        mp_stack_set_limit(CONFIG_FREERTOS_IDLE_TASK_STACKSIZE - 1024);
+        mp_locals_set(mp_state_ctx.thread.dict_locals);
+        mp_globals_set(mp_state_ctx.thread.dict_globals);
+
+        mp_sched_lock();
+        gc_lock();
+
+        nlr_buf_t nlr;
+        if (nlr_push(&nlr) == 0) {
+            if (swapped) {
+                mp_obj_t arg = mp_const_true;
+                mp_call_function_n_kw(self->callback, 1, 0, &arg);
+            } else {
+                mp_call_function_n_kw(self->callback, 0, 0, NULL);
+            }
+            nlr_pop();
+        } else {
+            ets_printf("Uncaught exception in IRQ callback handler!\n");
+            mp_obj_print_exception(&mp_plat_print, MP_OBJ_FROM_PTR(nlr.ret_val));
+        }
+
+        gc_unlock();
+        mp_sched_unlock();
+
+        mp_thread_set_state(old_state);
+    }
+
+
+    // counts a frame that has been swapped in
+    static void rgb_bus_frame_shown(mp_lcd_rgb_bus_obj_t *self, uint32_t start_vsync)
+    {
+        uint32_t shown_vsync = self->vsync_count;
+
+        // the frame is not able to be shown before the one ahead of it, LVGL
+        // could have started on it while the last one was waiting
+        if ((int32_t)(self->last_shown_vsync - start_vsync) > 0 && self->frames_shown != 0) {
+            start_vsync = self->last_shown_vsync;
+        }
+
+        uint32_t refreshes = shown_vsync - start_vsync;
+        if (refreshes > 1) {
+            self->frames_late++;
+            self->frames_skipped += refreshes - 1;
+        }
+
+        self->last_shown_vsync = shown_vsync;
+        self->frames_shown++;
+    }
+
+
     void rgb_bus_copy_task(void *self_in) {
         LCD_DEBUG_PRINT("rgb_bus_copy_task - STARTED\n")
 
@@ -205,11 +370,17 @@
 
         self->active_fb = rgb_panel->fbs[0];
         self->idle_fb = rgb_panel->fbs[1];
+        self->dirty_area_count = 0;
+        self->dirty_pixel_count = 0;
 
+        rgb_bus_flush_t flush;
         uint8_t *idle_fb;
-        bool last_update;
+        uint32_t copy_start;
+        lcd_bus_stats_t *stats = &self->panel_io_handle.stats;
 
         uint8_t bytes_per_pixel = self->bytes_per_pixel;
+        bool wait_for_swap;
+
         rgb_bus_lock_acquire(&self->copy_lock, -1);
 
         self->init_err = LCD_OK;
@@ -218,52 +389,39 @@
         bool exit = rgb_bus_event_isset(&self->copy_task_exit);
         while (!exit) {
             rgb_bus_lock_acquire(&self->copy_lock, -1);
+            flush = self->flush;
 
-            if (self->partial_buf == NULL) break;
-            last_update = self->last_update;
+            if (flush.buf == NULL) break;
 
             idle_fb = self->idle_fb;
+            LV_MP_PROFILER_BEGIN_TAG("rgb_bus_copy");
+            copy_start = lcd_panel_io_ticks_us();
 
-            copy_pixels(
-                (void *)idle_fb, (void *)self->partial_buf,
-                self->x_start, self->y_start,
-                self->x_end, self->y_end,
+            self->pixel_pipeline(
+                (void *)idle_fb, (void *)flush.buf,
+                flush.x_start, flush.y_start,
+                flush.x_end, flush.y_end,
                 self->width, self->height,
-                bytes_per_pixel, self->rotation, self->rgb565_dither);
-
-            rgb_bus_lock_release(&self->tx_color_lock);
+                flush.rotation);
 
-            if (self->callback != mp_const_none) {
-                volatile uint32_t sp = (uint32_t)esp_cpu_get_sp();
+            rgb_bus_dirty_add(self, &flush);
 
-                void *old_state = mp_thread_get_state();
-
-                mp_state_thread_t ts;
-                mp_thread_set_state(&ts);
-                mp_stack_set_top((void*)sp);
-                mp_stack_set_limit(CONFIG_FREERTOS_IDLE_TASK_STACKSIZE - 1024);
-                mp_locals_set(mp_state_ctx.thread.dict_locals);
-                mp_globals_set(mp_state_ctx.thread.dict_globals);
-
-                mp_sched_lock();
-                gc_lock();
+            rgb_bus_lock_release(&self->tx_color_lock);
 
-                nlr_buf_t nlr;
-                if (nlr_push(&nlr) == 0) {
-                    mp_call_function_n_kw(self->callback, 0, 0, NULL);
-                    nlr_pop();
-                } else {
-                    ets_printf("Uncaught exception in IRQ callback handler!\n");
-                    mp_obj_print_exception(&mp_plat_print, MP_OBJ_FROM_PTR(nlr.ret_val));
-                }
+            stats->copy_time_us += lcd_panel_io_ticks_us() - copy_start;
+            stats->copy_count++;
+            lcd_panel_io_stats_flush_done(stats, flush.start_us);
+            LV_MP_PROFILER_END_TAG("rgb_bus_copy");
 
-                gc_unlock();
-                mp_sched_unlock();
+            // LVGL gets told the last flush of a frame is done once the frame
+            // has been swapped in so the next frame starts right after it
+            wait_for_swap = self->vsync_refresh && flush.last_update;
 
-                mp_thread_set_state(old_state);
+            if (self->callback != mp_const_none && !wait_for_swap) {
+                rgb_bus_call_callback(self, false);
             }
 
-            if (last_update) {
+            if (flush.last_update) {
                 mp_lcd_err_t ret = esp_lcd_panel_draw_bitmap(
                     self->panel_handle,
                     0,
@@ -275,398 +433,42 @@
 
                 if (ret != 0) {
                     mp_printf(&mp_plat_print, "esp_lcd_panel_draw_bitmap error (%d)\n", ret);
+
+                    // the buffers were not swapped. The frame is put into the
+                    // buffer that is being shown so nothing that was drawn gets
+                    // lost and the dirty areas don't carry over to the next frame
+                    rgb_bus_dirty_sync(self, bytes_per_pixel, self->active_fb, idle_fb);
                 } else {
+                    // the time spent waiting on the panel to swap buffers
+                    LV_MP_PROFILER_BEGIN_TAG("rgb_bus_swap");
                     rgb_bus_event_clear(&self->swap_bufs);
                     rgb_bus_event_wait(&self->swap_bufs);
-                    memcpy(self->idle_fb, self->active_fb, self->width * self->height * bytes_per_pixel);
-                }
-            }
-
-            exit = rgb_bus_event_isset(&self->copy_task_exit);
-        }
-
-        LCD_DEBUG_PRINT("rgb_bus_copy_task - STOPPED\n")
-    }
-
-
-    __attribute__((always_inline))
-    static inline void copy_8bpp(uint8_t *from, uint8_t *to)
-    {
-        *to++ = *from++;
-    }
-
-    __attribute__((always_inline))
-    static inline void copy_16bpp(uint16_t *from, uint16_t *to)
-    {
-        *to++ = *from++;
-    }
-
-    __attribute__((always_inline))
-    static inline void copy_24bpp(uint8_t *from, uint8_t *to)
-    {
-        *to++ = *from++;
-        *to++ = *from++;
-        *to++ = *from++;
-    }
-
-    __attribute__((always_inline))
-    static inline void copy_32bpp(uint32_t *from, uint32_t *to)
-    {
-        *to++ = *from++;
-    }
-
-    void copy_pixels(void *dst, void *src, uint32_t x_start, uint32_t y_start,
-            uint32_t x_end, uint32_t y_end, uint32_t dst_width, uint32_t dst_height,
-            uint32_t bytes_per_pixel, uint8_t rotate, uint8_t rgb565_dither)
-    {
-        if (rotate == RGB_BUS_ROTATION_0) {
-            rotate0(src, dst, MIN(x_start, dst_width), MIN(y_start, dst_height),
-                    MIN(x_end, dst_width), MIN(y_end, dst_height),
-                    dst_width, dst_height, bytes_per_pixel, rgb565_dither);
-        } else {
-            y_end += 1; // removes black lines between blocks
-            if (rotate == RGB_BUS_ROTATION_90 || rotate == RGB_BUS_ROTATION_270) {
-                x_start = MIN(x_start, dst_height);
-                x_end = MIN(x_end, dst_height);
-                y_start = MIN(y_start, dst_width);
-                y_end = MIN(y_end, dst_width);
-            } else {
-                x_start = MIN(x_start, dst_width);
-                x_end = MIN(x_end, dst_width);
-                y_start = MIN(y_start, dst_height);
-                y_end = MIN(y_end, dst_height);
-            }
-
-            if (bytes_per_pixel == 1) {
-                rotate_8bpp(src, dst, x_start, y_start, x_end, y_end, dst_width, dst_height, rotate);
-            } else if (bytes_per_pixel == 2) {
-                rotate_16bpp(src, dst, x_start, y_start, x_end, y_end, dst_width, dst_height, rotate, rgb565_dither);
-            } else if (bytes_per_pixel == 3) {
-                rotate_24bpp(src, dst, x_start, y_start, x_end, y_end, dst_width, dst_height, rotate);
-            } else if (bytes_per_pixel == 4) {
-                rotate_32bpp(src, dst, x_start, y_start, x_end, y_end, dst_width, dst_height, rotate);
-            }
-        }
-    }
+                    LV_MP_PROFILER_END_TAG("rgb_bus_swap");
 
+                    rgb_bus_frame_shown(self, flush.start_vsync);
 
-    void rotate0(uint8_t *src, uint8_t *dst, uint32_t x_start, uint32_t y_start,
-                uint32_t x_end, uint32_t y_end, uint32_t dst_width,
-                uint32_t dst_height, uint8_t bytes_per_pixel, uint8_t rgb565_dither)
-    {
-        dst += ((y_start * dst_width + x_start) * bytes_per_pixel);
-        if(x_start == 0 && x_end == (dst_width - 1) && !rgb565_dither) {
-            memcpy(dst, src, dst_width * (y_end - y_start + 1) * bytes_per_pixel);
-        } else {
-            uint32_t src_bytes_per_line = (x_end - x_start + 1) * bytes_per_pixel;
-            uint32_t dst_bytes_per_line = dst_width * bytes_per_pixel;
-
-            if (rgb565_dither) {
-                for(uint32_t y = y_start; y < y_end; y++) {
-                    for (uint32_t x=0;x<x_end;x++) {
-                        rgb565_dither_pixel(CALC_THRESHOLD(x, y), (uint16_t *)(src) + x);
-                        copy_16bpp((uint16_t *)(src) + x, (uint16_t *)(dst) + x);
+                    if (self->callback != mp_const_none && wait_for_swap) {
+                        rgb_bus_call_callback(self, true);
+                        wait_for_swap = false;
                     }
-                    dst += dst_bytes_per_line;
-                    src += src_bytes_per_line;
-                }
-            } else {
-                for(uint32_t y = y_start; y < y_end; y++) {
-                    memcpy(dst, src, src_bytes_per_line);
-                    dst += dst_bytes_per_line;
-                    src += src_bytes_per_line;
-                }
-            }
-        }
-    }
-
-    void rotate_8bpp(uint8_t *src, uint8_t *dst, uint32_t x_start, uint32_t y_start,
-                    uint32_t x_end, uint32_t y_end, uint32_t dst_width, uint32_t dst_height,
-                    uint8_t rotate)
-    {
-        uint32_t i;
-        uint32_t j;
-
-        uint32_t src_bytes_per_line = x_end - x_start + 1;
-        uint32_t offset = y_start * src_bytes_per_line + x_start;
-
-        switch (rotate) {
-            case RGB_BUS_ROTATION_90:
-                for (uint32_t y = y_start; y < y_end; y++) {
-                    for (uint32_t x = x_start; x < x_end; x++) {
-                        i = y * src_bytes_per_line + x - offset;
-                        j = (dst_height - 1 - x) * dst_width + y;
-                        copy_8bpp(src + i, dst + j);
-                    }
-                }
-                break;
 
-            // MIRROR_X MIRROR_Y
-            case RGB_BUS_ROTATION_180:
-                LCD_UNUSED(j);
-                LCD_UNUSED(src_bytes_per_line);
-                LCD_UNUSED(offset);
-
-                for (uint32_t y = y_start; y < y_end; y++) {
-                    i = (dst_height - 1 - y) * dst_width + (dst_width - 1 - x_start);
-                    for (uint32_t x = x_start; x < x_end; x++) {
-                        copy_8bpp(src, dst + i);
-                        src++;
-                        i--;
-                    }
-                    src++;
+                    LV_MP_PROFILER_BEGIN_TAG("rgb_bus_sync");
+                    copy_start = lcd_panel_io_ticks_us();
+                    rgb_bus_dirty_sync(self, bytes_per_pixel, self->idle_fb, self->active_fb);
+                    stats->copy_time_us += lcd_panel_io_ticks_us() - copy_start;
+                    LV_MP_PROFILER_END_TAG("rgb_bus_sync");
                 }
-                break;
 
-            // SWAP_XY   MIRROR_X
-            case RGB_BUS_ROTATION_270:
-                for (uint32_t y = y_start; y < y_end; y++) {
-                    for (uint32_t x = x_start; x < x_end; x++) {
-                        i = y * src_bytes_per_line + x - offset;
-                        j = x * dst_width + dst_width - 1 - y;
-                        copy_8bpp(src + i, dst + j);
-                    }
-                }
-                break;
-
-            default:
-                LCD_UNUSED(i);
-                LCD_UNUSED(j);
-                LCD_UNUSED(src_bytes_per_line);
-                LCD_UNUSED(offset);
-                break;
-        }
-
-    }
-
-
-    void rotate_16bpp(uint16_t *src, uint16_t *dst, uint32_t x_start, uint32_t y_start,
-                    uint32_t x_end, uint32_t y_end, uint32_t dst_width, uint32_t dst_height,
-                    uint8_t rotate, uint8_t rgb565_dither)
-    {
-        uint32_t i;
-        uint32_t j;
-
-        uint32_t src_bytes_per_line = x_end - x_start + 1;
-        uint32_t offset = y_start * src_bytes_per_line + x_start;
-
-        if (rgb565_dither) {
-            switch (rotate) {
-                case RGB_BUS_ROTATION_90:
-                    for (uint32_t y = y_start; y < y_end; y++) {
-                        for (uint32_t x = x_start; x < x_end; x++) {
-                            i = y * src_bytes_per_line + x - offset;
-                            j = (dst_height - 1 - x) * dst_width + y;
-                            rgb565_dither_pixel(CALC_THRESHOLD(x, y), src + i);
-                            copy_16bpp(src + i, dst + j);
-                        }
-                    }
-                    break;
-
-                // MIRROR_X MIRROR_Y
-                case RGB_BUS_ROTATION_180:
-                    LCD_UNUSED(j);
-                    LCD_UNUSED(src_bytes_per_line);
-                    LCD_UNUSED(offset);
-
-                    for (uint32_t y = y_start; y < y_end; y++) {
-                        i = (dst_height - 1 - y) * dst_width + (dst_width - 1 - x_start);
-                        for (uint32_t x = x_start; x < x_end; x++) {
-                            rgb565_dither_pixel(CALC_THRESHOLD(x, y), src);
-                            copy_16bpp(src, dst + i);
-                            src++;
-                            i--;
-                        }
-                        src++;
-                    }
-                    break;
-
-                // SWAP_XY   MIRROR_X
-                case RGB_BUS_ROTATION_270:
-                    for (uint32_t y = y_start; y < y_end; y++) {
-                        for (uint32_t x = x_start; x < x_end; x++) {
-                            i = y * src_bytes_per_line + x - offset;
-                            j = (x * dst_width + dst_width - 1 - y);
-                            rgb565_dither_pixel(CALC_THRESHOLD(x, y), src + i);
-                            copy_16bpp(src + i, dst + j);
-                        }
-                    }
-                    break;
-
-                default:
-                    LCD_UNUSED(i);
-                    LCD_UNUSED(j);
-                    LCD_UNUSED(src_bytes_per_line);
-                    LCD_UNUSED(offset);
-                    break;
-            }
-        } else {
-            switch (rotate) {
-                case RGB_BUS_ROTATION_90:
-                    for (uint32_t y = y_start; y < y_end; y++) {
-                        for (uint32_t x = x_start; x < x_end; x++) {
-                            i = y * src_bytes_per_line + x - offset;
-                            j = (dst_height - 1 - x) * dst_width + y;
-                            copy_16bpp(src + i, dst + j);
-                        }
-                    }
-                    break;
-
-                // MIRROR_X MIRROR_Y
-                case RGB_BUS_ROTATION_180:
-                    LCD_UNUSED(j);
-                    LCD_UNUSED(src_bytes_per_line);
-                    LCD_UNUSED(offset);
-
-                    for (uint32_t y = y_start; y < y_end; y++) {
-                        i = (dst_height - 1 - y) * dst_width + (dst_width - 1 - x_start);
-                        for (uint32_t x = x_start; x < x_end; x++) {
-                            copy_16bpp(src, dst + i);
-                            src++;
-                            i--;
-                        }
-                        src++;
+                // LVGL is not left waiting if the frame was not able to be shown
+                if (self->callback != mp_const_none && wait_for_swap) {
+                    rgb_bus_call_callback(self, false);
                 }
-                    break;
-
-                // SWAP_XY   MIRROR_X
-                case RGB_BUS_ROTATION_270:
-                    for (uint32_t y = y_start; y < y_end; y++) {
-                        for (uint32_t x = x_start; x < x_end; x++) {
-                            i = y * src_bytes_per_line + x - offset;
-                            j = (x * dst_width + dst_width - 1 - y);
-                            copy_16bpp(src + i, dst + j);
-                        }
-                    }
-                    break;
-
-                default:
-                    LCD_UNUSED(i);
-                    LCD_UNUSED(j);
-                    LCD_UNUSED(src_bytes_per_line);
-                    LCD_UNUSED(offset);
-                    break;
             }
-        }
-    }
-
-
-    void rotate_24bpp(uint8_t *src, uint8_t *dst, uint32_t x_start, uint32_t y_start,
-                    uint32_t x_end, uint32_t y_end, uint32_t dst_width, uint32_t dst_height,
-                    uint8_t rotate)
-    {
-        uint32_t i;
-        uint32_t j;
-
-        uint32_t src_bytes_per_line = (x_end - x_start + 1) * 3;
-        uint32_t offset = y_start * src_bytes_per_line + x_start * 3;
 
-        switch (rotate) {
-
-            case RGB_BUS_ROTATION_90:
-                for (uint32_t y = y_start; y < y_end; y++) {
-                    for (uint32_t x = x_start; x < x_end; x++) {
-                        i = y * src_bytes_per_line + x * 3 - offset;
-                        j = ((dst_height - 1 - x) * dst_width + y) * 3;
-                        copy_24bpp(src + i, dst + j);
-                    }
-                }
-                break;
-
-            // MIRROR_X MIRROR_Y
-            case RGB_BUS_ROTATION_180:
-                LCD_UNUSED(j);
-                LCD_UNUSED(src_bytes_per_line);
-                LCD_UNUSED(offset);
-
-                for (int y = y_start; y < y_end; y++) {
-                    i = ((dst_height - 1 - y) * dst_width + (dst_width - 1 - x_start)) * 3;
-                    for (size_t x = x_start; x < x_end; x++) {
-                        copy_24bpp(src, dst + i);
-                        src += 3;
-                        i -= 3;
-                    }
-                    src++;
-                }
-                break;
-
-            // SWAP_XY   MIRROR_X
-            case RGB_BUS_ROTATION_270:
-                for (uint32_t y = y_start; y < y_end; y++) {
-                    for (uint32_t x = x_start; x < x_end; x++) {
-                        i = y * src_bytes_per_line + x * 3 - offset;
-                        j = (x * dst_width + dst_width - 1 - y) * 3;
-                        copy_24bpp(src + i, dst + j);
-                    }
-                }
-                break;
-
-            default:
-                LCD_UNUSED(i);
-                LCD_UNUSED(j);
-                LCD_UNUSED(src_bytes_per_line);
-                LCD_UNUSED(offset);
-                break;
+            exit = rgb_bus_event_isset(&self->copy_task_exit);
         }
-    }
-
 
-    void rotate_32bpp(uint32_t *src, uint32_t *dst, uint32_t x_start, uint32_t y_start,
-                    uint32_t x_end, uint32_t y_end, uint32_t dst_width, uint32_t dst_height,
-                    uint8_t rotate)
-    {
-        uint32_t i;
-        uint32_t j;
-
-        uint32_t src_bytes_per_line = x_end - x_start + 1;
-        uint32_t offset = y_start * src_bytes_per_line + x_start;
-
-        switch (rotate) {
-            case RGB_BUS_ROTATION_90:
-                for (uint32_t y = y_start; y < y_end; y++) {
-                    for (uint32_t x = x_start; x < x_end; x++) {
-                        i = y * src_bytes_per_line + x - offset;
-                        j = (dst_height - 1 - x) * dst_width + y;
-                        copy_32bpp(src + i, dst + j);
-                    }
-                }
-                break;
-
-            // MIRROR_X MIRROR_Y
-            case RGB_BUS_ROTATION_180:
-                LCD_UNUSED(j);
-                LCD_UNUSED(src_bytes_per_line);
-                LCD_UNUSED(offset);
-
-                for (uint32_t y = y_start; y < y_end; y++) {
-                    i = (dst_height - 1 - y) * dst_width + (dst_width - 1 - x_start);
-                    for (uint32_t x = x_start; x < x_end; x++) {
-                        copy_32bpp(src, dst + i);
-                        src++;
-                        i--;
-                    }
-                    src++;
-                }
-                break;
-
-            // SWAP_XY   MIRROR_X
-            case RGB_BUS_ROTATION_270:
-                for (uint32_t y = y_start; y < y_end; y++) {
-                    for (uint32_t x = x_start; x < x_end; x++) {
-                        i = y * src_bytes_per_line + x - offset;
-                        j = x * dst_width + dst_width - 1 - y;
-                        copy_32bpp(src + i, dst + j);
-                    }
-                }
-                break;
-
-            default:
-                LCD_UNUSED(i);
-                LCD_UNUSED(j);
-                LCD_UNUSED(src_bytes_per_line);
-                LCD_UNUSED(offset);
-                break;
-        }
+        LCD_DEBUG_PRINT("rgb_bus_copy_task - STOPPED\n")
     }
 
 #endif
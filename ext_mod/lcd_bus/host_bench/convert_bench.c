@@ -0,0 +1,308 @@
+// Copyright (c) 2024 - 2025 Kevin G. Schlosser
+
+/*
+Checks the pixel format conversions in lcd_convert.c and times them on full
+800x480 frames: RGB565 to each of the 3 byte wire formats, the BGR565 swap
+and RGB888/XRGB8888 to RGB565 with each of the dither modes.
+
+    convert_bench [output.json] [iterations]
+
+Exits with 1 if any of the checks fail.
+*/
+
+#include "host_bench.h"
+#include "lcd_convert.h"
+
+#include <string.h>
+
+
+static const char *wire_names[] = {
+    [LCD_WIRE_RGB565] = "RGB565",
+    [LCD_WIRE_BGR565] = "BGR565",
+    [LCD_WIRE_RGB666] = "RGB666",
+    [LCD_WIRE_BGR666] = "BGR666",
+    [LCD_WIRE_RGB888] = "RGB888",
+    [LCD_WIRE_BGR888] = "BGR888",
+};
+
+static const char *dither_names[] = {
+    [LCD_DITHER_NONE] = "none",
+    [LCD_DITHER_ORDERED] = "ordered",
+    [LCD_DITHER_ERROR_DIFFUSION] = "error_diffusion",
+};
+
+
+static uint32_t checks = 0;
+static uint32_t failures = 0;
+
+
+static void check(bool passed, const char *what)
+{
+    checks++;
+    if (passed) return;
+
+    failures++;
+    fprintf(stderr, "FAILED: %s\n", what);
+}
+
+
+// the channels get scaled by repeating their top bits, the tables in lcd_convert.c are the same values
+static void reference_wire(uint8_t *dst, uint16_t pixel, uint8_t format)
+{
+    uint32_t r = pixel >> 11;
+    uint32_t g = (pixel >> 5) & 0x3F;
+    uint32_t b = pixel & 0x1F;
+
+    if (format == LCD_WIRE_RGB666 || format == LCD_WIRE_BGR666) {
+        r = ((r << 1) | (r >> 4)) << 2;
+        g = g << 2;
+        b = ((b << 1) | (b >> 4)) << 2;
+    } else {
+        r = (r << 3) | (r >> 2);
+        g = (g << 2) | (g >> 4);
+        b = (b << 3) | (b >> 2);
+    }
+
+    if (format == LCD_WIRE_BGR666 || format == LCD_WIRE_BGR888) {
+        dst[0] = (uint8_t)b;
+        dst[1] = (uint8_t)g;
+        dst[2] = (uint8_t)r;
+    } else {
+        dst[0] = (uint8_t)r;
+        dst[1] = (uint8_t)g;
+        dst[2] = (uint8_t)b;
+    }
+}
+
+
+static uint16_t swap_bytes(uint16_t pixel)
+{
+    return (uint16_t)((pixel << 8) | (pixel >> 8));
+}
+
+
+// every RGB565 value through each of the wire formats and the BGR565 swap
+static void check_wire(void)
+{
+    uint16_t *pixels = bench_alloc(65536 * 2);
+    uint8_t *actual = bench_alloc(65536 * 3);
+    uint8_t expected[3];
+    char what[64];
+
+    for (uint32_t i = 0; i < 65536; i++) pixels[i] = (uint16_t)i;
+
+    for (uint8_t format = LCD_WIRE_RGB666; format <= LCD_WIRE_BGR888; format++) {
+        lcd_convert_to_wire(actual, pixels, 65536, format);
+
+        bool passed = true;
+        for (uint32_t i = 0; i < 65536 && passed; i++) {
+            reference_wire(expected, (uint16_t)i, format);
+            passed = memcmp(expected, actual + i * 3, 3) == 0;
+        }
+
+        snprintf(what, sizeof(what), "RGB565 to %s", wire_names[format]);
+        check(passed, what);
+    }
+
+    for (uint8_t byte_swap = 0; byte_swap < 2; byte_swap++) {
+        lcd_convert_bgr565(pixels, pixels, 65536, byte_swap);
+
+        bool passed = true;
+        for (uint32_t i = 0; i < 65536 && passed; i++) {
+            uint16_t pixel = (uint16_t)(((i & 0x1F) << 11) | (i & 0x07E0) | (i >> 11));
+            if (byte_swap) pixel = swap_bytes(pixel);
+            passed = pixels[i] == pixel;
+            pixels[i] = (uint16_t)i;
+        }
+
+        snprintf(what, sizeof(what), "BGR565%s", byte_swap ? " byte swap" : "");
+        check(passed, what);
+    }
+
+    free(pixels);
+    free(actual);
+}
+
+
+static void unpack(uint16_t pixel, bool byte_swap, uint8_t *r5, uint8_t *g6, uint8_t *b5)
+{
+    if (byte_swap) pixel = swap_bytes(pixel);
+
+    *r5 = (uint8_t)(pixel >> 11);
+    *g6 = (uint8_t)((pixel >> 5) & 0x3F);
+    *b5 = (uint8_t)(pixel & 0x1F);
+}
+
+
+/*
+No dither truncates each channel. The ordered dither only ever rounds a
+channel up by 1 from that. Converting in place has to give the same pixels
+as converting into another buffer.
+*/
+static void check_rgb565(uint8_t *src, uint16_t *dst, uint8_t *in_place, int16_t *error_buf)
+{
+    uint32_t width = BENCH_WIDTH;
+    uint32_t height = 40;
+    uint32_t x_start = 3;
+    uint32_t y_start = 5;
+    uint8_t r5;
+    uint8_t g6;
+    uint8_t b5;
+    char what[64];
+
+    for (uint8_t src_bytes_per_pixel = 3; src_bytes_per_pixel <= 4; src_bytes_per_pixel++) {
+        size_t src_size = width * height * src_bytes_per_pixel;
+
+        for (uint8_t byte_swap = 0; byte_swap < 2; byte_swap++) {
+            for (uint8_t dither = LCD_DITHER_NONE; dither <= LCD_DITHER_ERROR_DIFFUSION; dither++) {
+                bench_fill(src, src_size, checks + 1);
+                lcd_convert_to_rgb565(dst, src, width, height, x_start, y_start,
+                                      src_bytes_per_pixel, dither, byte_swap, error_buf);
+
+                bool passed = true;
+                for (uint32_t i = 0; i < width * height && passed && dither != LCD_DITHER_ERROR_DIFFUSION; i++) {
+                    const uint8_t *pixel = src + i * src_bytes_per_pixel;
+                    unpack(dst[i], byte_swap, &r5, &g6, &b5);
+
+                    int32_t dr = r5 - (pixel[2] >> 3);
+                    int32_t dg = g6 - (pixel[1] >> 2);
+                    int32_t db = b5 - (pixel[0] >> 3);
+
+                    if (dither == LCD_DITHER_NONE) passed = dr == 0 && dg == 0 && db == 0;
+                    else passed = dr >= 0 && dr <= 1 && dg >= 0 && dg <= 1 && db >= 0 && db <= 1;
+                }
+
+                snprintf(what, sizeof(what), "%dbpp to RGB565 dither %s%s",
+                         src_bytes_per_pixel * 8, dither_names[dither], byte_swap ? " byte swap" : "");
+                check(passed, what);
+
+                memcpy(in_place, src, src_size);
+                lcd_convert_to_rgb565((uint16_t *)in_place, in_place, width, height, x_start, y_start,
+                                      src_bytes_per_pixel, dither, byte_swap, error_buf);
+
+                snprintf(what, sizeof(what), "%dbpp to RGB565 dither %s%s in place",
+                         src_bytes_per_pixel * 8, dither_names[dither], byte_swap ? " byte swap" : "");
+                check(memcmp(in_place, dst, width * height * 2) == 0, what);
+            }
+        }
+    }
+
+    /*
+    A flat color that falls between 2 RGB565 values. Without dither every
+    pixel is the lower value, the dithered area has to average out close to
+    the color that was asked for. The ordered dither rounds in the 5 bit
+    steps, error diffusion works from what the panel shows for each value.
+    */
+    for (uint8_t dither = LCD_DITHER_NONE; dither <= LCD_DITHER_ERROR_DIFFUSION; dither++) {
+        for (uint32_t i = 0; i < width * height; i++) {
+            src[i * 4 + 0] = 0x86;
+            src[i * 4 + 1] = 0x86;
+            src[i * 4 + 2] = 0x86;
+            src[i * 4 + 3] = 0xFF;
+        }
+
+        lcd_convert_to_rgb565(dst, src, width, height, 0, 0, 4, dither, false, error_buf);
+
+        double sum = 0;
+        for (uint32_t i = 0; i < width * height; i++) {
+            unpack(dst[i], false, &r5, &g6, &b5);
+            if (dither == LCD_DITHER_ERROR_DIFFUSION) sum += (double)((r5 << 3) | (r5 >> 2));
+            else sum += (double)(r5 << 3);
+        }
+
+        double error = sum / (width * height) - 0x86;
+        if (error < 0) error = -error;
+
+        snprintf(what, sizeof(what), "flat area dither %s average", dither_names[dither]);
+        if (dither == LCD_DITHER_NONE) check(error > 1.0, what);
+        else check(error < 1.0, what);
+    }
+}
+
+
+static double mpix_per_s(double ms)
+{
+    return (double)(BENCH_WIDTH * BENCH_HEIGHT) / 1000.0 / ms;
+}
+
+
+int main(int argc, char **argv)
+{
+    FILE *out = bench_output(argc, argv);
+    uint32_t iterations = bench_iterations(argc, argv, 20);
+
+    uint32_t pixel_count = BENCH_WIDTH * BENCH_HEIGHT;
+    uint8_t *src = bench_alloc(pixel_count * 4);
+    uint16_t *pixels = bench_alloc(pixel_count * 2);
+    uint8_t *dst = bench_alloc(pixel_count * 4);
+    int16_t *error_buf = bench_alloc(LCD_CONVERT_ERROR_BUF_LEN(BENCH_WIDTH) * sizeof(int16_t));
+
+    check_wire();
+    check_rgb565(src, pixels, dst, error_buf);
+
+    fprintf(out, "{\n  \"checks\": %u,\n  \"failures\": %u,\n  \"iterations\": %u,\n  \"wire\": [",
+            checks, failures, iterations);
+
+    bench_fill((uint8_t *)pixels, pixel_count * 2, 1);
+
+    for (uint8_t format = LCD_WIRE_RGB666; format <= LCD_WIRE_BGR888; format++) {
+        uint64_t start = bench_now_ns();
+        for (uint32_t i = 0; i < iterations; i++) {
+            lcd_convert_to_wire(dst, pixels, pixel_count, format);
+        }
+        double ms = (double)(bench_now_ns() - start) / 1e6 / iterations;
+
+        fprintf(out, "%s\n    {\"format\": \"%s\", \"ms\": %.3f, \"mpix_per_s\": %.1f}",
+                format == LCD_WIRE_RGB666 ? "" : ",", wire_names[format], ms, mpix_per_s(ms));
+        printf("RGB565 to %s: %8.3f ms %8.1f Mpix/s\n", wire_names[format], ms, mpix_per_s(ms));
+    }
+
+    fprintf(out, "\n  ],\n  \"bgr565\": [");
+
+    for (uint8_t byte_swap = 0; byte_swap < 2; byte_swap++) {
+        uint64_t start = bench_now_ns();
+        for (uint32_t i = 0; i < iterations; i++) {
+            lcd_convert_bgr565((uint16_t *)dst, pixels, pixel_count, byte_swap);
+        }
+        double ms = (double)(bench_now_ns() - start) / 1e6 / iterations;
+
+        fprintf(out, "%s\n    {\"byte_swap\": %s, \"ms\": %.3f, \"mpix_per_s\": %.1f}",
+                byte_swap ? "," : "", byte_swap ? "true" : "false", ms, mpix_per_s(ms));
+        printf("BGR565%s: %8.3f ms %8.1f Mpix/s\n", byte_swap ? " byte swap" : "", ms, mpix_per_s(ms));
+    }
+
+    fprintf(out, "\n  ],\n  \"rgb565\": [");
+
+    bench_fill(src, pixel_count * 4, 1);
+
+    bool first = true;
+    for (uint8_t src_bytes_per_pixel = 3; src_bytes_per_pixel <= 4; src_bytes_per_pixel++) {
+        for (uint8_t dither = LCD_DITHER_NONE; dither <= LCD_DITHER_ERROR_DIFFUSION; dither++) {
+            uint64_t start = bench_now_ns();
+            for (uint32_t i = 0; i < iterations; i++) {
+                lcd_convert_to_rgb565(pixels, src, BENCH_WIDTH, BENCH_HEIGHT, 0, 0,
+                                      src_bytes_per_pixel, dither, true, error_buf);
+            }
+            double ms = (double)(bench_now_ns() - start) / 1e6 / iterations;
+
+            fprintf(out, "%s\n    {\"src_bpp\": %d, \"dither\": \"%s\", \"ms\": %.3f, \"mpix_per_s\": %.1f}",
+                    first ? "" : ",", src_bytes_per_pixel * 8, dither_names[dither], ms, mpix_per_s(ms));
+            first = false;
+
+            printf("%dbpp to RGB565 dither %-15s: %8.3f ms %8.1f Mpix/s\n",
+                   src_bytes_per_pixel * 8, dither_names[dither], ms, mpix_per_s(ms));
+        }
+    }
+
+    fprintf(out, "\n  ]\n}\n");
+    if (out != stdout) fclose(out);
+
+    printf("%u of %u conversion checks passed\n", checks - failures, checks);
+
+    free(src);
+    free(pixels);
+    free(dst);
+    free(error_buf);
+
+    return failures == 0 ? 0 : 1;
+}
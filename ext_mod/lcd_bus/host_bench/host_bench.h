@@ -0,0 +1,72 @@
+// Copyright (c) 2024 - 2025 Kevin G. Schlosser
+
+#ifndef _HOST_BENCH_H_
+    #define _HOST_BENCH_H_
+
+    /*
+    Helpers shared by the host benchmarks of the portable lcd_bus code. These
+    are plain C programs that get built with the host compiler and run by
+    `make.py unix --benchmark` after the scene benchmarks. They don't link
+    against MicroPython.
+    */
+
+    #include <stdint.h>
+    #include <stdio.h>
+    #include <stdlib.h>
+    #include <time.h>
+
+    #define BENCH_WIDTH   (800)
+    #define BENCH_HEIGHT  (480)
+
+
+    static inline uint64_t bench_now_ns(void)
+    {
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+    }
+
+
+    // repeatable fill so the reference and the code under test see the same pixels
+    static inline void bench_fill(uint8_t *buf, size_t size, uint32_t seed)
+    {
+        for (size_t i = 0; i < size; i++) {
+            seed = seed * 1103515245 + 12345;
+            buf[i] = (uint8_t)(seed >> 16);
+        }
+    }
+
+
+    static inline void *bench_alloc(size_t size)
+    {
+        void *buf = malloc(size);
+        if (buf == NULL) {
+            fprintf(stderr, "unable to allocate %zu bytes\n", size);
+            exit(2);
+        }
+        return buf;
+    }
+
+
+    // the number of times each case is run comes from the command line
+    static inline uint32_t bench_iterations(int argc, char **argv, uint32_t def)
+    {
+        if (argc > 2) return (uint32_t)strtoul(argv[2], NULL, 10);
+        return def;
+    }
+
+
+    // results get written to the file given as the first argument, stdout otherwise
+    static inline FILE *bench_output(int argc, char **argv)
+    {
+        if (argc < 2) return stdout;
+
+        FILE *out = fopen(argv[1], "w");
+        if (out == NULL) {
+            fprintf(stderr, "unable to open %s\n", argv[1]);
+            exit(2);
+        }
+        return out;
+    }
+
+#endif /* _HOST_BENCH_H_ */
@@ -0,0 +1,381 @@
+// Copyright (c) 2024 - 2025 Kevin G. Schlosser
+
+/*
+Checks the tiled rotation engine in lcd_rotation.c against the per pixel
+loops the RGB bus used before it, for every color depth and rotation, and
+then times both of them copying full 800x480 frames.
+
+The RGB565 pipelines that byte swap and dither while they copy are checked
+the same way and compared to doing the byte swap, the dither and the copy
+as separate passes over the frame, which is what a flush used to go
+through.
+
+    rotation_bench [output.json] [iterations]
+
+Exits with 1 if any of the copies don't match.
+*/
+
+#include "host_bench.h"
+#include "lcd_rotation.h"
+#include "rgb565_dither.h"
+
+#include <string.h>
+
+
+/*
+The loops rgb_bus_rotation.c had before the tiled engine, one pixel at a
+time. The 24bpp 180 degree rotation advanced the source by a single byte at
+the end of each line, that is fixed here so it is comparable. The 180, 90
+and 270 degree rotations leave out the last column of the area, the engine
+keeps doing the same.
+
+Like the old loops there is a copy for each color depth.
+*/
+__attribute__((always_inline))
+static inline void reference_loops(uint8_t *dst, const uint8_t *src, uint32_t x_start, uint32_t y_start,
+                                   uint32_t x_end, uint32_t y_end, uint32_t dst_width, uint32_t dst_height,
+                                   uint8_t bytes_per_pixel, uint8_t rotate)
+{
+    uint32_t src_width = x_end - x_start + 1;
+    uint32_t i;
+    uint32_t j;
+
+    if (rotate == LCD_ROTATION_0) {
+        for (uint32_t y = y_start; y <= y_end; y++) {
+            for (uint32_t x = x_start; x <= x_end; x++) {
+                i = (y - y_start) * src_width + x - x_start;
+                j = y * dst_width + x;
+                memcpy(dst + j * bytes_per_pixel, src + i * bytes_per_pixel, bytes_per_pixel);
+            }
+        }
+        return;
+    }
+
+    for (uint32_t y = y_start; y <= y_end; y++) {
+        for (uint32_t x = x_start; x < x_end; x++) {
+            i = (y - y_start) * src_width + x - x_start;
+
+            if (rotate == LCD_ROTATION_90) {
+                j = (dst_height - 1 - x) * dst_width + y;
+            } else if (rotate == LCD_ROTATION_180) {
+                j = (dst_height - 1 - y) * dst_width + dst_width - 1 - x;
+            } else {
+                j = x * dst_width + dst_width - 1 - y;
+            }
+
+            memcpy(dst + j * bytes_per_pixel, src + i * bytes_per_pixel, bytes_per_pixel);
+        }
+    }
+}
+
+
+static void reference_copy(uint8_t *dst, const uint8_t *src, uint32_t x_start, uint32_t y_start,
+                           uint32_t x_end, uint32_t y_end, uint32_t dst_width, uint32_t dst_height,
+                           uint8_t bytes_per_pixel, uint8_t rotate)
+{
+    switch (bytes_per_pixel) {
+        case 1:
+            reference_loops(dst, src, x_start, y_start, x_end, y_end, dst_width, dst_height, 1, rotate);
+            break;
+        case 2:
+            reference_loops(dst, src, x_start, y_start, x_end, y_end, dst_width, dst_height, 2, rotate);
+            break;
+        case 3:
+            reference_loops(dst, src, x_start, y_start, x_end, y_end, dst_width, dst_height, 3, rotate);
+            break;
+        default:
+            reference_loops(dst, src, x_start, y_start, x_end, y_end, dst_width, dst_height, 4, rotate);
+            break;
+    }
+}
+
+
+#define OP_SWAP    (0x01)
+#define OP_DITHER  (0x02)
+
+
+static inline uint16_t apply_ops(uint16_t pixel, uint8_t ops, uint32_t x, uint32_t y)
+{
+    if (ops & OP_DITHER) rgb565_dither_pixel(CALC_THRESHOLD(x, y), &pixel);
+    if (ops & OP_SWAP) pixel = (uint16_t)((pixel << 8) | (pixel >> 8));
+    return pixel;
+}
+
+
+// the swap and the dither a pipeline does, done up front on a copy of the area
+static void reference_ops(uint16_t *dst, const uint16_t *src, uint32_t x_start, uint32_t y_start,
+                          uint32_t x_end, uint32_t y_end, uint8_t ops)
+{
+    for (uint32_t y = y_start; y <= y_end; y++) {
+        for (uint32_t x = x_start; x <= x_end; x++) {
+            *dst++ = apply_ops(*src++, ops, x, y);
+        }
+    }
+}
+
+
+/*
+What a flush used to go through. lcd_panel_io_tx_color byte swapped LVGL's
+buffer in place, the copy task dithered it in place and then copied it to
+the frame buffer. Returns the number of bytes each pass read and wrote.
+*/
+static uint64_t separate_passes(uint8_t *dst, uint16_t *src, uint32_t x_start, uint32_t y_start,
+                                uint32_t x_end, uint32_t y_end, uint8_t rotate, uint8_t ops,
+                                lcd_pixel_pipeline_t copy)
+{
+    uint32_t pixel_count = (x_end - x_start + 1) * (y_end - y_start + 1);
+    uint64_t touched = 0;
+
+    if (ops & OP_SWAP) {
+        for (uint32_t i = 0; i < pixel_count; i++) src[i] = (uint16_t)((src[i] << 8) | (src[i] >> 8));
+        touched += (uint64_t)pixel_count * 4;
+    }
+
+    if (ops & OP_DITHER) {
+        uint16_t *pixel = src;
+        for (uint32_t y = y_start; y <= y_end; y++) {
+            for (uint32_t x = x_start; x <= x_end; x++) {
+                rgb565_dither_pixel(CALC_THRESHOLD(x, y), pixel++);
+            }
+        }
+        touched += (uint64_t)pixel_count * 4;
+    }
+
+    copy(dst, src, x_start, y_start, x_end, y_end, BENCH_WIDTH, BENCH_HEIGHT, rotate);
+    return touched + (uint64_t)pixel_count * 4;
+}
+
+
+// bytes that are different, this is how much of LVGL's buffer got rewritten
+static size_t count_changed(const uint8_t *a, const uint8_t *b, size_t size)
+{
+    size_t changed = 0;
+    for (size_t i = 0; i < size; i++) {
+        if (a[i] != b[i]) changed++;
+    }
+    return changed;
+}
+
+
+typedef struct _bench_area_t {
+    uint32_t x_start;
+    uint32_t y_start;
+    uint32_t x_end;
+    uint32_t y_end;
+} bench_area_t;
+
+
+// x/y are in the coordinates LVGL renders in, 90 and 270 are BENCH_HEIGHT wide
+static void get_areas(uint8_t rotate, bench_area_t *areas, uint32_t *count)
+{
+    uint32_t width = BENCH_WIDTH;
+    uint32_t height = BENCH_HEIGHT;
+
+    if (rotate == LCD_ROTATION_90 || rotate == LCD_ROTATION_270) {
+        width = BENCH_HEIGHT;
+        height = BENCH_WIDTH;
+    }
+
+    bench_area_t list[] = {
+        { 0, 0, width - 1, height - 1 },           // full frame
+        { 0, 0, width - 1, height / 10 - 1 },      // 1/10 partial buffer
+        { 5, 7, 41, 29 },                          // not a multiple of the tile size
+        { 16, 16, 47, 47 },                        // on tile boundaries
+        { width - 33, height - 17, width - 1, height - 1 },
+        { 100, 200, 100, 200 },                    // single pixel
+        { 0, 123, width - 1, 123 },                // single line
+        { 321, 0, 322, height - 1 }                // 2 columns
+    };
+
+    *count = sizeof(list) / sizeof(list[0]);
+    memcpy(areas, list, sizeof(list));
+}
+
+
+static const uint8_t rotations[] = { LCD_ROTATION_0, LCD_ROTATION_90, LCD_ROTATION_180, LCD_ROTATION_270 };
+static const uint16_t rotation_degrees[] = { 0, 90, 180, 270 };
+
+
+int main(int argc, char **argv)
+{
+    FILE *out = bench_output(argc, argv);
+    uint32_t iterations = bench_iterations(argc, argv, 20);
+
+    if (!rgb565_dither_init()) {
+        fprintf(stderr, "rgb565_dither_init failed\n");
+        return 2;
+    }
+
+    size_t frame_size = BENCH_WIDTH * BENCH_HEIGHT * 4;
+    uint8_t *src = bench_alloc(frame_size);
+    uint8_t *expected = bench_alloc(frame_size);
+    uint8_t *actual = bench_alloc(frame_size);
+
+    bench_area_t areas[8];
+    uint32_t area_count;
+    uint32_t checks = 0;
+    uint32_t failures = 0;
+
+    for (uint8_t bytes_per_pixel = 1; bytes_per_pixel <= 4; bytes_per_pixel++) {
+        lcd_pixel_pipeline_t pipeline = lcd_rotation_get_pipeline(bytes_per_pixel, false, false);
+
+        for (uint8_t r = 0; r < 4; r++) {
+            get_areas(rotations[r], areas, &area_count);
+
+            for (uint32_t a = 0; a < area_count; a++) {
+                bench_area_t *area = &areas[a];
+
+                bench_fill(src, frame_size, checks + 1);
+                memset(expected, 0xA5, frame_size);
+                memset(actual, 0xA5, frame_size);
+
+                reference_copy(expected, src, area->x_start, area->y_start, area->x_end, area->y_end,
+                               BENCH_WIDTH, BENCH_HEIGHT, bytes_per_pixel, rotations[r]);
+                pipeline(actual, src, area->x_start, area->y_start, area->x_end, area->y_end,
+                         BENCH_WIDTH, BENCH_HEIGHT, rotations[r]);
+
+                checks++;
+                if (memcmp(expected, actual, frame_size) != 0) {
+                    failures++;
+                    fprintf(stderr, "MISMATCH: %dbpp %d degrees area (%u, %u) - (%u, %u)\n",
+                            bytes_per_pixel * 8, rotation_degrees[r],
+                            area->x_start, area->y_start, area->x_end, area->y_end);
+                }
+            }
+        }
+    }
+
+    uint8_t *original = bench_alloc(frame_size);
+    uint16_t *ops_buf = bench_alloc(frame_size);
+
+    for (uint8_t ops = OP_SWAP; ops <= (OP_SWAP | OP_DITHER); ops++) {
+        lcd_pixel_pipeline_t pipeline = lcd_rotation_get_pipeline(2, ops & OP_SWAP, ops & OP_DITHER);
+
+        for (uint8_t r = 0; r < 4; r++) {
+            get_areas(rotations[r], areas, &area_count);
+
+            for (uint32_t a = 0; a < area_count; a++) {
+                bench_area_t *area = &areas[a];
+
+                bench_fill(src, frame_size, checks + 1);
+                memcpy(original, src, frame_size);
+                memset(expected, 0xA5, frame_size);
+                memset(actual, 0xA5, frame_size);
+
+                reference_ops(ops_buf, (uint16_t *)src, area->x_start, area->y_start, area->x_end, area->y_end, ops);
+                reference_copy(expected, (uint8_t *)ops_buf, area->x_start, area->y_start, area->x_end, area->y_end,
+                               BENCH_WIDTH, BENCH_HEIGHT, 2, rotations[r]);
+                pipeline(actual, src, area->x_start, area->y_start, area->x_end, area->y_end,
+                         BENCH_WIDTH, BENCH_HEIGHT, rotations[r]);
+
+                checks++;
+                if (memcmp(expected, actual, frame_size) != 0 || memcmp(src, original, frame_size) != 0) {
+                    failures++;
+                    fprintf(stderr, "MISMATCH: 16bpp%s%s %d degrees area (%u, %u) - (%u, %u)\n",
+                            (ops & OP_SWAP) ? " swap" : "", (ops & OP_DITHER) ? " dither" : "",
+                            rotation_degrees[r], area->x_start, area->y_start, area->x_end, area->y_end);
+                }
+            }
+        }
+    }
+
+    fprintf(out, "{\n  \"checks\": %u,\n  \"failures\": %u,\n  \"iterations\": %u,\n  \"timing\": [",
+            checks, failures, iterations);
+
+    bool first = true;
+    for (uint8_t bytes_per_pixel = 1; bytes_per_pixel <= 4; bytes_per_pixel++) {
+        lcd_pixel_pipeline_t pipeline = lcd_rotation_get_pipeline(bytes_per_pixel, false, false);
+
+        for (uint8_t r = 0; r < 4; r++) {
+            get_areas(rotations[r], areas, &area_count);
+            bench_area_t *area = &areas[0];
+
+            uint64_t start = bench_now_ns();
+            for (uint32_t i = 0; i < iterations; i++) {
+                reference_copy(actual, src, area->x_start, area->y_start, area->x_end, area->y_end,
+                               BENCH_WIDTH, BENCH_HEIGHT, bytes_per_pixel, rotations[r]);
+            }
+            double reference_ms = (double)(bench_now_ns() - start) / 1e6 / iterations;
+
+            start = bench_now_ns();
+            for (uint32_t i = 0; i < iterations; i++) {
+                pipeline(actual, src, area->x_start, area->y_start, area->x_end, area->y_end,
+                         BENCH_WIDTH, BENCH_HEIGHT, rotations[r]);
+            }
+            double tiled_ms = (double)(bench_now_ns() - start) / 1e6 / iterations;
+
+            fprintf(out, "%s\n    {\"bpp\": %d, \"rotation\": %d, \"per_pixel_ms\": %.3f, \"tiled_ms\": %.3f}",
+                    first ? "" : ",", bytes_per_pixel * 8, rotation_degrees[r], reference_ms, tiled_ms);
+            first = false;
+
+            printf("%2dbpp %3d degrees: per pixel %8.3f ms  tiled %8.3f ms\n",
+                   bytes_per_pixel * 8, rotation_degrees[r], reference_ms, tiled_ms);
+        }
+    }
+
+    // a full RGB565 frame, swap/dither/copy as separate passes and fused into one
+    fprintf(out, "\n  ],\n  \"fused\": [");
+
+    lcd_pixel_pipeline_t copy = lcd_rotation_get_pipeline(2, false, false);
+    first = true;
+
+    for (uint8_t ops = OP_SWAP; ops <= (OP_SWAP | OP_DITHER); ops++) {
+        lcd_pixel_pipeline_t pipeline = lcd_rotation_get_pipeline(2, ops & OP_SWAP, ops & OP_DITHER);
+
+        for (uint8_t r = 0; r < 4; r++) {
+            get_areas(rotations[r], areas, &area_count);
+            bench_area_t *area = &areas[0];
+            uint32_t pixel_count = BENCH_WIDTH * BENCH_HEIGHT;
+
+            bench_fill(src, frame_size, 1);
+            memcpy(original, src, frame_size);
+
+            uint64_t separate_bytes = 0;
+            uint64_t start = bench_now_ns();
+            for (uint32_t i = 0; i < iterations; i++) {
+                separate_bytes = separate_passes(actual, (uint16_t *)src, area->x_start, area->y_start,
+                                                 area->x_end, area->y_end, rotations[r], ops, copy);
+            }
+            double separate_ms = (double)(bench_now_ns() - start) / 1e6 / iterations;
+            size_t separate_changed = count_changed(src, original, pixel_count * 2);
+
+            memcpy(src, original, frame_size);
+
+            start = bench_now_ns();
+            for (uint32_t i = 0; i < iterations; i++) {
+                pipeline(actual, src, area->x_start, area->y_start, area->x_end, area->y_end,
+                         BENCH_WIDTH, BENCH_HEIGHT, rotations[r]);
+            }
+            double fused_ms = (double)(bench_now_ns() - start) / 1e6 / iterations;
+            size_t fused_changed = count_changed(src, original, pixel_count * 2);
+
+            // the pipeline reads each source pixel and writes each destination pixel once
+            uint64_t fused_bytes = (uint64_t)pixel_count * 4;
+
+            fprintf(out, "%s\n    {\"ops\": \"%s%s\", \"rotation\": %d, "
+                    "\"separate_ms\": %.3f, \"separate_bytes_touched\": %llu, \"separate_draw_buf_bytes_changed\": %zu, "
+                    "\"fused_ms\": %.3f, \"fused_bytes_touched\": %llu, \"fused_draw_buf_bytes_changed\": %zu}",
+                    first ? "" : ",", (ops & OP_SWAP) ? "swap" : "", ops == (OP_SWAP | OP_DITHER) ? "+dither" : ((ops & OP_DITHER) ? "dither" : ""),
+                    rotation_degrees[r], separate_ms, (unsigned long long)separate_bytes, separate_changed,
+                    fused_ms, (unsigned long long)fused_bytes, fused_changed);
+            first = false;
+
+            printf("16bpp%s%s %3d degrees: separate %8.3f ms %9llu bytes  fused %8.3f ms %9llu bytes\n",
+                   (ops & OP_SWAP) ? " swap" : "", (ops & OP_DITHER) ? " dither" : "", rotation_degrees[r],
+                   separate_ms, (unsigned long long)separate_bytes, fused_ms, (unsigned long long)fused_bytes);
+        }
+    }
+
+    fprintf(out, "\n  ]\n}\n");
+    if (out != stdout) fclose(out);
+
+    printf("%u of %u rotation checks passed\n", checks - failures, checks);
+
+    free(src);
+    free(expected);
+    free(actual);
+    free(original);
+    free(ops_buf);
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,294 @@
+// Copyright (c) 2024 - 2025 Kevin G. Schlosser
+
+// local includes
+#include "lcd_convert.h"
+
+// stdlib includes
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+
+// 8x8 Bayer matrix, values 0 - 63
+static const uint8_t bayer_8x8[8][8] = {
+    {  0, 32,  8, 40,  2, 34, 10, 42 },
+    { 48, 16, 56, 24, 50, 18, 58, 26 },
+    { 12, 44,  4, 36, 14, 46,  6, 38 },
+    { 60, 28, 52, 20, 62, 30, 54, 22 },
+    {  3, 35, 11, 43,  1, 33,  9, 41 },
+    { 51, 19, 59, 27, 49, 17, 57, 25 },
+    { 15, 47,  7, 39, 13, 45,  5, 37 },
+    { 63, 31, 55, 23, 61, 29, 53, 21 }
+};
+
+
+static inline int32_t convert_clamp(int32_t value)
+{
+    if (value < 0) return 0;
+    if (value > 255) return 255;
+    return value;
+}
+
+
+__attribute__((always_inline))
+static inline void store_pixel(uint16_t *to, uint8_t r5, uint8_t g6, uint8_t b5, bool byte_swap)
+{
+    uint16_t pixel = (uint16_t)((r5 << 11) | (g6 << 5) | b5);
+
+    if (byte_swap) pixel = (uint16_t)((pixel << 8) | (pixel >> 8));
+    *to = pixel;
+}
+
+
+/*
+LVGL stores RGB888 and XRGB8888 with blue in the lowest byte. The threshold
+from the Bayer matrix is scaled to the number of bits each channel loses,
+0 - 7 for the 5 bit channels and 0 - 3 for the 6 bit channel.
+*/
+__attribute__((always_inline))
+static inline void convert_ordered(uint16_t *dst, const uint8_t *src, uint32_t width, uint32_t height,
+                                   uint32_t x_start, uint32_t y_start, uint8_t src_bytes_per_pixel,
+                                   bool byte_swap)
+{
+    const uint8_t *row;
+    uint8_t threshold;
+
+    for (uint32_t y = 0; y < height; y++) {
+        row = bayer_8x8[(y_start + y) & 7];
+
+        for (uint32_t x = 0; x < width; x++) {
+            threshold = row[(x_start + x) & 7];
+
+            store_pixel(
+                dst,
+                (uint8_t)(convert_clamp(src[2] + (threshold >> 3)) >> 3),
+                (uint8_t)(convert_clamp(src[1] + (threshold >> 4)) >> 2),
+                (uint8_t)(convert_clamp(src[0] + (threshold >> 3)) >> 3),
+                byte_swap
+            );
+
+            src += src_bytes_per_pixel;
+            dst++;
+        }
+    }
+}
+
+
+/*
+Floyd-Steinberg. The error is kept in 1/16ths so it only gets divided once
+when it is added to a pixel. Each area starts with no error, LVGL has no
+requirement on the order areas are flushed in so there is nothing that can
+be carried over from the last one.
+*/
+__attribute__((always_inline))
+static inline void convert_error_diffusion(uint16_t *dst, const uint8_t *src, uint32_t width,
+                                           uint32_t height, uint8_t src_bytes_per_pixel,
+                                           bool byte_swap, int16_t *error_buf)
+{
+    uint32_t line_len = (width + 2) * 3;
+    int16_t *err_curr = error_buf;
+    int16_t *err_next = error_buf + line_len;
+    int16_t *err_temp;
+
+    int32_t value;
+    int32_t error;
+    uint8_t quant[3];
+    uint8_t shift;
+
+    memset(err_curr, 0, line_len * sizeof(int16_t));
+
+    for (uint32_t y = 0; y < height; y++) {
+        memset(err_next, 0, line_len * sizeof(int16_t));
+
+        for (uint32_t x = 0; x < width; x++) {
+            // channel 0 is red, channel 2 is blue
+            for (uint8_t c = 0; c < 3; c++) {
+                shift = (c == 1) ? 2 : 3;
+
+                value = convert_clamp(src[2 - c] + ((err_curr[(x + 1) * 3 + c] + 8) >> 4));
+                quant[c] = (uint8_t)(value >> shift);
+
+                // what the panel will show for the packed value
+                if (shift == 3) error = value - ((quant[c] << 3) | (quant[c] >> 2));
+                else error = value - ((quant[c] << 2) | (quant[c] >> 4));
+
+                err_curr[(x + 2) * 3 + c] += (int16_t)(error * 7);
+                err_next[x * 3 + c] += (int16_t)(error * 3);
+                err_next[(x + 1) * 3 + c] += (int16_t)(error * 5);
+                err_next[(x + 2) * 3 + c] += (int16_t)error;
+            }
+
+            store_pixel(dst, quant[0], quant[1], quant[2], byte_swap);
+
+            src += src_bytes_per_pixel;
+            dst++;
+        }
+
+        err_temp = err_curr;
+        err_curr = err_next;
+        err_next = err_temp;
+    }
+}
+
+
+__attribute__((always_inline))
+static inline void convert_none(uint16_t *dst, const uint8_t *src, uint32_t pixel_count,
+                                uint8_t src_bytes_per_pixel, bool byte_swap)
+{
+    for (uint32_t i = 0; i < pixel_count; i++) {
+        store_pixel(dst, src[2] >> 3, src[1] >> 2, src[0] >> 3, byte_swap);
+        src += src_bytes_per_pixel;
+        dst++;
+    }
+}
+
+
+/*
+src_bytes_per_pixel and byte_swap are constants at each of the call sites
+below so the compiler builds a loop for each combination.
+*/
+__attribute__((always_inline))
+static inline void convert_area(uint16_t *dst, const uint8_t *src, uint32_t width, uint32_t height,
+                                uint32_t x_start, uint32_t y_start, uint8_t src_bytes_per_pixel,
+                                uint8_t dither, bool byte_swap, int16_t *error_buf)
+{
+    switch (dither) {
+        case LCD_DITHER_ORDERED:
+            convert_ordered(dst, src, width, height, x_start, y_start, src_bytes_per_pixel, byte_swap);
+            break;
+
+        case LCD_DITHER_ERROR_DIFFUSION:
+            if (error_buf != NULL) {
+                convert_error_diffusion(dst, src, width, height, src_bytes_per_pixel, byte_swap, error_buf);
+                break;
+            }
+            // fall through
+        default:
+            convert_none(dst, src, width * height, src_bytes_per_pixel, byte_swap);
+            break;
+    }
+}
+
+
+void lcd_convert_to_rgb565(uint16_t *dst, const uint8_t *src, uint32_t width, uint32_t height,
+                           uint32_t x_start, uint32_t y_start, uint8_t src_bytes_per_pixel,
+                           uint8_t dither, bool byte_swap, int16_t *error_buf)
+{
+    if (src_bytes_per_pixel == 4) {
+        if (byte_swap) convert_area(dst, src, width, height, x_start, y_start, 4, dither, true, error_buf);
+        else convert_area(dst, src, width, height, x_start, y_start, 4, dither, false, error_buf);
+    } else {
+        if (byte_swap) convert_area(dst, src, width, height, x_start, y_start, 3, dither, true, error_buf);
+        else convert_area(dst, src, width, height, x_start, y_start, 3, dither, false, error_buf);
+    }
+}
+
+
+/*
+Converting from RGB565 to a wire format is driven by a table of lookup tables
+for each of the channels. Adding a format only needs a new entry.
+*/
+
+// 5 bit channel scaled to 8 bits
+static const uint8_t expand_5_to_8[32] = {
+    0x00, 0x08, 0x10, 0x18, 0x21, 0x29, 0x31, 0x39, 0x42, 0x4A, 0x52, 0x5A, 0x63, 0x6B, 0x73, 0x7B,
+    0x84, 0x8C, 0x94, 0x9C, 0xA5, 0xAD, 0xB5, 0xBD, 0xC6, 0xCE, 0xD6, 0xDE, 0xE7, 0xEF, 0xF7, 0xFF
+};
+
+
+// 6 bit channel scaled to 8 bits
+static const uint8_t expand_6_to_8[64] = {
+    0x00, 0x04, 0x08, 0x0C, 0x10, 0x14, 0x18, 0x1C, 0x20, 0x24, 0x28, 0x2C, 0x30, 0x34, 0x38, 0x3C,
+    0x41, 0x45, 0x49, 0x4D, 0x51, 0x55, 0x59, 0x5D, 0x61, 0x65, 0x69, 0x6D, 0x71, 0x75, 0x79, 0x7D,
+    0x82, 0x86, 0x8A, 0x8E, 0x92, 0x96, 0x9A, 0x9E, 0xA2, 0xA6, 0xAA, 0xAE, 0xB2, 0xB6, 0xBA, 0xBE,
+    0xC3, 0xC7, 0xCB, 0xCF, 0xD3, 0xD7, 0xDB, 0xDF, 0xE3, 0xE7, 0xEB, 0xEF, 0xF3, 0xF7, 0xFB, 0xFF
+};
+
+
+// 5 bit channel scaled to 6 bits, RGB666 uses the upper 6 bits of each byte
+static const uint8_t expand_5_to_6[32] = {
+    0x00, 0x08, 0x10, 0x18, 0x20, 0x28, 0x30, 0x38, 0x40, 0x48, 0x50, 0x58, 0x60, 0x68, 0x70, 0x78,
+    0x84, 0x8C, 0x94, 0x9C, 0xA4, 0xAC, 0xB4, 0xBC, 0xC4, 0xCC, 0xD4, 0xDC, 0xE4, 0xEC, 0xF4, 0xFC
+};
+
+
+// 6 bit channel in the upper 6 bits
+static const uint8_t expand_6_to_6[64] = {
+    0x00, 0x04, 0x08, 0x0C, 0x10, 0x14, 0x18, 0x1C, 0x20, 0x24, 0x28, 0x2C, 0x30, 0x34, 0x38, 0x3C,
+    0x40, 0x44, 0x48, 0x4C, 0x50, 0x54, 0x58, 0x5C, 0x60, 0x64, 0x68, 0x6C, 0x70, 0x74, 0x78, 0x7C,
+    0x80, 0x84, 0x88, 0x8C, 0x90, 0x94, 0x98, 0x9C, 0xA0, 0xA4, 0xA8, 0xAC, 0xB0, 0xB4, 0xB8, 0xBC,
+    0xC0, 0xC4, 0xC8, 0xCC, 0xD0, 0xD4, 0xD8, 0xDC, 0xE0, 0xE4, 0xE8, 0xEC, 0xF0, 0xF4, 0xF8, 0xFC
+};
+
+
+typedef struct _wire_format_t {
+    uint8_t bytes_per_pixel;
+    bool bgr;
+    const uint8_t *red;
+    const uint8_t *green;
+    const uint8_t *blue;
+} wire_format_t;
+
+
+static const wire_format_t wire_formats[] = {
+    [LCD_WIRE_RGB565] = { 2, false, NULL,          NULL,          NULL          },
+    [LCD_WIRE_BGR565] = { 2, true,  NULL,          NULL,          NULL          },
+    [LCD_WIRE_RGB666] = { 3, false, expand_5_to_6, expand_6_to_6, expand_5_to_6 },
+    [LCD_WIRE_BGR666] = { 3, true,  expand_5_to_6, expand_6_to_6, expand_5_to_6 },
+    [LCD_WIRE_RGB888] = { 3, false, expand_5_to_8, expand_6_to_8, expand_5_to_8 },
+    [LCD_WIRE_BGR888] = { 3, true,  expand_5_to_8, expand_6_to_8, expand_5_to_8 },
+};
+
+
+uint8_t lcd_convert_wire_bytes_per_pixel(uint8_t format)
+{
+    if (format > LCD_WIRE_BGR888) return 2;
+    return wire_formats[format].bytes_per_pixel;
+}
+
+
+__attribute__((always_inline))
+static inline void expand_pixels(uint8_t *dst, const uint16_t *src, uint32_t pixel_count,
+                                 const wire_format_t *wire, bool bgr)
+{
+    uint16_t pixel;
+
+    for (uint32_t i = 0; i < pixel_count; i++) {
+        pixel = src[i];
+
+        if (bgr) {
+            dst[0] = wire->blue[pixel & 0x1F];
+            dst[1] = wire->green[(pixel >> 5) & 0x3F];
+            dst[2] = wire->red[pixel >> 11];
+        } else {
+            dst[0] = wire->red[pixel >> 11];
+            dst[1] = wire->green[(pixel >> 5) & 0x3F];
+            dst[2] = wire->blue[pixel & 0x1F];
+        }
+        dst += 3;
+    }
+}
+
+
+void lcd_convert_to_wire(uint8_t *dst, const uint16_t *src, uint32_t pixel_count, uint8_t format)
+{
+    const wire_format_t *wire = &wire_formats[format];
+
+    if (wire->bytes_per_pixel != 3) return;
+
+    if (wire->bgr) expand_pixels(dst, src, pixel_count, wire, true);
+    else expand_pixels(dst, src, pixel_count, wire, false);
+}
+
+
+void lcd_convert_bgr565(uint16_t *dst, const uint16_t *src, uint32_t pixel_count, bool byte_swap)
+{
+    uint16_t pixel;
+
+    for (uint32_t i = 0; i < pixel_count; i++) {
+        pixel = src[i];
+        pixel = (uint16_t)(((pixel & 0x1F) << 11) | (pixel & 0x07E0) | (pixel >> 11));
+        if (byte_swap) pixel = (uint16_t)((pixel << 8) | (pixel >> 8));
+        dst[i] = pixel;
+    }
+}
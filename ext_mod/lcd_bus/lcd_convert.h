@@ -0,0 +1,73 @@
+// Copyright (c) 2024 - 2025 Kevin G. Schlosser
+
+#ifndef _LCD_CONVERT_H_
+    #define _LCD_CONVERT_H_
+
+    #include <stdint.h>
+    #include <stdbool.h>
+
+    #define LCD_DITHER_NONE             (0)
+    #define LCD_DITHER_ORDERED          (1)
+    #define LCD_DITHER_ERROR_DIFFUSION  (2)
+
+    /*
+    Number of int16_t's the error diffusion dither needs for an area that is
+    width pixels wide. 2 lines of 3 channels with a pixel of padding on each
+    side so the edges don't need to be special cased.
+    */
+    #define LCD_CONVERT_ERROR_BUF_LEN(width)  (((width) + 2) * 3 * 2)
+
+    /*
+    Converts an area rendered in RGB888 (src_bytes_per_pixel = 3) or XRGB8888
+    (src_bytes_per_pixel = 4) into RGB565. The dithering is done on the 8 bit
+    channels while they are being packed so the precision that gets thrown
+    away is what gets spread out.
+
+    dst is allowed to be the same buffer as src. Each output pixel is smaller
+    than the input pixel so the writes always stay behind the reads.
+
+    x_start and y_start are the location of the area on the display, the
+    ordered dither uses them so the pattern lines up across areas.
+
+    error_buf is only used by LCD_DITHER_ERROR_DIFFUSION and needs to hold
+    LCD_CONVERT_ERROR_BUF_LEN(width) int16_t's. It can be NULL otherwise.
+
+    This code has no dependencies on a port so it is able to be compiled and
+    tested on any platform.
+    */
+    void lcd_convert_to_rgb565(uint16_t *dst, const uint8_t *src, uint32_t width, uint32_t height,
+                               uint32_t x_start, uint32_t y_start, uint8_t src_bytes_per_pixel,
+                               uint8_t dither, bool byte_swap, int16_t *error_buf);
+
+    /*
+    Formats the panel is able to receive. LVGL renders in RGB565 and the
+    pixels are converted to one of these as they are sent.
+    */
+    #define LCD_WIRE_RGB565  (0)
+    #define LCD_WIRE_BGR565  (1)
+    #define LCD_WIRE_RGB666  (2)
+    #define LCD_WIRE_BGR666  (3)
+    #define LCD_WIRE_RGB888  (4)
+    #define LCD_WIRE_BGR888  (5)
+
+    // default size in bytes of each of the 2 bounce buffers used for the 3 byte formats
+    #ifndef LCD_WIRE_BOUNCE_SIZE
+        #define LCD_WIRE_BOUNCE_SIZE  (4095)
+    #endif
+
+    // returns 2 for the 16 bit formats and 3 for the 18 and 24 bit formats
+    uint8_t lcd_convert_wire_bytes_per_pixel(uint8_t format);
+
+    /*
+    Expands RGB565 pixels into one of the 3 byte wire formats. dst needs to
+    be large enough to hold pixel_count * 3 bytes and can't overlap src.
+    */
+    void lcd_convert_to_wire(uint8_t *dst, const uint16_t *src, uint32_t pixel_count, uint8_t format);
+
+    /*
+    Swaps red and blue, byte_swap does the RGB565 byte swap in the same pass.
+    dst is allowed to be the same buffer as src.
+    */
+    void lcd_convert_bgr565(uint16_t *dst, const uint16_t *src, uint32_t pixel_count, bool byte_swap);
+
+#endif /* _LCD_CONVERT_H_ */
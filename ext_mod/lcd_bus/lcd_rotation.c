@@ -0,0 +1,223 @@
+// Copyright (c) 2024 - 2025 Kevin G. Schlosser
+
+// local includes
+#include "lcd_rotation.h"
+#include "rgb565_dither.h"
+
+// stdlib includes
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+
+static inline uint32_t rotation_min(uint32_t a, uint32_t b)
+{
+    return a < b ? a : b;
+}
+
+
+#define PIXEL_OP_NONE    (0x00)
+#define PIXEL_OP_SWAP    (0x01)
+#define PIXEL_OP_DITHER  (0x02)
+
+
+/*
+bytes_per_pixel and ops are always constants at the call sites so the compiler
+is able to collapse the memcpy into a single load/store and drop the byte swap
+and dithering when they are not used. This gives us a dedicated loop for each
+combination without having to maintain a copy of the same code for each one.
+
+The dithering is done on a copy of the pixel. The source buffer is the buffer
+LVGL renders to and it should be handed back in the same state it was given
+to us in.
+*/
+__attribute__((always_inline))
+static inline void copy_pixel(uint8_t *from, uint8_t *to, uint8_t bytes_per_pixel,
+                              uint8_t ops, uint32_t x, uint32_t y)
+{
+    if (bytes_per_pixel == 2 && ops != PIXEL_OP_NONE) {
+        uint16_t pixel = *(uint16_t *)from;
+
+        if (ops & PIXEL_OP_DITHER) rgb565_dither_pixel(CALC_THRESHOLD(x, y), &pixel);
+        if (ops & PIXEL_OP_SWAP) pixel = (uint16_t)((pixel << 8) | (pixel >> 8));
+
+        *(uint16_t *)to = pixel;
+    } else {
+        memcpy(to, from, bytes_per_pixel);
+    }
+}
+
+
+__attribute__((always_inline))
+static inline void rotate0(uint8_t *src, uint8_t *dst, uint32_t x_start, uint32_t y_start,
+                           uint32_t x_end, uint32_t y_end, uint32_t dst_width,
+                           uint8_t bytes_per_pixel, uint8_t ops)
+{
+    uint32_t src_bytes_per_line = (x_end - x_start + 1) * bytes_per_pixel;
+    uint32_t dst_bytes_per_line = dst_width * bytes_per_pixel;
+
+    dst += (y_start * dst_width + x_start) * bytes_per_pixel;
+
+    if (ops == PIXEL_OP_NONE || bytes_per_pixel != 2) {
+        if (src_bytes_per_line == dst_bytes_per_line) {
+            memcpy(dst, src, src_bytes_per_line * (y_end - y_start + 1));
+        } else {
+            for (uint32_t y = y_start; y <= y_end; y++) {
+                memcpy(dst, src, src_bytes_per_line);
+                dst += dst_bytes_per_line;
+                src += src_bytes_per_line;
+            }
+        }
+    } else {
+        for (uint32_t y = y_start; y <= y_end; y++) {
+            for (uint32_t x = x_start; x <= x_end; x++) {
+                copy_pixel(src + (x - x_start) * 2, dst + (x - x_start) * 2, 2, ops, x, y);
+            }
+            dst += dst_bytes_per_line;
+            src += src_bytes_per_line;
+        }
+    }
+}
+
+
+// MIRROR_X MIRROR_Y
+__attribute__((always_inline))
+static inline void rotate180(uint8_t *src, uint8_t *dst, uint32_t x_start, uint32_t y_start,
+                             uint32_t x_end, uint32_t y_end, uint32_t dst_width, uint32_t dst_height,
+                             uint8_t bytes_per_pixel, uint8_t ops)
+{
+    uint8_t *to;
+
+    for (uint32_t y = y_start; y < y_end; y++) {
+        to = dst + ((dst_height - 1 - y) * dst_width + (dst_width - 1 - x_start)) * bytes_per_pixel;
+        for (uint32_t x = x_start; x < x_end; x++) {
+            copy_pixel(src, to, bytes_per_pixel, ops, x, y);
+            src += bytes_per_pixel;
+            to -= bytes_per_pixel;
+        }
+        src += bytes_per_pixel;
+    }
+}
+
+
+/*
+90 degrees:  SWAP_XY  MIRROR_Y
+270 degrees: SWAP_XY  MIRROR_X
+
+A column in the source becomes a line in the destination. Walking the source
+one pixel at a time means every write lands a full frame buffer line away from
+the last one and each of those writes pulls in a new cache line. The area is
+instead broken into LCD_ROTATION_TILE_SIZE x LCD_ROTATION_TILE_SIZE blocks.
+The block is walked column by column, the reads stay inside of the handful of
+source lines that make up the block and the writes are sequential in the
+destination.
+*/
+__attribute__((always_inline))
+static inline void rotate90_270(uint8_t *src, uint8_t *dst, uint32_t x_start, uint32_t y_start,
+                                uint32_t x_end, uint32_t y_end, uint32_t dst_width, uint32_t dst_height,
+                                uint8_t rotate, uint8_t bytes_per_pixel, uint8_t ops)
+{
+    uint32_t src_bytes_per_line = (x_end - x_start + 1) * bytes_per_pixel;
+    int32_t dst_step = (rotate == LCD_ROTATION_90) ? bytes_per_pixel : -bytes_per_pixel;
+
+    uint32_t tile_x_end;
+    uint32_t tile_y_end;
+    uint8_t *from;
+    uint8_t *to;
+
+    for (uint32_t tile_y = y_start; tile_y < y_end; tile_y += LCD_ROTATION_TILE_SIZE) {
+        tile_y_end = rotation_min(tile_y + LCD_ROTATION_TILE_SIZE, y_end);
+
+        for (uint32_t tile_x = x_start; tile_x < x_end; tile_x += LCD_ROTATION_TILE_SIZE) {
+            tile_x_end = rotation_min(tile_x + LCD_ROTATION_TILE_SIZE, x_end);
+
+            for (uint32_t x = tile_x; x < tile_x_end; x++) {
+                from = src + (tile_y - y_start) * src_bytes_per_line + (x - x_start) * bytes_per_pixel;
+
+                if (rotate == LCD_ROTATION_90) {
+                    to = dst + ((dst_height - 1 - x) * dst_width + tile_y) * bytes_per_pixel;
+                } else {
+                    to = dst + (x * dst_width + dst_width - 1 - tile_y) * bytes_per_pixel;
+                }
+
+                for (uint32_t y = tile_y; y < tile_y_end; y++) {
+                    copy_pixel(from, to, bytes_per_pixel, ops, x, y);
+                    from += src_bytes_per_line;
+                    to += dst_step;
+                }
+            }
+        }
+    }
+}
+
+
+__attribute__((always_inline))
+static inline void copy_area(uint8_t *src, uint8_t *dst, uint32_t x_start, uint32_t y_start,
+                             uint32_t x_end, uint32_t y_end, uint32_t dst_width, uint32_t dst_height,
+                             uint8_t rotate, uint8_t bytes_per_pixel, uint8_t ops)
+{
+    switch (rotate) {
+        case LCD_ROTATION_0:
+            rotate0(src, dst, rotation_min(x_start, dst_width - 1), rotation_min(y_start, dst_height - 1),
+                    rotation_min(x_end, dst_width - 1), rotation_min(y_end, dst_height - 1),
+                    dst_width, bytes_per_pixel, ops);
+            break;
+
+        case LCD_ROTATION_90:
+        case LCD_ROTATION_270:
+            y_end += 1; // removes black lines between blocks
+            rotate90_270(src, dst, rotation_min(x_start, dst_height), rotation_min(y_start, dst_width),
+                         rotation_min(x_end, dst_height), rotation_min(y_end, dst_width),
+                         dst_width, dst_height, rotate, bytes_per_pixel, ops);
+            break;
+
+        case LCD_ROTATION_180:
+            y_end += 1; // removes black lines between blocks
+            rotate180(src, dst, rotation_min(x_start, dst_width), rotation_min(y_start, dst_height),
+                      rotation_min(x_end, dst_width), rotation_min(y_end, dst_height),
+                      dst_width, dst_height, bytes_per_pixel, ops);
+            break;
+
+        default:
+            break;
+    }
+}
+
+
+#define LCD_PIXEL_PIPELINE(name, bytes_per_pixel, ops)                                                      \
+    static void name(void *dst, void *src, uint32_t x_start, uint32_t y_start,                             \
+                     uint32_t x_end, uint32_t y_end, uint32_t dst_width, uint32_t dst_height,              \
+                     uint8_t rotate)                                                                        \
+    {                                                                                                       \
+        copy_area((uint8_t *)src, (uint8_t *)dst, x_start, y_start, x_end, y_end,                          \
+                  dst_width, dst_height, rotate, bytes_per_pixel, ops);                                     \
+    }
+
+LCD_PIXEL_PIPELINE(pipeline_8bpp,              1, PIXEL_OP_NONE)
+LCD_PIXEL_PIPELINE(pipeline_16bpp,             2, PIXEL_OP_NONE)
+LCD_PIXEL_PIPELINE(pipeline_16bpp_swap,        2, PIXEL_OP_SWAP)
+LCD_PIXEL_PIPELINE(pipeline_16bpp_dither,      2, PIXEL_OP_DITHER)
+LCD_PIXEL_PIPELINE(pipeline_16bpp_dither_swap, 2, PIXEL_OP_DITHER | PIXEL_OP_SWAP)
+LCD_PIXEL_PIPELINE(pipeline_24bpp,             3, PIXEL_OP_NONE)
+LCD_PIXEL_PIPELINE(pipeline_32bpp,             4, PIXEL_OP_NONE)
+
+
+lcd_pixel_pipeline_t lcd_rotation_get_pipeline(uint8_t bytes_per_pixel, bool rgb565_byte_swap, bool rgb565_dither)
+{
+    switch (bytes_per_pixel) {
+        case 1:
+            return &pipeline_8bpp;
+
+        case 2:
+            if (rgb565_dither && rgb565_byte_swap) return &pipeline_16bpp_dither_swap;
+            if (rgb565_dither) return &pipeline_16bpp_dither;
+            if (rgb565_byte_swap) return &pipeline_16bpp_swap;
+            return &pipeline_16bpp;
+
+        case 3:
+            return &pipeline_24bpp;
+
+        default:
+            return &pipeline_32bpp;
+    }
+}
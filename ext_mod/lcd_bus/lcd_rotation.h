@@ -0,0 +1,47 @@
+// Copyright (c) 2024 - 2025 Kevin G. Schlosser
+
+#ifndef _LCD_ROTATION_H_
+    #define _LCD_ROTATION_H_
+
+    #include <stdint.h>
+    #include <stdbool.h>
+
+    #define LCD_ROTATION_0    (0)
+    #define LCD_ROTATION_90   (1)
+    #define LCD_ROTATION_180  (2)
+    #define LCD_ROTATION_270  (3)
+
+    /*
+    Width and height (in pixels) of the blocks the 90 and 270 degree rotations
+    are broken into. The source lines a block reads from and the destination
+    lines it writes to both need to stay in the cache for the duration of the
+    block, 16 lines of a 800 pixel wide 16bpp frame buffer is 25K.
+    */
+    #ifndef LCD_ROTATION_TILE_SIZE
+        #define LCD_ROTATION_TILE_SIZE  (16)
+    #endif
+
+    /*
+    Copies a rendered area into a frame buffer that is dst_width x dst_height
+    pixels, rotating it on the way. Byte swapping and dithering of RGB565
+    pixels is done in the same pass so every pixel in the source is read a
+    single time and every pixel in the destination is written a single time.
+    The source buffer is never modified.
+
+    This code has no dependencies on a port so it is able to be compiled and
+    tested on any platform.
+    */
+    typedef void (*lcd_pixel_pipeline_t)(void *dst, void *src, uint32_t x_start, uint32_t y_start,
+                        uint32_t x_end, uint32_t y_end, uint32_t dst_width, uint32_t dst_height,
+                        uint8_t rotate);
+
+    /*
+    Returns the pipeline that matches the color depth and the options the bus
+    was initilized with. This only needs to be done once when the bus gets
+    initilized. rgb565_byte_swap and rgb565_dither are ignored if
+    bytes_per_pixel is not 2. rgb565_dither_init() must have been called
+    before a dithering pipeline gets used.
+    */
+    lcd_pixel_pipeline_t lcd_rotation_get_pipeline(uint8_t bytes_per_pixel, bool rgb565_byte_swap, bool rgb565_dither);
+
+#endif /* _LCD_ROTATION_H_ */
@@ -2,6 +2,8 @@
 
 //local includes
 #include "lcd_types.h"
+#include "lcd_convert.h"
+#include "lv_mp_profiler.h"
 
 // micropython includes
 #include "py/obj.h"
@@ -9,6 +11,13 @@
 #include "py/objarray.h"
 #include "py/binary.h"
 
+// stdlib includes
+#include <string.h>
+
+#ifdef ESP_IDF_VERSION
+    #include "esp_heap_caps.h"
+#endif
+
 void rgb565_byte_swap(void *buf, uint32_t buf_size_px)
 {
     uint16_t *buf16 = (uint16_t *)buf;
@@ -21,6 +30,103 @@ void rgb565_byte_swap(void *buf, uint32_t buf_size_px)
 }
 
 
+/*
+Converts the buffer into the bus's own RGB565 buffer, color and color_size
+get updated to point to the converted data. The buffer LVGL rendered to is
+not changed so it is still good if LVGL reads it back. The byte swap is
+done as part of the conversion so it doesn't need to be done again after.
+*/
+mp_lcd_err_t lcd_panel_io_convert_rgb565(mp_obj_t obj, void **color, size_t *color_size, int x_start, int y_start, int x_end, int y_end, bool byte_swap)
+{
+    mp_lcd_bus_obj_t *self = (mp_lcd_bus_obj_t *)obj;
+    lcd_rgb565_convert_t *convert = &self->panel_io_handle.rgb565_convert;
+
+    if (x_end < x_start) return LCD_ERR_INVALID_SIZE;
+    if (convert->buf == NULL) return LCD_ERR_INVALID_STATE;
+
+    uint32_t width = (uint32_t)(x_end - x_start + 1);
+    uint32_t height = (uint32_t)(*color_size / convert->src_bytes_per_pixel / width);
+
+    if (height == 0 || width * height * 2 > convert->buf_size) return LCD_ERR_INVALID_SIZE;
+
+    int16_t *error_buf = NULL;
+    if (convert->dither == LCD_DITHER_ERROR_DIFFUSION) {
+        if (convert->error_buf_len < LCD_CONVERT_ERROR_BUF_LEN(width)) return LCD_ERR_INVALID_SIZE;
+        error_buf = convert->error_buf;
+    }
+
+    lcd_convert_to_rgb565(
+        convert->buf, (const uint8_t *)*color, width, height, (uint32_t)x_start, (uint32_t)y_start,
+        convert->src_bytes_per_pixel, convert->dither, byte_swap, error_buf
+    );
+
+    *color = convert->buf;
+    *color_size = width * height * 2;
+    return LCD_OK;
+}
+
+
+void lcd_panel_io_free_convert_bufs(lcd_rgb565_convert_t *convert)
+{
+    if (convert->buf != NULL) {
+    #ifdef ESP_IDF_VERSION
+        heap_caps_free(convert->buf);
+    #else
+        m_free(convert->buf);
+    #endif
+        convert->buf = NULL;
+    }
+    convert->buf_size = 0;
+
+    if (convert->error_buf != NULL) {
+        m_free(convert->error_buf);
+        convert->error_buf = NULL;
+    }
+    convert->error_buf_len = 0;
+}
+
+
+/*
+Called from init once the size of the display and the buffers LVGL renders
+to are known. The RGB565 buffer holds a whole draw buffer after it has been
+converted, without a conversion it is the same size as the draw buffer and
+is used for BGR565. The error diffusion buffer is made for the widest area
+there is able to be, which is the longest side of the display when it is
+rotated.
+*/
+static mp_lcd_err_t lcd_panel_io_alloc_convert_bufs(lcd_rgb565_convert_t *convert, uint16_t width, uint16_t height, uint32_t buffer_size)
+{
+    lcd_panel_io_free_convert_bufs(convert);
+
+    uint32_t buf_size = buffer_size;
+    if (convert->src_bytes_per_pixel != 0) buf_size = buffer_size / convert->src_bytes_per_pixel * 2;
+
+#ifdef ESP_IDF_VERSION
+    convert->buf = heap_caps_malloc(buf_size, MALLOC_CAP_DMA);
+#else
+    convert->buf = m_malloc_maybe(buf_size);
+#endif
+    if (convert->buf == NULL) return LCD_ERR_NO_MEM;
+    convert->buf_size = buf_size;
+
+    if (convert->src_bytes_per_pixel != 0 && convert->dither == LCD_DITHER_ERROR_DIFFUSION) {
+        uint32_t error_buf_len = LCD_CONVERT_ERROR_BUF_LEN(width > height ? width : height);
+
+        convert->error_buf = m_malloc_maybe(error_buf_len * sizeof(int16_t));
+        if (convert->error_buf == NULL) {
+            lcd_panel_io_free_convert_bufs(convert);
+            return LCD_ERR_NO_MEM;
+        }
+        convert->error_buf_len = error_buf_len;
+    }
+
+    return LCD_OK;
+}
+
+
+static mp_lcd_err_t lcd_panel_io_tx_color_raw(mp_obj_t obj, int lcd_cmd, void *color, size_t color_size, int x_start, int y_start, int x_end, int y_end, uint8_t rotation, bool last_update);
+
+
 #ifdef ESP_IDF_VERSION
     // esp-idf includes
     #include "esp_lcd_panel_io.h"
@@ -31,6 +137,7 @@ void rgb565_byte_swap(void *buf, uint32_t buf_size_px)
     #include "freertos/task.h"
     #include "esp_system.h"
     #include "esp_cpu.h"
+    #include "esp_timer.h"
 
     // micropy includes
     #include "py/gc.h"
@@ -83,16 +190,38 @@ void rgb565_byte_swap(void *buf, uint32_t buf_size_px)
         mp_hal_wake_main_task_from_isr();
     }
 
+    // safe to call from an ISR
+    uint32_t lcd_panel_io_ticks_us(void)
+    {
+        return (uint32_t)esp_timer_get_time();
+    }
+
     // called when esp_lcd_panel_draw_bitmap is completed
     bool bus_trans_done_cb(esp_lcd_panel_io_handle_t panel_io, esp_lcd_panel_io_event_data_t *edata, void *user_ctx)
     {
         mp_lcd_bus_obj_t *self = (mp_lcd_bus_obj_t *)user_ctx;
+        lcd_wire_convert_t *wire = &self->panel_io_handle.wire_convert;
+        BaseType_t woken = pdFALSE;
+
+        // one of the chunks from the middle of an area that is being converted
+        if (wire->chunks_done != wire->chunks_sent) {
+            wire->chunks_done++;
+            xSemaphoreGiveFromISR(wire->done, &woken);
+            return woken == pdTRUE;
+        }
+
+        if (wire->final_pending) {
+            wire->final_pending = false;
+            xSemaphoreGiveFromISR(wire->done, &woken);
+        }
+
+        lcd_panel_io_stats_flush_done(&self->panel_io_handle.stats, self->panel_io_handle.stats.flush_start_us);
 
         if (self->callback != mp_const_none && mp_obj_is_callable(self->callback)) {
             cb_isr(self->callback);
         }
         self->trans_done = true;
-        return false;
+        return woken == pdTRUE;
     }
 
 
@@ -142,6 +271,9 @@ void rgb565_byte_swap(void *buf, uint32_t buf_size_px)
     {
         mp_lcd_bus_obj_t *self = (mp_lcd_bus_obj_t *)obj;
 
+        self->panel_io_handle.stats.tx_param_count++;
+        self->panel_io_handle.stats.param_bytes_sent += param_size;
+
         if (self->panel_io_handle.tx_param == NULL) {
             LCD_DEBUG_PRINT("lcd_panel_io_tx_param(self, lcd_cmd=%d, param, param_size=%d)\n", lcd_cmd, param_size)
             return esp_lcd_panel_io_tx_param(self->panel_io_handle.panel_io, lcd_cmd, param, param_size);
@@ -151,14 +283,10 @@ void rgb565_byte_swap(void *buf, uint32_t buf_size_px)
     }
 
 
-    mp_lcd_err_t lcd_panel_io_tx_color(mp_obj_t obj, int lcd_cmd, void *color, size_t color_size, int x_start, int y_start, int x_end, int y_end, uint8_t rotation, bool last_update)
+    static mp_lcd_err_t lcd_panel_io_tx_color_raw(mp_obj_t obj, int lcd_cmd, void *color, size_t color_size, int x_start, int y_start, int x_end, int y_end, uint8_t rotation, bool last_update)
     {
         mp_lcd_bus_obj_t *self = (mp_lcd_bus_obj_t *)obj;
 
-        if (self->rgb565_byte_swap) {
-            rgb565_byte_swap((uint16_t *)color, (uint32_t)(color_size / 2));
-        }
-
         if (self->panel_io_handle.tx_color == NULL) {
             LCD_UNUSED(x_start);
             LCD_UNUSED(y_start);
@@ -218,12 +346,31 @@ void rgb565_byte_swap(void *buf, uint32_t buf_size_px)
     }
 
 #else
+    // micropy includes
+    #include "py/mphal.h"
+
+    uint32_t lcd_panel_io_ticks_us(void)
+    {
+        return (uint32_t)mp_hal_ticks_us();
+    }
+
+
     bool bus_trans_done_cb(lcd_panel_io_t *panel_io, void *edata, void *user_ctx)
     {
         LCD_UNUSED(edata);
         LCD_UNUSED(panel_io);
 
         mp_lcd_bus_obj_t *self = (mp_lcd_bus_obj_t *)user_ctx;
+        lcd_wire_convert_t *wire = &self->panel_io_handle.wire_convert;
+
+        // one of the chunks from the middle of an area that is being converted
+        if (wire->chunks_done != wire->chunks_sent) {
+            wire->chunks_done++;
+            return false;
+        }
+        wire->final_pending = false;
+
+        lcd_panel_io_stats_flush_done(&self->panel_io_handle.stats, self->panel_io_handle.stats.flush_start_us);
 
         if (self->callback != mp_const_none && mp_obj_is_callable(self->callback)) {
             mp_call_function_n_kw(self->callback, 0, 0, NULL);
@@ -272,18 +419,17 @@ void rgb565_byte_swap(void *buf, uint32_t buf_size_px)
     {
         mp_lcd_bus_obj_t *self = (mp_lcd_bus_obj_t *)obj;
 
+        self->panel_io_handle.stats.tx_param_count++;
+        self->panel_io_handle.stats.param_bytes_sent += param_size;
+
         return self->panel_io_handle.tx_param(obj, lcd_cmd, param, param_size);
     }
 
 
-    mp_lcd_err_t lcd_panel_io_tx_color(mp_obj_t obj, int lcd_cmd, void *color, size_t color_size, int x_start, int y_start, int x_end, int y_end, uint8_t rotation, bool last_update)
+    static mp_lcd_err_t lcd_panel_io_tx_color_raw(mp_obj_t obj, int lcd_cmd, void *color, size_t color_size, int x_start, int y_start, int x_end, int y_end, uint8_t rotation, bool last_update)
     {
         mp_lcd_bus_obj_t *self = (mp_lcd_bus_obj_t *)obj;
 
-        if (self->rgb565_byte_swap) {
-            rgb565_byte_swap((uint16_t *)color, (uint32_t)(color_size / 2));
-        }
-
         return self->panel_io_handle.tx_color(obj, lcd_cmd, color, color_size, x_start, y_start, x_end, y_end, rotation, last_update);
     }
 
@@ -325,16 +471,322 @@ void rgb565_byte_swap(void *buf, uint32_t buf_size_px)
 #endif
 
 
+/*
+Called once the last of the data for an area has been sent. This can be
+called from an ISR so it only does integer math on the counters.
+*/
+void lcd_panel_io_stats_flush_done(lcd_bus_stats_t *stats, uint32_t start_us)
+{
+    uint32_t latency = lcd_panel_io_ticks_us() - start_us;
+    uint32_t bound = LCD_STATS_BUCKET_0_US;
+    uint8_t bucket = 0;
+
+    while (bucket < LCD_STATS_HISTOGRAM_BUCKETS - 1 && latency >= bound) {
+        bound <<= 1;
+        bucket++;
+    }
+
+    stats->histogram[bucket]++;
+    stats->flush_count++;
+    stats->latency_total_us += latency;
+    if (latency > stats->latency_max_us) stats->latency_max_us = latency;
+}
+
+
+/*
+Copies the part of an area that is on the screen into dst, a frame buffer
+that is width x height pixels. color is either only the area or a buffer
+that is the size of the screen (direct render mode), color_size is used to
+tell which one it is.
+*/
+mp_lcd_err_t lcd_panel_io_copy_area(uint8_t *dst, uint16_t width, uint16_t height, uint8_t bytes_per_pixel,
+                                    const void *color, size_t color_size, int x_start, int y_start, int x_end, int y_end)
+{
+    int area_width = x_end - x_start + 1;
+    int area_height = y_end - y_start + 1;
+
+    int x1 = MAX(x_start, 0);
+    int y1 = MAX(y_start, 0);
+    int x2 = MIN(x_end, (int)width - 1);
+    int y2 = MIN(y_end, (int)height - 1);
+
+    if (area_width <= 0 || area_height <= 0 || x2 < x1 || y2 < y1) return LCD_OK;
+
+    uint32_t dst_stride = (uint32_t)width * bytes_per_pixel;
+    uint32_t area_size = (uint32_t)area_width * (uint32_t)area_height * bytes_per_pixel;
+    uint32_t src_stride;
+    const uint8_t *src;
+
+    if (color_size != area_size && color_size >= dst_stride * height) {
+        src_stride = dst_stride;
+        src = (const uint8_t *)color + (uint32_t)y1 * src_stride + (uint32_t)x1 * bytes_per_pixel;
+    } else if (color_size >= area_size) {
+        src_stride = (uint32_t)area_width * bytes_per_pixel;
+        src = (const uint8_t *)color + (uint32_t)(y1 - y_start) * src_stride + (uint32_t)(x1 - x_start) * bytes_per_pixel;
+    } else {
+        return LCD_ERR_INVALID_SIZE;
+    }
+
+    dst += (uint32_t)y1 * dst_stride + (uint32_t)x1 * bytes_per_pixel;
+    uint32_t row_size = (uint32_t)(x2 - x1 + 1) * bytes_per_pixel;
+
+    // when LVGL renders right into dst there is nothing to copy
+    if (src == dst) return LCD_OK;
+
+    for (int y = y1; y <= y2; y++) {
+        memcpy(dst, src, row_size);
+        dst += dst_stride;
+        src += src_stride;
+    }
+
+    return LCD_OK;
+}
+
+
+static void lcd_panel_io_free_bounce_bufs(lcd_wire_convert_t *wire)
+{
+    for (uint8_t i = 0; i < 2; i++) {
+        if (wire->bounce_buf[i] == NULL) continue;
+
+    #ifdef ESP_IDF_VERSION
+        heap_caps_free(wire->bounce_buf[i]);
+    #else
+        m_free(wire->bounce_buf[i]);
+    #endif
+        wire->bounce_buf[i] = NULL;
+    }
+
+    wire->bounce_size = 0;
+}
+
+
+/*
+Waits for the bus to be done with the bounce buffers. When final is set it
+waits for the last chunk of the area to be sent, otherwise until one of the
+2 bounce buffers is free. LCD_ERR_TIMEOUT is returned if the transfer done
+callback doesn't come within LCD_WIRE_TIMEOUT_MS. Off of the ESP32 the 3
+byte formats are only able to be used with the SPI and I80 busses. Both of
+them send blocking and call bus_trans_done_cb before their tx_color returns
+so they never wait here.
+*/
+static mp_lcd_err_t lcd_panel_io_wire_wait(lcd_wire_convert_t *wire, bool final)
+{
+#ifndef ESP_IDF_VERSION
+    uint32_t start = lcd_panel_io_ticks_us();
+#endif
+
+    while (final ? wire->final_pending : wire->chunks_sent - wire->chunks_done > 1) {
+    #ifdef ESP_IDF_VERSION
+        if (xSemaphoreTake(wire->done, pdMS_TO_TICKS(LCD_WIRE_TIMEOUT_MS)) != pdTRUE) return LCD_ERR_TIMEOUT;
+    #else
+        if (lcd_panel_io_ticks_us() - start > LCD_WIRE_TIMEOUT_MS * 1000) return LCD_ERR_TIMEOUT;
+    #endif
+    }
+
+    return LCD_OK;
+}
+
+
+mp_lcd_err_t lcd_panel_io_set_wire_format(mp_obj_t obj, uint8_t format, uint32_t bounce_size)
+{
+    mp_lcd_bus_obj_t *self = (mp_lcd_bus_obj_t *)obj;
+    lcd_wire_convert_t *wire = &self->panel_io_handle.wire_convert;
+    lcd_rgb565_convert_t *convert = &self->panel_io_handle.rgb565_convert;
+
+#ifdef ESP_IDF_VERSION
+    if (wire->done == NULL) wire->done = xSemaphoreCreateBinaryStatic(&wire->done_buffer);
+#endif
+
+    // the last area might still be getting sent out of the bounce buffers
+    mp_lcd_err_t ret = lcd_panel_io_wire_wait(wire, true);
+    if (ret != LCD_OK) return ret;
+
+    lcd_panel_io_free_bounce_bufs(wire);
+
+    // without a conversion buf is only needed for BGR565. Before init it
+    // gets made by init once the size of the draw buffers is known
+    if (convert->src_bytes_per_pixel == 0) {
+        if (format != LCD_WIRE_BGR565) {
+            lcd_panel_io_free_convert_bufs(convert);
+        } else if (convert->buf == NULL && convert->buffer_size != 0) {
+            ret = lcd_panel_io_alloc_convert_bufs(convert, 0, 0, convert->buffer_size);
+            if (ret != LCD_OK) return ret;
+        }
+    }
+
+    wire->format = format;
+
+    if (lcd_convert_wire_bytes_per_pixel(format) == 2) return LCD_OK;
+
+    // has to hold a whole number of pixels
+    bounce_size -= bounce_size % 3;
+    if (bounce_size == 0) return LCD_ERR_INVALID_SIZE;
+
+    for (uint8_t i = 0; i < 2; i++) {
+    #ifdef ESP_IDF_VERSION
+        wire->bounce_buf[i] = heap_caps_malloc(bounce_size, MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+    #else
+        wire->bounce_buf[i] = m_malloc(bounce_size);
+    #endif
+        if (wire->bounce_buf[i] == NULL) {
+            lcd_panel_io_free_bounce_bufs(wire);
+            wire->format = LCD_WIRE_RGB565;
+            return LCD_ERR_NO_MEM;
+        }
+    }
+
+    wire->bounce_size = bounce_size;
+    return LCD_OK;
+}
+
+
+/*
+The area gets expanded into one bounce buffer while the bus is sending the
+other one. Only the first chunk sends the command, the rest of the chunks
+are a continuation of the same memory write.
+*/
+static mp_lcd_err_t lcd_panel_io_tx_color_wire(mp_obj_t obj, int lcd_cmd, void *color, size_t color_size, int x_start, int y_start, int x_end, int y_end, uint8_t rotation, bool last_update)
+{
+    mp_lcd_bus_obj_t *self = (mp_lcd_bus_obj_t *)obj;
+    lcd_wire_convert_t *wire = &self->panel_io_handle.wire_convert;
+
+    uint32_t pixels_left = (uint32_t)(color_size / 2);
+    uint32_t chunk_pixels = wire->bounce_size / 3;
+    uint32_t count;
+    uint16_t *src = (uint16_t *)color;
+    uint8_t *bounce_buf;
+    uint8_t index = 0;
+    mp_lcd_err_t ret;
+
+    if (chunk_pixels == 0) return LCD_ERR_INVALID_STATE;
+
+    lcd_bus_stats_t *stats = &self->panel_io_handle.stats;
+    uint32_t start;
+
+    if (wire->final_pending) {
+        start = lcd_panel_io_ticks_us();
+        ret = lcd_panel_io_wire_wait(wire, true);
+        stats->blocked_time_us += lcd_panel_io_ticks_us() - start;
+        if (ret != LCD_OK) return ret;
+    }
+
+    // flush_start_us can't be set until the last area has finished using it
+    stats->flush_start_us = lcd_panel_io_ticks_us();
+
+    while (pixels_left > 0) {
+        count = pixels_left < chunk_pixels ? pixels_left : chunk_pixels;
+        pixels_left -= count;
+        bounce_buf = wire->bounce_buf[index];
+
+        // wait for the chunk that was sent from this bounce buffer to finish
+        if (wire->chunks_sent - wire->chunks_done > 1) {
+            start = lcd_panel_io_ticks_us();
+            ret = lcd_panel_io_wire_wait(wire, false);
+            stats->blocked_time_us += lcd_panel_io_ticks_us() - start;
+            if (ret != LCD_OK) return ret;
+        }
+
+        lcd_convert_to_wire(bounce_buf, src, count, wire->format);
+        src += count;
+
+        // the completion of the last chunk is what gets reported to the user
+        if (pixels_left == 0) wire->final_pending = true;
+        else wire->chunks_sent++;
+
+        ret = lcd_panel_io_tx_color_raw(obj, lcd_cmd, bounce_buf, count * 3, x_start, y_start, x_end, y_end, rotation, last_update);
+
+        if (ret != LCD_OK) {
+            if (pixels_left == 0) wire->final_pending = false;
+            else wire->chunks_sent--;
+            return ret;
+        }
+
+        stats->bytes_sent += count * 3;
+        lcd_cmd = -1;
+        index ^= 1;
+    }
+
+    return LCD_OK;
+}
+
+
+mp_lcd_err_t lcd_panel_io_tx_color(mp_obj_t obj, int lcd_cmd, void *color, size_t color_size, int x_start, int y_start, int x_end, int y_end, uint8_t rotation, bool last_update)
+{
+    mp_lcd_bus_obj_t *self = (mp_lcd_bus_obj_t *)obj;
+    uint8_t wire_format = self->panel_io_handle.wire_convert.format;
+    lcd_bus_stats_t *stats = &self->panel_io_handle.stats;
+    mp_lcd_err_t ret;
+
+    LV_MP_PROFILER_BEGIN;
+
+    uint32_t start = lcd_panel_io_ticks_us();
+
+    stats->tx_color_count++;
+
+    // byte order only means something when it is RGB565 that gets sent
+    bool byte_swap = self->rgb565_byte_swap && wire_format <= LCD_WIRE_BGR565;
+
+    if (self->panel_io_handle.rgb565_convert.src_bytes_per_pixel != 0) {
+        ret = lcd_panel_io_convert_rgb565(
+            obj, &color, &color_size, x_start, y_start, x_end, y_end,
+            byte_swap && wire_format == LCD_WIRE_RGB565
+        );
+        if (ret != LCD_OK) {
+            LV_MP_PROFILER_END;
+            return ret;
+        }
+    } else if (byte_swap && wire_format == LCD_WIRE_RGB565) {
+        rgb565_byte_swap((uint16_t *)color, (uint32_t)(color_size / 2));
+    }
+
+    if (wire_format == LCD_WIRE_BGR565) {
+        // goes into the bus's buffer so LVGL's buffer doesn't get changed.
+        // color already is that buffer when it has been converted to RGB565
+        lcd_rgb565_convert_t *convert = &self->panel_io_handle.rgb565_convert;
+
+        if (convert->buf == NULL) {
+            LV_MP_PROFILER_END;
+            return LCD_ERR_INVALID_STATE;
+        }
+
+        if (color_size > convert->buf_size) {
+            LV_MP_PROFILER_END;
+            return LCD_ERR_INVALID_SIZE;
+        }
+
+        lcd_convert_bgr565(convert->buf, (const uint16_t *)color, (uint32_t)(color_size / 2), byte_swap);
+        color = convert->buf;
+    } else if (wire_format != LCD_WIRE_RGB565) {
+        ret = lcd_panel_io_tx_color_wire(obj, lcd_cmd, color, color_size, x_start, y_start, x_end, y_end, rotation, last_update);
+        LV_MP_PROFILER_END;
+        return ret;
+    }
+
+    stats->bytes_sent += color_size;
+    stats->flush_start_us = start;
+    ret = lcd_panel_io_tx_color_raw(obj, lcd_cmd, color, color_size, x_start, y_start, x_end, y_end, rotation, last_update);
+
+    LV_MP_PROFILER_END;
+    return ret;
+}
+
+
 mp_lcd_err_t lcd_panel_io_del(mp_obj_t obj)
 {
     mp_lcd_bus_obj_t *self = (mp_lcd_bus_obj_t *)obj;
+    mp_lcd_err_t ret = LCD_OK;
 
     if (self->panel_io_handle.del != NULL) {
-        return self->panel_io_handle.del(obj);
+        ret = self->panel_io_handle.del(obj);
     } else {
         LCD_DEBUG_PRINT("lcd_panel_io_del(self)\n")
-        return LCD_OK;
     }
+
+    lcd_panel_io_free_bounce_bufs(&self->panel_io_handle.wire_convert);
+    self->panel_io_handle.wire_convert.format = LCD_WIRE_RGB565;
+    lcd_panel_io_free_convert_bufs(&self->panel_io_handle.rgb565_convert);
+    self->panel_io_handle.rgb565_convert.buffer_size = 0;
+    return ret;
 }
 
 
@@ -342,6 +794,17 @@ mp_lcd_err_t lcd_panel_io_init(mp_obj_t obj, uint16_t width, uint16_t height, ui
 {
     mp_lcd_bus_obj_t *self = (mp_lcd_bus_obj_t *)obj;
 
+    lcd_rgb565_convert_t *convert = &self->panel_io_handle.rgb565_convert;
+    convert->buffer_size = buffer_size;
+
+    if (convert->src_bytes_per_pixel != 0 || self->panel_io_handle.wire_convert.format == LCD_WIRE_BGR565) {
+        mp_lcd_err_t ret = lcd_panel_io_alloc_convert_bufs(convert, width, height, buffer_size);
+        if (ret != LCD_OK) return ret;
+    }
+
+    // the bus only ever sees RGB565 when the buffers are being converted
+    if (convert->src_bytes_per_pixel != 0) bpp = 16;
+
     return self->panel_io_handle.init(obj, width, height, bpp, buffer_size, rgb565_byte_swap, cmd_bits, param_bits);
 }
 
@@ -10,8 +10,87 @@
     #include "py/runtime.h"
     #include "py/objarray.h"
 
+    #ifdef ESP_IDF_VERSION
+        // esp-idf includes
+        #include "freertos/FreeRTOS.h"
+        #include "freertos/semphr.h"
+    #endif
+
     typedef struct _lcd_panel_io_t lcd_panel_io_t;
 
+    /*
+    Set using set_rgb565_conversion. When src_bytes_per_pixel is not 0 the
+    buffers passed to tx_color are RGB888 or XRGB8888 and get converted to
+    RGB565 into buf before they are handed to the bus. LVGL's buffer is left
+    alone. buf and error_buf get allocated by init, nothing is allocated
+    while flushing.
+
+    buf is also where the BGR565 wire format puts the swapped pixels so that
+    LVGL's buffer doesn't get changed, it is made by init or by
+    set_wire_format if init has already been called. buffer_size is the size
+    of the buffers LVGL renders to, it is set by init.
+    */
+    typedef struct _lcd_rgb565_convert_t {
+        uint8_t src_bytes_per_pixel;
+        uint8_t dither;
+        uint16_t *buf;
+        uint32_t buf_size;
+        uint32_t buffer_size;
+        int16_t *error_buf;
+        uint32_t error_buf_len;
+    } lcd_rgb565_convert_t;
+
+    /*
+    Set using set_wire_format. The 3 byte formats are expanded from RGB565
+    into the bounce buffers a chunk at a time, one chunk gets converted while
+    the bus is sending the other one. chunks_sent is only changed by
+    tx_color and chunks_done is only changed by the transfer done callback.
+    On the ESP32 the transfer done callback gives the done semaphore so
+    tx_color is able to block on it instead of spinning.
+    */
+    #ifndef LCD_WIRE_TIMEOUT_MS
+        #define LCD_WIRE_TIMEOUT_MS  (1000)
+    #endif
+
+    typedef struct _lcd_wire_convert_t {
+        uint8_t format;
+        uint8_t *bounce_buf[2];
+        uint32_t bounce_size;
+        volatile uint32_t chunks_sent;
+        volatile uint32_t chunks_done;
+        volatile bool final_pending;
+    #ifdef ESP_IDF_VERSION
+        SemaphoreHandle_t done;
+        StaticSemaphore_t done_buffer;
+    #endif
+    } lcd_wire_convert_t;
+
+    /*
+    Performance counters returned by stats(). Nothing gets allocated, only
+    counters and time stamps are updated so they are able to be left on.
+    Latency is the time from tx_color being called to the transfer being
+    finished. The upper bound of histogram bucket 0 is LCD_STATS_BUCKET_0_US
+    and it doubles for each bucket after that, the last bucket holds
+    everything that is larger.
+    */
+    #define LCD_STATS_HISTOGRAM_BUCKETS  (12)
+    #define LCD_STATS_BUCKET_0_US        (125)
+
+    typedef struct _lcd_bus_stats_t {
+        uint64_t bytes_sent;
+        uint32_t tx_color_count;
+        uint32_t flush_count;
+        uint32_t tx_param_count;
+        uint64_t param_bytes_sent;
+        uint64_t blocked_time_us;
+        uint64_t copy_time_us;
+        uint32_t copy_count;
+        uint64_t latency_total_us;
+        uint32_t latency_max_us;
+        volatile uint32_t flush_start_us;
+        uint32_t histogram[LCD_STATS_HISTOGRAM_BUCKETS];
+    } lcd_bus_stats_t;
+
     #ifdef ESP_IDF_VERSION
         #include "sdkconfig.h"
 
@@ -25,6 +104,7 @@
         #define LCD_ERR_INVALID_STATE  0x103
         #define LCD_ERR_INVALID_SIZE   0x104
         #define LCD_ERR_NOT_SUPPORTED  0x106
+        #define LCD_ERR_TIMEOUT        0x107
 
         typedef int mp_lcd_err_t;
 
@@ -40,7 +120,8 @@
             LCD_ERR_INVALID_ARG = 0x102,
             LCD_ERR_INVALID_STATE = 0x103,
             LCD_ERR_INVALID_SIZE = 0x104,
-            LCD_ERR_NOT_SUPPORTED = 0x106
+            LCD_ERR_NOT_SUPPORTED = 0x106,
+            LCD_ERR_TIMEOUT = 0x107
         } mp_lcd_err_t;
 
         bool bus_trans_done_cb(lcd_panel_io_t *panel_io, void *edata, void *user_ctx);
@@ -65,6 +146,10 @@
     #ifdef ESP_IDF_VERSION
         esp_lcd_panel_io_handle_t panel_io;
     #endif
+
+        lcd_rgb565_convert_t rgb565_convert;
+        lcd_wire_convert_t wire_convert;
+        lcd_bus_stats_t stats;
     };
 
     // typedef struct lcd_panel_io_t *lcd_panel_io_handle_t; /*!< Type of LCD panel IO handle */
@@ -103,4 +188,13 @@
 
 
     void rgb565_byte_swap(void *buf, uint32_t buf_size_px);
+    mp_lcd_err_t lcd_panel_io_convert_rgb565(mp_obj_t obj, void **color, size_t *color_size, int x_start, int y_start, int x_end, int y_end, bool byte_swap);
+    void lcd_panel_io_free_convert_bufs(lcd_rgb565_convert_t *convert);
+    mp_lcd_err_t lcd_panel_io_set_wire_format(mp_obj_t obj, uint8_t format, uint32_t bounce_size);
+
+    uint32_t lcd_panel_io_ticks_us(void);
+    void lcd_panel_io_stats_flush_done(lcd_bus_stats_t *stats, uint32_t start_us);
+
+    mp_lcd_err_t lcd_panel_io_copy_area(uint8_t *dst, uint16_t width, uint16_t height, uint8_t bytes_per_pixel,
+                                        const void *color, size_t color_size, int x_start, int y_start, int x_end, int y_end);
 #endif /* _LCD_TYPES_H_ */
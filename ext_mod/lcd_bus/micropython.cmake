@@ -13,12 +13,14 @@ if(ESP_PLATFORM)
     set(LCD_SOURCES
         ${CMAKE_CURRENT_LIST_DIR}/modlcd_bus.c
         ${CMAKE_CURRENT_LIST_DIR}/lcd_types.c
+        ${CMAKE_CURRENT_LIST_DIR}/lcd_rotation.c
+        ${CMAKE_CURRENT_LIST_DIR}/lcd_convert.c
+        ${CMAKE_CURRENT_LIST_DIR}/rgb565_dither.c
         ${CMAKE_CURRENT_LIST_DIR}/esp32_src/i2c_bus.c
         ${CMAKE_CURRENT_LIST_DIR}/esp32_src/spi_bus.c
         ${CMAKE_CURRENT_LIST_DIR}/esp32_src/i80_bus.c
         ${CMAKE_CURRENT_LIST_DIR}/esp32_src/rgb_bus.c
         ${CMAKE_CURRENT_LIST_DIR}/esp32_src/rgb_bus_rotation.c
-        ${CMAKE_CURRENT_LIST_DIR}/esp32_src/rgb565_dither.c
     )
 
     # gets esp_lcd include paths
@@ -40,11 +42,16 @@ else()
 
     set(LCD_SOURCES
         ${CMAKE_CURRENT_LIST_DIR}/lcd_types.c
+        ${CMAKE_CURRENT_LIST_DIR}/lcd_rotation.c
+        ${CMAKE_CURRENT_LIST_DIR}/lcd_convert.c
+        ${CMAKE_CURRENT_LIST_DIR}/rgb565_dither.c
         ${CMAKE_CURRENT_LIST_DIR}/modlcd_bus.c
         ${CMAKE_CURRENT_LIST_DIR}/common_src/i2c_bus.c
         ${CMAKE_CURRENT_LIST_DIR}/common_src/spi_bus.c
         ${CMAKE_CURRENT_LIST_DIR}/common_src/i80_bus.c
         ${CMAKE_CURRENT_LIST_DIR}/common_src/rgb_bus.c
+        ${CMAKE_CURRENT_LIST_DIR}/common_src/memory_bus.c
+        ${CMAKE_CURRENT_LIST_DIR}/common_src/fbdev_bus.c
         ${CMAKE_CURRENT_LIST_DIR}/sdl_bus/sdl_bus.c
     )
 
@@ -16,10 +16,15 @@ endif
 
 SRC_USERMOD_C += $(MOD_DIR)/modlcd_bus.c
 SRC_USERMOD_C += $(MOD_DIR)/lcd_types.c
+SRC_USERMOD_C += $(MOD_DIR)/lcd_rotation.c
+SRC_USERMOD_C += $(MOD_DIR)/lcd_convert.c
+SRC_USERMOD_C += $(MOD_DIR)/rgb565_dither.c
 SRC_USERMOD_C += $(MOD_DIR)/common_src/i2c_bus.c
 SRC_USERMOD_C += $(MOD_DIR)/common_src/i80_bus.c
 SRC_USERMOD_C += $(MOD_DIR)/common_src/spi_bus.c
 SRC_USERMOD_C += $(MOD_DIR)/common_src/rgb_bus.c
+SRC_USERMOD_C += $(MOD_DIR)/common_src/memory_bus.c
+SRC_USERMOD_C += $(MOD_DIR)/common_src/fbdev_bus.c
 SRC_USERMOD_C += $(MOD_DIR)/sdl_bus/sdl_bus.c
 
 ifneq (,$(findstring unix, $(LV_PORT)))
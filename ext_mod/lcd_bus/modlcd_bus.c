@@ -2,12 +2,18 @@
 
 // local includes
 #include "modlcd_bus.h"
+#include "lcd_convert.h"
 #include "spi_bus.h"
 #include "i2c_bus.h"
 #include "i80_bus.h"
 #include "rgb_bus.h"
 
+#ifndef ESP_IDF_VERSION
+    #include "memory_bus.h"
+#endif
+
 #ifdef MP_PORT_UNIX
+    #include "fbdev_bus.h"
     #include "sdl_bus.h"
 #endif
 
@@ -17,6 +23,9 @@
 #include "py/objarray.h"
 #include "py/binary.h"
 
+// stdlib includes
+#include <string.h>
+
 
 #ifdef ESP_IDF_VERSION
     #include "esp_heap_caps.h"
@@ -190,8 +199,10 @@ mp_obj_t mp_lcd_bus_tx_color(size_t n_args, const mp_obj_t *pos_args, mp_map_t *
     }
 
     if (self->callback == mp_const_none) {
+        uint32_t start = lcd_panel_io_ticks_us();
         while (self->trans_done == false) {}
         self->trans_done = false;
+        self->panel_io_handle.stats.blocked_time_us += lcd_panel_io_ticks_us() - start;
     }
 
     return mp_const_none;
@@ -259,6 +270,162 @@ mp_obj_t mp_lcd_bus_register_callback(size_t n_args, const mp_obj_t *pos_args, m
 MP_DEFINE_CONST_FUN_OBJ_KW(mp_lcd_bus_register_callback_obj, 2, mp_lcd_bus_register_callback);
 
 
+/*
+Has the buffers LVGL renders in RGB888 (src_bpp=24) or XRGB8888 (src_bpp=32)
+converted to RGB565 as they get sent. This needs to be called before init so
+the bus gets set up for RGB565. Passing 0 for src_bpp turns it off.
+*/
+mp_obj_t mp_lcd_bus_set_rgb565_conversion(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args)
+{
+    enum { ARG_self, ARG_src_bpp, ARG_dither };
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_self,     MP_ARG_OBJ | MP_ARG_REQUIRED, { .u_obj = mp_const_none   } },
+        { MP_QSTR_src_bpp,  MP_ARG_INT | MP_ARG_REQUIRED, { .u_int = 0               } },
+        { MP_QSTR_dither,   MP_ARG_INT,                   { .u_int = LCD_DITHER_NONE } },
+    };
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all(n_args, pos_args, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
+
+    mp_lcd_bus_obj_t *self = (mp_lcd_bus_obj_t *)args[ARG_self].u_obj;
+    lcd_rgb565_convert_t *convert = &self->panel_io_handle.rgb565_convert;
+
+    mp_int_t src_bpp = args[ARG_src_bpp].u_int;
+    mp_int_t dither = args[ARG_dither].u_int;
+
+    if (src_bpp != 0 && src_bpp != 24 && src_bpp != 32) {
+        mp_raise_ValueError(MP_ERROR_TEXT("src_bpp must be 0, 24 or 32"));
+    }
+
+    if (dither < LCD_DITHER_NONE || dither > LCD_DITHER_ERROR_DIFFUSION) {
+        mp_raise_ValueError(MP_ERROR_TEXT("invalid dither mode"));
+    }
+
+    // the buffers get made again by init for the new settings
+    lcd_panel_io_free_convert_bufs(convert);
+
+    convert->src_bytes_per_pixel = (uint8_t)(src_bpp / 8);
+    convert->dither = (uint8_t)dither;
+
+    return mp_const_none;
+}
+
+MP_DEFINE_CONST_FUN_OBJ_KW(mp_lcd_bus_set_rgb565_conversion_obj, 2, mp_lcd_bus_set_rgb565_conversion);
+
+
+/*
+Sets the pixel format the panel receives, LVGL keeps rendering in RGB565.
+The 3 byte formats are only able to be used with busses that send a stream
+of pixel data after a command.
+*/
+mp_obj_t mp_lcd_bus_set_wire_format(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args)
+{
+    enum { ARG_self, ARG_format, ARG_bounce_size };
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_self,         MP_ARG_OBJ | MP_ARG_REQUIRED, { .u_obj = mp_const_none        } },
+        { MP_QSTR_format,       MP_ARG_INT | MP_ARG_REQUIRED, { .u_int = LCD_WIRE_RGB565      } },
+        { MP_QSTR_bounce_size,  MP_ARG_INT,                   { .u_int = LCD_WIRE_BOUNCE_SIZE } },
+    };
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all(n_args, pos_args, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
+
+    mp_lcd_bus_obj_t *self = (mp_lcd_bus_obj_t *)args[ARG_self].u_obj;
+    mp_int_t format = args[ARG_format].u_int;
+
+    if (format < LCD_WIRE_RGB565 || format > LCD_WIRE_BGR888) {
+        mp_raise_ValueError(MP_ERROR_TEXT("invalid wire format"));
+    }
+
+    if (lcd_convert_wire_bytes_per_pixel((uint8_t)format) != 2) {
+    #ifdef ESP_IDF_VERSION
+        bool supported = self->panel_io_handle.tx_color == NULL;
+    #elif defined(MP_PORT_UNIX)
+        bool supported = !mp_obj_is_type(args[ARG_self].u_obj, &mp_lcd_rgb_bus_type) &&
+                         !mp_obj_is_type(args[ARG_self].u_obj, &mp_lcd_memory_bus_type) &&
+                         !mp_obj_is_type(args[ARG_self].u_obj, &mp_lcd_fbdev_bus_type) &&
+                         !mp_obj_is_type(args[ARG_self].u_obj, &mp_lcd_sdl_bus_type);
+    #else
+        bool supported = !mp_obj_is_type(args[ARG_self].u_obj, &mp_lcd_rgb_bus_type) &&
+                         !mp_obj_is_type(args[ARG_self].u_obj, &mp_lcd_memory_bus_type);
+    #endif
+        if (!supported) {
+            mp_raise_msg(&mp_type_NotImplementedError, MP_ERROR_TEXT("wire format not supported by this bus"));
+        }
+    }
+
+    mp_lcd_err_t ret = lcd_panel_io_set_wire_format(args[ARG_self].u_obj, (uint8_t)format, (uint32_t)args[ARG_bounce_size].u_int);
+
+    if (ret == LCD_ERR_NO_MEM) {
+        mp_raise_msg(&mp_type_MemoryError, MP_ERROR_TEXT("Unable to allocate bounce buffers"));
+    } else if (ret != LCD_OK) {
+        mp_raise_msg_varg(&mp_type_ValueError, MP_ERROR_TEXT("%d(lcd_panel_io_set_wire_format)"), ret);
+    }
+
+    return mp_const_none;
+}
+
+MP_DEFINE_CONST_FUN_OBJ_KW(mp_lcd_bus_set_wire_format_obj, 2, mp_lcd_bus_set_wire_format);
+
+
+/*
+Returns the performance counters for the bus. The dict is only created
+here, the counters themselves are updated without any allocation.
+*/
+mp_obj_t mp_lcd_bus_stats(mp_obj_t obj)
+{
+    mp_lcd_bus_obj_t *self = (mp_lcd_bus_obj_t *)obj;
+    lcd_bus_stats_t *stats = &self->panel_io_handle.stats;
+
+    mp_obj_t histogram[LCD_STATS_HISTOGRAM_BUCKETS];
+    mp_obj_t bounds[LCD_STATS_HISTOGRAM_BUCKETS - 1];
+    uint32_t bound = LCD_STATS_BUCKET_0_US;
+
+    for (uint8_t i = 0; i < LCD_STATS_HISTOGRAM_BUCKETS; i++) {
+        histogram[i] = mp_obj_new_int_from_uint(stats->histogram[i]);
+        if (i < LCD_STATS_HISTOGRAM_BUCKETS - 1) {
+            bounds[i] = mp_obj_new_int_from_uint(bound);
+            bound <<= 1;
+        }
+    }
+
+    uint32_t latency_avg = 0;
+    if (stats->flush_count != 0) latency_avg = (uint32_t)(stats->latency_total_us / stats->flush_count);
+
+    mp_obj_t dict = mp_obj_new_dict(12);
+    mp_obj_dict_store(dict, MP_OBJ_NEW_QSTR(MP_QSTR_bytes_sent), mp_obj_new_int_from_ull(stats->bytes_sent));
+    mp_obj_dict_store(dict, MP_OBJ_NEW_QSTR(MP_QSTR_tx_color_count), mp_obj_new_int_from_uint(stats->tx_color_count));
+    mp_obj_dict_store(dict, MP_OBJ_NEW_QSTR(MP_QSTR_flush_count), mp_obj_new_int_from_uint(stats->flush_count));
+    mp_obj_dict_store(dict, MP_OBJ_NEW_QSTR(MP_QSTR_tx_param_count), mp_obj_new_int_from_uint(stats->tx_param_count));
+    mp_obj_dict_store(dict, MP_OBJ_NEW_QSTR(MP_QSTR_param_bytes_sent), mp_obj_new_int_from_ull(stats->param_bytes_sent));
+    mp_obj_dict_store(dict, MP_OBJ_NEW_QSTR(MP_QSTR_blocked_time_us), mp_obj_new_int_from_ull(stats->blocked_time_us));
+    mp_obj_dict_store(dict, MP_OBJ_NEW_QSTR(MP_QSTR_copy_time_us), mp_obj_new_int_from_ull(stats->copy_time_us));
+    mp_obj_dict_store(dict, MP_OBJ_NEW_QSTR(MP_QSTR_copy_count), mp_obj_new_int_from_uint(stats->copy_count));
+    mp_obj_dict_store(dict, MP_OBJ_NEW_QSTR(MP_QSTR_latency_avg_us), mp_obj_new_int_from_uint(latency_avg));
+    mp_obj_dict_store(dict, MP_OBJ_NEW_QSTR(MP_QSTR_latency_max_us), mp_obj_new_int_from_uint(stats->latency_max_us));
+    mp_obj_dict_store(dict, MP_OBJ_NEW_QSTR(MP_QSTR_latency_histogram), mp_obj_new_tuple(LCD_STATS_HISTOGRAM_BUCKETS, histogram));
+    mp_obj_dict_store(dict, MP_OBJ_NEW_QSTR(MP_QSTR_latency_bounds_us), mp_obj_new_tuple(LCD_STATS_HISTOGRAM_BUCKETS - 1, bounds));
+
+    return dict;
+}
+
+MP_DEFINE_CONST_FUN_OBJ_1(mp_lcd_bus_stats_obj, mp_lcd_bus_stats);
+
+
+mp_obj_t mp_lcd_bus_reset_stats(mp_obj_t obj)
+{
+    mp_lcd_bus_obj_t *self = (mp_lcd_bus_obj_t *)obj;
+    lcd_bus_stats_t *stats = &self->panel_io_handle.stats;
+
+    // a transfer might be running, it still needs to know when it started
+    uint32_t flush_start_us = stats->flush_start_us;
+    memset(stats, 0, sizeof(lcd_bus_stats_t));
+    stats->flush_start_us = flush_start_us;
+
+    return mp_const_none;
+}
+
+MP_DEFINE_CONST_FUN_OBJ_1(mp_lcd_bus_reset_stats_obj, mp_lcd_bus_reset_stats);
+
+
 static mp_obj_t mp_lcd_bus__pump_main_thread(void)
 {
     mp_handle_pending(true);
@@ -273,6 +440,10 @@ static const mp_rom_map_elem_t mp_lcd_bus_locals_dict_table[] = {
     { MP_ROM_QSTR(MP_QSTR_get_lane_count),       MP_ROM_PTR(&mp_lcd_bus_get_lane_count_obj)       },
     { MP_ROM_QSTR(MP_QSTR_allocate_framebuffer), MP_ROM_PTR(&mp_lcd_bus_allocate_framebuffer_obj) },
     { MP_ROM_QSTR(MP_QSTR_free_framebuffer),     MP_ROM_PTR(&mp_lcd_bus_free_framebuffer_obj)     },
+    { MP_ROM_QSTR(MP_QSTR_set_rgb565_conversion), MP_ROM_PTR(&mp_lcd_bus_set_rgb565_conversion_obj) },
+    { MP_ROM_QSTR(MP_QSTR_set_wire_format),       MP_ROM_PTR(&mp_lcd_bus_set_wire_format_obj)       },
+    { MP_ROM_QSTR(MP_QSTR_stats),                MP_ROM_PTR(&mp_lcd_bus_stats_obj)                },
+    { MP_ROM_QSTR(MP_QSTR_reset_stats),          MP_ROM_PTR(&mp_lcd_bus_reset_stats_obj)          },
     { MP_ROM_QSTR(MP_QSTR_register_callback),    MP_ROM_PTR(&mp_lcd_bus_register_callback_obj)    },
     { MP_ROM_QSTR(MP_QSTR_tx_param),             MP_ROM_PTR(&mp_lcd_bus_tx_param_obj)             },
     { MP_ROM_QSTR(MP_QSTR_tx_color),             MP_ROM_PTR(&mp_lcd_bus_tx_color_obj)             },
@@ -293,11 +464,27 @@ static const mp_rom_map_elem_t mp_module_lcd_bus_globals_table[] = {
     { MP_ROM_QSTR(MP_QSTR_I80Bus),             MP_ROM_PTR(&mp_lcd_i80_bus_type)        },
     { MP_ROM_QSTR(MP_QSTR__pump_main_thread),  MP_ROM_PTR(&mp_lcd_bus__pump_main_thread_obj)       },
 
+    #ifndef ESP_IDF_VERSION
+        { MP_ROM_QSTR(MP_QSTR_MemoryBus),      MP_ROM_PTR(&mp_lcd_memory_bus_type)     },
+    #endif
+
     #ifdef MP_PORT_UNIX
+        { MP_ROM_QSTR(MP_QSTR_FBDevBus),       MP_ROM_PTR(&mp_lcd_fbdev_bus_type)      },
         { MP_ROM_QSTR(MP_QSTR_SDLBus),         MP_ROM_PTR(&mp_lcd_sdl_bus_type)        },
     #endif
     { MP_ROM_QSTR(MP_QSTR_DEBUG_ENABLED),    MP_ROM_INT(LCD_DEBUG) },
 
+    { MP_ROM_QSTR(MP_QSTR_DITHER_NONE),            MP_ROM_INT(LCD_DITHER_NONE)            },
+    { MP_ROM_QSTR(MP_QSTR_DITHER_ORDERED),         MP_ROM_INT(LCD_DITHER_ORDERED)         },
+    { MP_ROM_QSTR(MP_QSTR_DITHER_ERROR_DIFFUSION), MP_ROM_INT(LCD_DITHER_ERROR_DIFFUSION) },
+
+    { MP_ROM_QSTR(MP_QSTR_WIRE_RGB565),            MP_ROM_INT(LCD_WIRE_RGB565)            },
+    { MP_ROM_QSTR(MP_QSTR_WIRE_BGR565),            MP_ROM_INT(LCD_WIRE_BGR565)            },
+    { MP_ROM_QSTR(MP_QSTR_WIRE_RGB666),            MP_ROM_INT(LCD_WIRE_RGB666)            },
+    { MP_ROM_QSTR(MP_QSTR_WIRE_BGR666),            MP_ROM_INT(LCD_WIRE_BGR666)            },
+    { MP_ROM_QSTR(MP_QSTR_WIRE_RGB888),            MP_ROM_INT(LCD_WIRE_RGB888)            },
+    { MP_ROM_QSTR(MP_QSTR_WIRE_BGR888),            MP_ROM_INT(LCD_WIRE_BGR888)            },
+
     #ifdef ESP_IDF_VERSION
         { MP_ROM_QSTR(MP_QSTR_MEMORY_32BIT),    MP_ROM_INT(MALLOC_CAP_32BIT)     },
         { MP_ROM_QSTR(MP_QSTR_MEMORY_8BIT),     MP_ROM_INT(MALLOC_CAP_8BIT)      },
@@ -19,6 +19,10 @@
     extern const mp_obj_fun_builtin_var_t mp_lcd_bus_register_callback_obj;
     extern const mp_obj_fun_builtin_var_t mp_lcd_bus_free_framebuffer_obj;
     extern const mp_obj_fun_builtin_var_t mp_lcd_bus_allocate_framebuffer_obj;
+    extern const mp_obj_fun_builtin_var_t mp_lcd_bus_set_rgb565_conversion_obj;
+    extern const mp_obj_fun_builtin_var_t mp_lcd_bus_set_wire_format_obj;
+    extern const mp_obj_fun_builtin_fixed_t mp_lcd_bus_stats_obj;
+    extern const mp_obj_fun_builtin_fixed_t mp_lcd_bus_reset_stats_obj;
 
     extern const mp_obj_dict_t mp_lcd_bus_locals_dict;
 
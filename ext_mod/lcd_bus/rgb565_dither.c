@@ -1,6 +1,7 @@
 
 #include "rgb565_dither.h"
 #include <string.h>
+#include <stdlib.h>
 
 uint8_t* red_thresh = NULL;
 uint8_t* green_thresh = NULL;
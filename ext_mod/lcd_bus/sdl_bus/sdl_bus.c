@@ -10,6 +10,10 @@
 #include "py/objarray.h"
 #include "py/binary.h"
 
+// stdlib includes
+#include <stdlib.h>
+#include <string.h>
+
 // mp_printf(&mp_plat_print, "incomming event %d\n", event->type);
 
 #ifdef MP_PORT_UNIX
@@ -33,8 +37,11 @@
 
     static mp_obj_t mp_lcd_sdl_bus_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *all_args)
     {
-        enum { ARG_flags };
-        const mp_arg_t make_new_args[] = {{ MP_QSTR_flags, MP_ARG_INT  | MP_ARG_KW_ONLY | MP_ARG_REQUIRED, { .u_int = -1 } } };
+        enum { ARG_flags, ARG_render_thread };
+        const mp_arg_t make_new_args[] = {
+            { MP_QSTR_flags,         MP_ARG_INT  | MP_ARG_KW_ONLY | MP_ARG_REQUIRED, { .u_int = -1     } },
+            { MP_QSTR_render_thread, MP_ARG_BOOL | MP_ARG_KW_ONLY,                   { .u_bool = false } },
+        };
 
         mp_arg_val_t args[MP_ARRAY_SIZE(make_new_args)];
         mp_arg_parse_all_kw_array(
@@ -54,6 +61,7 @@
         self->callback = mp_const_none;
 
         self->panel_io_config.flags = args[ARG_flags].u_int;
+        self->render_thread = args[ARG_render_thread].u_bool;
 
         self->panel_io_handle.del = sdl_del;
         self->panel_io_handle.init = sdl_init;
@@ -68,6 +76,8 @@
             .state=0,
         };
 
+        memset(&self->input_queue, 0x00, sizeof(sdl_bus_input_queue_t));
+
         self->quit_callback = mp_const_none;
         self->mouse_callback = mp_const_none;
         self->window_callback = mp_const_none;
@@ -97,24 +107,292 @@
         return LCD_OK;
     }
 
+    static void sdl_staging_free(mp_lcd_sdl_bus_obj_t *self)
+    {
+        for (uint8_t i = 0; i < 2; i++) {
+            free(self->staging[i].buf);
+            self->staging[i].buf = NULL;
+            self->staging[i].rect_count = 0;
+            self->staging[i].ready = false;
+        }
+
+        self->write_index = 0;
+        self->render_index = 0;
+    }
+
+
+    static bool sdl_staging_alloc(mp_lcd_sdl_bus_obj_t *self)
+    {
+        size_t size = (size_t)self->panel_io_config.width * (size_t)self->panel_io_config.height *
+                      (size_t)self->panel_io_config.bytes_per_pixel;
+
+        for (uint8_t i = 0; i < 2; i++) {
+            self->staging[i].buf = malloc(size);
+            if (self->staging[i].buf == NULL) {
+                sdl_staging_free(self);
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+
+    // waits for the render thread to finish with both staging buffers, the lock has to be held.
+    static void sdl_staging_wait_idle(mp_lcd_sdl_bus_obj_t *self)
+    {
+        while (self->staging[0].ready || self->staging[1].ready) {
+            SDL_CondWait(self->cond, self->lock);
+        }
+    }
+
+
+    static void sdl_create_texture(mp_lcd_sdl_bus_obj_t *self, SDL_TextureAccess access)
+    {
+        if (self->texture != NULL) SDL_DestroyTexture(self->texture);
+
+        self->texture = SDL_CreateTexture(
+            self->renderer,
+            (SDL_PixelFormatEnum)self->panel_io_config.px_format,
+            access,
+            self->panel_io_config.width,
+            self->panel_io_config.height
+        );
+
+        SDL_SetTextureBlendMode(self->texture, SDL_BLENDMODE_BLEND);
+    }
+
+
+    static void sdl_destroy_renderer(mp_lcd_sdl_bus_obj_t *self)
+    {
+        if (self->texture != NULL) SDL_DestroyTexture(self->texture);
+        if (self->renderer != NULL) SDL_DestroyRenderer(self->renderer);
+
+        self->texture = NULL;
+        self->renderer = NULL;
+    }
+
+
+    /*
+    Owns the renderer, the texture and the presenting when render_thread is
+    enabled, nothing else touches them while the thread is running. A resize
+    is sent to the thread by setting resize_pending, it makes the texture
+    again and clears it. The staging buffers are taken in the same order
+    tx_color fills them. The lock is not held while the texture is being
+    updated so tx_color is able to copy the next frame into the other
+    staging buffer at the same time.
+    */
+    int flush_thread(void *self_in)
+    {
+        mp_lcd_sdl_bus_obj_t *self = (mp_lcd_sdl_bus_obj_t *)self_in;
+        sdl_bus_staging_t *staging;
+        SDL_Rect *rect;
+        int bytes_per_pixel;
+        int pitch;
+
+        SDL_LockMutex(self->lock);
+
+        self->renderer = SDL_CreateRenderer(self->window, -1, SDL_RENDERER_SOFTWARE);
+        if (self->renderer != NULL) sdl_create_texture(self, SDL_TEXTUREACCESS_STREAMING);
+
+        self->thread_ready = true;
+        SDL_CondBroadcast(self->cond);
+
+        while (self->renderer != NULL) {
+            while (!self->thread_exit && !self->resize_pending && !self->staging[self->render_index].ready) {
+                SDL_CondWait(self->cond, self->lock);
+            }
+
+            if (self->thread_exit) break;
+
+            if (self->resize_pending) {
+                sdl_create_texture(self, SDL_TEXTUREACCESS_STATIC);
+                self->resize_pending = false;
+                SDL_CondBroadcast(self->cond);
+                continue;
+            }
+
+            staging = &self->staging[self->render_index];
+            bytes_per_pixel = (int)self->panel_io_config.bytes_per_pixel;
+            pitch = (int)self->panel_io_config.width * bytes_per_pixel;
+
+            SDL_UnlockMutex(self->lock);
+
+            for (uint8_t i = 0; i < staging->rect_count; i++) {
+                rect = &staging->rects[i];
+                SDL_UpdateTexture(self->texture, rect, staging->buf + (rect->y * pitch) + (rect->x * bytes_per_pixel), pitch);
+            }
+
+            SDL_RenderClear(self->renderer);
+            SDL_RenderCopy(self->renderer, self->texture, NULL, NULL);
+            SDL_RenderPresent(self->renderer);
+
+            SDL_LockMutex(self->lock);
+
+            staging->rect_count = 0;
+            staging->ready = false;
+            self->render_index ^= 1;
+            SDL_CondBroadcast(self->cond);
+        }
+
+        sdl_destroy_renderer(self);
+
+        SDL_UnlockMutex(self->lock);
+        return 0;
+    }
+
+
+    /*
+    Starts the render thread and waits for it to make the renderer and the
+    texture. Returns false if either one of them wasn't able to be made.
+    */
+    static bool sdl_thread_start(mp_lcd_sdl_bus_obj_t *self)
+    {
+        self->thread_exit = false;
+        self->thread_ready = false;
+        self->resize_pending = false;
+        self->lock = SDL_CreateMutex();
+        self->cond = SDL_CreateCond();
+        self->thread = SDL_CreateThread(flush_thread, "lcd_bus_sdl_flush", (void *)self);
+
+        if (self->thread != NULL) {
+            SDL_LockMutex(self->lock);
+            while (!self->thread_ready) SDL_CondWait(self->cond, self->lock);
+            bool started = self->renderer != NULL;
+            SDL_UnlockMutex(self->lock);
+
+            if (started) return true;
+
+            SDL_WaitThread(self->thread, NULL);
+            self->thread = NULL;
+        }
+
+        SDL_DestroyCond(self->cond);
+        SDL_DestroyMutex(self->lock);
+        return false;
+    }
+
+
+    // the render thread destroys the renderer and the texture before it exits
+    static void sdl_thread_stop(mp_lcd_sdl_bus_obj_t *self)
+    {
+        SDL_LockMutex(self->lock);
+        self->thread_exit = true;
+        SDL_CondBroadcast(self->cond);
+        SDL_UnlockMutex(self->lock);
+
+        SDL_WaitThread(self->thread, NULL);
+        self->thread = NULL;
+
+        SDL_DestroyCond(self->cond);
+        SDL_DestroyMutex(self->lock);
+        sdl_staging_free(self);
+    }
+
+
+    /*
+    Copies the flushed area into the staging buffer so LVGL is able to reuse
+    its buffer right away. The only time this waits is when the render thread
+    is still presenting the frame from 2 frames ago out of this staging buffer.
+    */
+    static void sdl_tx_color_staged(mp_lcd_sdl_bus_obj_t *self, uint8_t *color, SDL_Rect *rect, bool last_update)
+    {
+        sdl_bus_staging_t *staging = &self->staging[self->write_index];
+        lcd_bus_stats_t *stats = &self->panel_io_handle.stats;
+        int bytes_per_pixel = (int)self->panel_io_config.bytes_per_pixel;
+        int pitch = (int)self->panel_io_config.width * bytes_per_pixel;
+        uint32_t start;
+
+        if (staging->ready) {
+            start = lcd_panel_io_ticks_us();
+            SDL_LockMutex(self->lock);
+            while (staging->ready) SDL_CondWait(self->cond, self->lock);
+            SDL_UnlockMutex(self->lock);
+            stats->blocked_time_us += lcd_panel_io_ticks_us() - start;
+        }
+
+        if (rect != NULL) {
+            start = lcd_panel_io_ticks_us();
+
+            size_t offset = (size_t)(rect->y * pitch + rect->x * bytes_per_pixel);
+            size_t row_size = (size_t)(rect->w * bytes_per_pixel);
+
+            for (int y = 0; y < rect->h; y++) {
+                memcpy(staging->buf + offset, color + offset, row_size);
+                offset += (size_t)pitch;
+            }
+
+            if (staging->rect_count < SDL_BUS_STAGING_RECTS) {
+                staging->rects[staging->rect_count++] = *rect;
+            } else {
+                // out of slots, the last one grows to cover the new area
+                SDL_Rect *last = &staging->rects[SDL_BUS_STAGING_RECTS - 1];
+                SDL_UnionRect(last, rect, last);
+            }
+
+            stats->copy_time_us += lcd_panel_io_ticks_us() - start;
+            stats->copy_count++;
+        }
+
+        if (last_update) {
+            SDL_LockMutex(self->lock);
+            staging->ready = true;
+            SDL_CondBroadcast(self->cond);
+            SDL_UnlockMutex(self->lock);
+
+            self->write_index ^= 1;
+        }
+    }
+
+
+    /*
+    The display is set to DIRECT render mode so color is always the start of
+    a full size frame buffer. Only the area that was flushed gets copied to
+    the texture and the window is only updated once all of the areas for a
+    frame have been flushed. With render_thread enabled that work gets handed
+    off to flush_thread instead.
+    */
     mp_lcd_err_t sdl_tx_color(mp_obj_t obj, int lcd_cmd, void *color, size_t color_size, int x_start, int y_start, int x_end, int y_end, uint8_t rotation, bool last_update)
     {
-        LCD_UNUSED(x_start);
-        LCD_UNUSED(y_start);
-        LCD_UNUSED(x_end);
-        LCD_UNUSED(y_end);
+        LCD_UNUSED(lcd_cmd);
         LCD_UNUSED(color_size);
         LCD_UNUSED(rotation);
-        LCD_UNUSED(last_update);
 
         mp_lcd_sdl_bus_obj_t *self = MP_OBJ_TO_PTR(obj);
 
-        int pitch = self->panel_io_config.width * self->panel_io_config.bytes_per_pixel;
+        int width = (int)self->panel_io_config.width;
+        int height = (int)self->panel_io_config.height;
+        int bytes_per_pixel = (int)self->panel_io_config.bytes_per_pixel;
+        int pitch = width * bytes_per_pixel;
+
+        if (x_start < 0) x_start = 0;
+        if (y_start < 0) y_start = 0;
+        if (x_end >= width) x_end = width - 1;
+        if (y_end >= height) y_end = height - 1;
+
+        SDL_Rect rect = {
+            .x = x_start,
+            .y = y_start,
+            .w = x_end - x_start + 1,
+            .h = y_end - y_start + 1
+        };
+
+        bool has_area = x_end >= x_start && y_end >= y_start;
+
+        if (self->render_thread) {
+            sdl_tx_color_staged(self, (uint8_t *)color, has_area ? &rect : NULL, last_update);
+        } else if (has_area) {
+            uint8_t *pixels = (uint8_t *)color + (y_start * pitch) + (x_start * bytes_per_pixel);
+            SDL_UpdateTexture(self->texture, &rect, pixels, pitch);
+        }
+
+        if (last_update && !self->render_thread) {
+            SDL_RenderClear(self->renderer);
+            SDL_RenderCopy(self->renderer, self->texture, NULL, NULL);
+            SDL_RenderPresent(self->renderer);
+        }
 
-        SDL_UpdateTexture(self->texture, NULL, color, pitch);
-        SDL_RenderClear(self->renderer);
-        SDL_RenderCopy(self->renderer, self->texture, NULL, NULL);
-        SDL_RenderPresent(self->renderer);
+        lcd_panel_io_stats_flush_done(&self->panel_io_handle.stats, self->panel_io_handle.stats.flush_start_us);
 
         if (self->callback != mp_const_none && mp_obj_is_callable(self->callback)) {
             mp_call_function_n_kw(self->callback, 0, 0, NULL);
@@ -127,8 +405,9 @@
     {
         mp_lcd_sdl_bus_obj_t *self = MP_OBJ_TO_PTR(obj);
 
-        SDL_DestroyTexture(self->texture);
-        SDL_DestroyRenderer(self->renderer);
+        if (self->thread != NULL) sdl_thread_stop(self);
+
+        sdl_destroy_renderer(self);
         SDL_DestroyWindow(self->window);
 
         uint8_t i = 0;
@@ -177,11 +456,23 @@
             self->panel_io_config.flags
         );
 
-        self->renderer = SDL_CreateRenderer(self->window, -1, SDL_RENDERER_SOFTWARE);
-
         self->panel_io_config.bytes_per_pixel = bpp / 8;
-        self->texture = SDL_CreateTexture(self->renderer, (SDL_PixelFormatEnum)buffer_size, SDL_TEXTUREACCESS_STREAMING, width, height);
-        SDL_SetTextureBlendMode(self->texture, SDL_BLENDMODE_BLEND);
+        self->panel_io_config.px_format = buffer_size;
+        self->renderer = NULL;
+        self->texture = NULL;
+
+        if (self->render_thread) {
+            if (!sdl_staging_alloc(self)) return LCD_ERR_NO_MEM;
+
+            if (!sdl_thread_start(self)) {
+                sdl_staging_free(self);
+                return LCD_FAIL;
+            }
+        } else {
+            self->renderer = SDL_CreateRenderer(self->window, -1, SDL_RENDERER_SOFTWARE);
+            sdl_create_texture(self, SDL_TEXTUREACCESS_STREAMING);
+        }
+
         SDL_SetWindowSize(self->window, width, height);
 
         self->rgb565_byte_swap = false;
@@ -282,22 +573,40 @@
 
         mp_lcd_sdl_bus_obj_t *self = MP_OBJ_TO_PTR(args[ARG_self].u_obj);
 
-        self->panel_io_config.width = (uint16_t)args[ARG_width].u_int;
-        self->panel_io_config.height = (uint16_t)args[ARG_height].u_int;
+        if (self->thread != NULL) {
+            // the render thread owns the texture, it gets asked to make it
+            // again once it is done with both of the staging buffers
+            SDL_LockMutex(self->lock);
+            sdl_staging_wait_idle(self);
 
-        if(self->texture) {
-            SDL_DestroyTexture(self->texture);
-        }
+            self->panel_io_config.width = (uint16_t)args[ARG_width].u_int;
+            self->panel_io_config.height = (uint16_t)args[ARG_height].u_int;
+            self->panel_io_config.px_format = (uint32_t)args[ARG_px_format].u_int;
 
-        self->texture = SDL_CreateTexture(
-            self->renderer,
-            (SDL_PixelFormatEnum)args[ARG_px_format].u_int,
-            SDL_TEXTUREACCESS_STATIC,
-            self->panel_io_config.width,
-            self->panel_io_config.height
-        );
+            self->resize_pending = true;
+            SDL_CondBroadcast(self->cond);
+            while (self->resize_pending) SDL_CondWait(self->cond, self->lock);
 
-        SDL_SetTextureBlendMode(self->texture, SDL_BLENDMODE_BLEND);
+            sdl_staging_free(self);
+            bool staged = sdl_staging_alloc(self);
+            SDL_UnlockMutex(self->lock);
+
+            // without staging buffers the thread is stopped and the texture
+            // gets updated directly like it does without the thread
+            if (!staged) {
+                sdl_thread_stop(self);
+                self->render_thread = false;
+
+                self->renderer = SDL_CreateRenderer(self->window, -1, SDL_RENDERER_SOFTWARE);
+                sdl_create_texture(self, SDL_TEXTUREACCESS_STATIC);
+            }
+        } else {
+            self->panel_io_config.width = (uint16_t)args[ARG_width].u_int;
+            self->panel_io_config.height = (uint16_t)args[ARG_height].u_int;
+            self->panel_io_config.px_format = (uint32_t)args[ARG_px_format].u_int;
+
+            sdl_create_texture(self, SDL_TEXTUREACCESS_STATIC);
+        }
 
         if ((bool)args[ARG_ignore_size_chg].u_int == false) {
             SDL_SetWindowSize(self->window, (int)self->panel_io_config.width, (int)self->panel_io_config.height);
@@ -344,6 +653,140 @@
     MP_DEFINE_CONST_FUN_OBJ_KW(mp_lcd_sdl_realloc_buffer_obj, 3, mp_lcd_sdl_realloc_buffer);
 
 
+    static void sdl_queue_pointer(mp_lcd_sdl_bus_obj_t *self, bool motion, int32_t wheel_x, int32_t wheel_y)
+    {
+        sdl_bus_input_queue_t *queue = &self->input_queue;
+        pointer_event_t *tail;
+
+        if (queue->pointer_count) {
+            tail = &queue->pointer[(queue->pointer_head + queue->pointer_count - 1) % SDL_BUS_POINTER_QUEUE];
+
+            // only the last position matters when nothing changed but the
+            // position. If the queue is full the newest entry gets updated so
+            // the state that is read last is always the current one.
+            if (tail->state == self->pointer_event.state &&
+                ((motion && tail->motion) || queue->pointer_count == SDL_BUS_POINTER_QUEUE)
+            ) {
+                tail->x = self->pointer_event.x;
+                tail->y = self->pointer_event.y;
+                tail->wheel_x += wheel_x;
+                tail->wheel_y += wheel_y;
+                return;
+            }
+
+            if (queue->pointer_count == SDL_BUS_POINTER_QUEUE) {
+                queue->pointer_head = (queue->pointer_head + 1) % SDL_BUS_POINTER_QUEUE;
+                queue->pointer_count--;
+            }
+        }
+
+        tail = &queue->pointer[(queue->pointer_head + queue->pointer_count) % SDL_BUS_POINTER_QUEUE];
+        tail->x = self->pointer_event.x;
+        tail->y = self->pointer_event.y;
+        tail->wheel_x = wheel_x;
+        tail->wheel_y = wheel_y;
+        tail->state = self->pointer_event.state;
+        tail->motion = motion;
+        queue->pointer_count++;
+    }
+
+
+    static void sdl_queue_key(mp_lcd_sdl_bus_obj_t *self, uint32_t type, uint8_t state, int32_t key, uint16_t mod)
+    {
+        sdl_bus_input_queue_t *queue = &self->input_queue;
+
+        // drop the oldest key if nothing has been read for a while
+        if (queue->key_count == SDL_BUS_KEY_QUEUE) {
+            queue->key_head = (queue->key_head + 1) % SDL_BUS_KEY_QUEUE;
+            queue->key_count--;
+        }
+
+        key_event_t *tail = &queue->key[(queue->key_head + queue->key_count) % SDL_BUS_KEY_QUEUE];
+        tail->type = type;
+        tail->state = state;
+        tail->key = key;
+        tail->mod = mod;
+        queue->key_count++;
+    }
+
+
+    static void sdl_call_mouse_callback(mp_lcd_sdl_bus_obj_t *self, uint32_t type, int32_t wheel_x, int32_t wheel_y)
+    {
+        mp_obj_t res[6];
+        res[0] = mp_obj_new_int_from_uint(type);
+        res[1] = mp_obj_new_int_from_uint(self->pointer_event.state);
+        res[2] = mp_obj_new_int(self->pointer_event.x);
+        res[3] = mp_obj_new_int(self->pointer_event.y);
+        res[4] = mp_obj_new_int(wheel_x);
+        res[5] = mp_obj_new_int(wheel_y);
+
+        mp_call_function_n_kw(self->mouse_callback, 6, 0, res);
+    }
+
+
+    /*
+    Returns the oldest queued pointer state as
+    (state, x, y, wheel_x, wheel_y, pending) or None if nothing is queued.
+    pending is the number of entries still in the queue after this one so
+    the indev driver knows if LVGL has to read again.
+    */
+    static mp_obj_t mp_lcd_sdl_read_pointer(mp_obj_t self_in)
+    {
+        mp_lcd_sdl_bus_obj_t *self = MP_OBJ_TO_PTR(self_in);
+        sdl_bus_input_queue_t *queue = &self->input_queue;
+
+        if (queue->pointer_count == 0) return mp_const_none;
+
+        pointer_event_t *event = &queue->pointer[queue->pointer_head];
+        queue->pointer_head = (queue->pointer_head + 1) % SDL_BUS_POINTER_QUEUE;
+        queue->pointer_count--;
+
+        mp_obj_t res[6];
+        res[0] = mp_obj_new_int_from_uint(event->state);
+        res[1] = mp_obj_new_int(event->x);
+        res[2] = mp_obj_new_int(event->y);
+        res[3] = mp_obj_new_int(event->wheel_x);
+        res[4] = mp_obj_new_int(event->wheel_y);
+        res[5] = mp_obj_new_int_from_uint(queue->pointer_count);
+
+        return mp_obj_new_tuple(6, res);
+    }
+
+    MP_DEFINE_CONST_FUN_OBJ_1(mp_lcd_sdl_read_pointer_obj, mp_lcd_sdl_read_pointer);
+
+
+    /*
+    Returns the oldest queued key as (state, key, mod, pending) or None if
+    no keys are queued.
+    */
+    static mp_obj_t mp_lcd_sdl_read_key(mp_obj_t self_in)
+    {
+        mp_lcd_sdl_bus_obj_t *self = MP_OBJ_TO_PTR(self_in);
+        sdl_bus_input_queue_t *queue = &self->input_queue;
+
+        if (queue->key_count == 0) return mp_const_none;
+
+        key_event_t *event = &queue->key[queue->key_head];
+        queue->key_head = (queue->key_head + 1) % SDL_BUS_KEY_QUEUE;
+        queue->key_count--;
+
+        mp_obj_t res[4];
+        res[0] = mp_obj_new_int_from_uint(event->state);
+        res[1] = mp_obj_new_int(event->key);
+        res[2] = mp_obj_new_int_from_uint(event->mod);
+        res[3] = mp_obj_new_int_from_uint(queue->key_count);
+
+        return mp_obj_new_tuple(4, res);
+    }
+
+    MP_DEFINE_CONST_FUN_OBJ_1(mp_lcd_sdl_read_key_obj, mp_lcd_sdl_read_key);
+
+
+    /*
+    Pointer and key events always get queued. The mouse and keypad callbacks
+    are only there for code that still wants every event delivered as it
+    happens, the SDL indev drivers read the queues instead.
+    */
     int process_event(mp_lcd_sdl_bus_obj_t *self, SDL_Event * event)
     {
         if (!self->inited) return 0;
@@ -358,28 +801,22 @@
             case SDL_FINGERDOWN:
             case SDL_FINGERUP:
                 if (event->tfinger.windowID != window_id) return 0;
-                if (self->mouse_callback == mp_const_none) return 0;
 
                 self->pointer_event.state = event->type == SDL_FINGERUP ? 0 : 1;
                 self->pointer_event.x = (int32_t)event->tfinger.x;
                 self->pointer_event.y = (int32_t)event->tfinger.y;
 
-                mp_obj_t res1[6];
-                res1[0] = mp_obj_new_int_from_uint(event->type);
-                res1[1] = mp_obj_new_int_from_uint(self->pointer_event.state);
-                res1[2] = mp_obj_new_int(self->pointer_event.x);
-                res1[3] = mp_obj_new_int(self->pointer_event.y);
-                res1[4] = mp_obj_new_int(0);
-                res1[5] = mp_obj_new_int(0);
+                sdl_queue_pointer(self, event->type == SDL_FINGERMOTION, 0, 0);
 
-                mp_call_function_n_kw(self->mouse_callback, 6, 0, res1);
+                if (self->mouse_callback != mp_const_none) {
+                    sdl_call_mouse_callback(self, event->type, 0, 0);
+                }
 
                 return 1;
 
             case SDL_KEYDOWN:
             case SDL_KEYUP:
                 if (event->key.windowID != window_id) return 0;
-                if (self->keypad_callback == mp_const_none) return 0;
 
                 int key =  event->key.keysym.sym;
                 uint16_t mod = event->key.keysym.mod;
@@ -393,19 +830,22 @@
                     key -= 32;
                 }
 
-                mp_obj_t res2[4];
-                res2[0] = mp_obj_new_int_from_uint(event->type);
-                res2[1] = mp_obj_new_int_from_uint(event->key.state);
-                res2[2] = mp_obj_new_int(key);
-                res2[3] = mp_obj_new_int_from_uint(mod);
+                sdl_queue_key(self, event->type, event->key.state, key, mod);
+
+                if (self->keypad_callback != mp_const_none) {
+                    mp_obj_t res2[4];
+                    res2[0] = mp_obj_new_int_from_uint(event->type);
+                    res2[1] = mp_obj_new_int_from_uint(event->key.state);
+                    res2[2] = mp_obj_new_int(key);
+                    res2[3] = mp_obj_new_int_from_uint(mod);
 
-                mp_call_function_n_kw(self->keypad_callback, 4, 0, res2);
+                    mp_call_function_n_kw(self->keypad_callback, 4, 0, res2);
+                }
 
                 return 1;
 
             case SDL_MOUSEMOTION:
                 if (event->motion.windowID != window_id) return 0;
-                if (self->mouse_callback == mp_const_none) return 0;
 
                 if (event->motion.state == SDL_BUTTON(SDL_BUTTON_RIGHT) || event->motion.state == SDL_BUTTON(SDL_BUTTON_LEFT)) {
                     self->pointer_event.state = 1;
@@ -416,55 +856,42 @@
                 self->pointer_event.x = (int32_t)event->motion.x;
                 self->pointer_event.y = (int32_t)event->motion.y;
 
-                mp_obj_t res3[6];
-                res3[0] = mp_obj_new_int_from_uint(event->type);
-                res3[1] = mp_obj_new_int_from_uint(self->pointer_event.state);
-                res3[2] = mp_obj_new_int(self->pointer_event.x);
-                res3[3] = mp_obj_new_int(self->pointer_event.y);
-                res3[4] = mp_obj_new_int(0);
-                res3[5] = mp_obj_new_int(0);
+                sdl_queue_pointer(self, true, 0, 0);
 
-                mp_call_function_n_kw(self->mouse_callback, 6, 0, res3);
+                if (self->mouse_callback != mp_const_none) {
+                    sdl_call_mouse_callback(self, event->type, 0, 0);
+                }
 
                 return 1;
 
             case SDL_MOUSEBUTTONDOWN:
             case SDL_MOUSEBUTTONUP:
                 if (event->button.windowID != window_id) return 0;
-                if (self->mouse_callback == mp_const_none) return 0;
 
                 self->pointer_event.state = event->type == SDL_MOUSEBUTTONUP ? 0 : 1;
                 self->pointer_event.x = (int32_t)event->button.x;
                 self->pointer_event.y = (int32_t)event->button.y;
 
-                mp_obj_t res4[6];
-                res4[0] = mp_obj_new_int_from_uint(event->type);
-                res4[1] = mp_obj_new_int_from_uint(self->pointer_event.state);
-                res4[2] = mp_obj_new_int(self->pointer_event.x);
-                res4[3] = mp_obj_new_int(self->pointer_event.y);
-                res4[4] = mp_obj_new_int(0);
-                res4[5] = mp_obj_new_int(0);
+                sdl_queue_pointer(self, false, 0, 0);
 
-                mp_call_function_n_kw(self->mouse_callback, 6, 0, res4);
+                if (self->mouse_callback != mp_const_none) {
+                    sdl_call_mouse_callback(self, event->type, 0, 0);
+                }
 
                 return 1;
 
             case SDL_MOUSEWHEEL:
                 if (event->wheel.windowID != window_id) return 0;
-                if (self->mouse_callback == mp_const_none) return 0;
 
                 self->pointer_event.x += (int32_t)event->wheel.mouseX;
                 self->pointer_event.y += (int32_t)event->wheel.mouseY;
 
-                mp_obj_t res5[6];
-                res5[0] = mp_obj_new_int_from_uint(event->type);
-                res5[1] = mp_obj_new_int_from_uint(self->pointer_event.state);
-                res5[2] = mp_obj_new_int(self->pointer_event.x);
-                res5[3] = mp_obj_new_int(self->pointer_event.y);
-                res5[4] = mp_obj_new_int(event->wheel.x);
-                res5[5] = mp_obj_new_int(event->wheel.y);
+                // wheel steps are added together the same way motion is
+                sdl_queue_pointer(self, true, (int32_t)event->wheel.x, (int32_t)event->wheel.y);
 
-                mp_call_function_n_kw(self->mouse_callback, 6, 0, res5);
+                if (self->mouse_callback != mp_const_none) {
+                    sdl_call_mouse_callback(self, event->type, (int32_t)event->wheel.x, (int32_t)event->wheel.y);
+                }
 
                 return 1;
 
@@ -488,7 +915,9 @@
 
             default:
                 if (((window_flags | SDL_WINDOW_INPUT_FOCUS) != window_flags) && ((window_flags | SDL_WINDOW_MOUSE_FOCUS) != window_flags)) return 0;
-                if (self->mouse_callback == mp_const_none) return 0;
+
+                bool motion = true;
+
                 switch(event->type) {
                     case SDL_CONTROLLERAXISMOTION:
                         switch(event->caxis.axis) {
@@ -507,12 +936,14 @@
 
                     case SDL_CONTROLLERBUTTONDOWN:
                     case SDL_CONTROLLERBUTTONUP:
+                        motion = false;
                         self->pointer_event.state = event->type == SDL_CONTROLLERBUTTONUP ? 0 : 1;
                         break;
 
                     case SDL_CONTROLLERTOUCHPADMOTION:
                     case SDL_CONTROLLERTOUCHPADDOWN:
                     case SDL_CONTROLLERTOUCHPADUP:
+                        motion = event->type == SDL_CONTROLLERTOUCHPADMOTION;
                         self->pointer_event.state = event->type == SDL_CONTROLLERTOUCHPADUP ? 0 : 1;
                         self->pointer_event.x = (int32_t)event->ctouchpad.x;
                         self->pointer_event.y = (int32_t)event->ctouchpad.y;
@@ -575,20 +1006,18 @@
 
                     case SDL_JOYBUTTONDOWN:
                     case SDL_JOYBUTTONUP:
+                        motion = false;
                         self->pointer_event.state = event->type == SDL_JOYBUTTONUP ? 0 : 1;
                         break;
                     default:
                         return 0;
                 }
-                mp_obj_t res7[6];
-                res7[0] = mp_obj_new_int_from_uint(event->type);
-                res7[1] = mp_obj_new_int_from_uint(self->pointer_event.state);
-                res7[2] = mp_obj_new_int(self->pointer_event.x);
-                res7[3] = mp_obj_new_int(self->pointer_event.y);
-                res7[4] = mp_obj_new_int(0);
-                res7[5] = mp_obj_new_int(0);
 
-                mp_call_function_n_kw(self->mouse_callback, 6, 0, res7);
+                sdl_queue_pointer(self, motion, 0, 0);
+
+                if (self->mouse_callback != mp_const_none) {
+                    sdl_call_mouse_callback(self, event->type, 0, 0);
+                }
 
                 return 1;
         }
@@ -602,6 +1031,10 @@
         { MP_ROM_QSTR(MP_QSTR_rx_param),             MP_ROM_PTR(&mp_lcd_bus_rx_param_obj)             },
         { MP_ROM_QSTR(MP_QSTR_tx_param),             MP_ROM_PTR(&mp_lcd_bus_tx_param_obj)             },
         { MP_ROM_QSTR(MP_QSTR_free_framebuffer),     MP_ROM_PTR(&mp_lcd_bus_free_framebuffer_obj)     },
+        { MP_ROM_QSTR(MP_QSTR_set_rgb565_conversion), MP_ROM_PTR(&mp_lcd_bus_set_rgb565_conversion_obj) },
+        { MP_ROM_QSTR(MP_QSTR_set_wire_format),       MP_ROM_PTR(&mp_lcd_bus_set_wire_format_obj)       },
+        { MP_ROM_QSTR(MP_QSTR_stats),                MP_ROM_PTR(&mp_lcd_bus_stats_obj)                },
+        { MP_ROM_QSTR(MP_QSTR_reset_stats),          MP_ROM_PTR(&mp_lcd_bus_reset_stats_obj)          },
         { MP_ROM_QSTR(MP_QSTR_allocate_framebuffer), MP_ROM_PTR(&mp_lcd_bus_allocate_framebuffer_obj) },
         { MP_ROM_QSTR(MP_QSTR_init),                 MP_ROM_PTR(&mp_lcd_bus_init_obj)                 },
         { MP_ROM_QSTR(MP_QSTR_deinit),               MP_ROM_PTR(&mp_lcd_bus_deinit_obj)               },
@@ -613,6 +1046,8 @@
         { MP_ROM_QSTR(MP_QSTR_register_keypad_callback),  MP_ROM_PTR(&mp_lcd_sdl_register_keypad_callback_obj) },
         { MP_ROM_QSTR(MP_QSTR_register_window_callback),  MP_ROM_PTR(&mp_lcd_sdl_register_window_callback_obj) },
         { MP_ROM_QSTR(MP_QSTR_poll_events),  MP_ROM_PTR(&mp_lcd_sdl_poll_events_obj) },
+        { MP_ROM_QSTR(MP_QSTR_read_pointer), MP_ROM_PTR(&mp_lcd_sdl_read_pointer_obj) },
+        { MP_ROM_QSTR(MP_QSTR_read_key),     MP_ROM_PTR(&mp_lcd_sdl_read_key_obj)     },
         { MP_ROM_QSTR(MP_QSTR_WINDOW_FULLSCREEN),         MP_ROM_INT(SDL_WINDOW_FULLSCREEN)         },
         { MP_ROM_QSTR(MP_QSTR_WINDOW_FULLSCREEN_DESKTOP), MP_ROM_INT(SDL_WINDOW_FULLSCREEN_DESKTOP) },
         { MP_ROM_QSTR(MP_QSTR_WINDOW_BORDERLESS),         MP_ROM_INT(SDL_WINDOW_BORDERLESS)         },
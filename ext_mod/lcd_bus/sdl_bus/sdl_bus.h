@@ -17,18 +17,67 @@
         typedef struct {
             int32_t x;
             int32_t y;
+            int32_t wheel_x;
+            int32_t wheel_y;
             uint8_t state;
+            bool motion;
         } pointer_event_t;
 
+        typedef struct {
+            uint32_t type;
+            uint8_t state;
+            int32_t key;
+            uint16_t mod;
+        } key_event_t;
+
+        #define SDL_BUS_POINTER_QUEUE  (16)
+        #define SDL_BUS_KEY_QUEUE      (32)
+
+        /*
+        Input that arrives while polling SDL gets queued instead of being
+        handed to Python one event at a time. Motion that follows motion with
+        the same button state only updates the last queued position so a fast
+        moving mouse costs one entry. Button transitions and keys are always
+        kept. The indev drivers drain the queues from LVGL's read callback.
+        */
+        typedef struct _sdl_bus_input_queue_t {
+            pointer_event_t pointer[SDL_BUS_POINTER_QUEUE];
+            uint8_t pointer_head;
+            uint8_t pointer_count;
+
+            key_event_t key[SDL_BUS_KEY_QUEUE];
+            uint8_t key_head;
+            uint8_t key_count;
+        } sdl_bus_input_queue_t;
+
         typedef struct _panel_io_config_t {
             uint16_t width;
             uint16_t height;
             uint32_t win_id;
             void *buf_to_flush;
             uint8_t bytes_per_pixel;
+            uint32_t px_format;
             int flags;
         } panel_io_config_t;
 
+        #define SDL_BUS_STAGING_RECTS  (16)
+
+        /*
+        Used when the bus is created with render_thread=True. The areas that
+        get flushed are copied into a staging buffer and once a frame is
+        complete the render thread uploads the areas to the texture and
+        presents it while the next frame is being rendered into the other
+        staging buffer. The renderer and the texture belong to the render
+        thread, it creates them when it starts and the texture gets made
+        again by it when resize_pending is set.
+        */
+        typedef struct _sdl_bus_staging_t {
+            uint8_t *buf;
+            SDL_Rect rects[SDL_BUS_STAGING_RECTS];
+            uint8_t rect_count;
+            volatile bool ready;
+        } sdl_bus_staging_t;
+
         typedef struct _mp_lcd_sdl_bus_obj_t {
             mp_obj_base_t base;
 
@@ -47,7 +96,19 @@
             SDL_Renderer *renderer;
             SDL_Texture *texture;
 
+            bool render_thread;
+            SDL_Thread *thread;
+            SDL_mutex *lock;
+            SDL_cond *cond;
+            sdl_bus_staging_t staging[2];
+            uint8_t write_index;
+            uint8_t render_index;
+            volatile bool thread_exit;
+            volatile bool thread_ready;
+            volatile bool resize_pending;
+
             pointer_event_t pointer_event;
+            sdl_bus_input_queue_t input_queue;
             mp_obj_t keypad_callback;
             mp_obj_t window_callback;
             mp_obj_t mouse_callback;
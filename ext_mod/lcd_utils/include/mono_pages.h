@@ -0,0 +1,45 @@
+// Copyright (c) 2024 - 2025 Kevin G. Schlosser
+
+#include "py/obj.h"
+#include "py/runtime.h"
+
+#include <stdint.h>
+
+#ifndef __MONO_PAGES_H__
+    #define __MONO_PAGES_H__
+
+    /*
+    Monochrome controllers like the SSD1306 and the ST7565 store the display
+    in "pages". A page is 8 rows tall and each byte in a page is a column of
+    8 pixels with the top pixel in bit 0.
+
+    LVGL renders I1 as rows of pixels packed 8 to a byte with the left pixel
+    in bit 7. These functions convert between the 2 layouts.
+
+    page_buf is a copy of the display ram that is page_width bytes per page.
+    It is needed because a flushed area doesn't have to start or end on a
+    page boundary and the rows in the page that are outside of the area still
+    have to be sent to the display.
+
+    src is the area without the 8 byte palette LVGL puts in front of it. Each
+    row in src is (x2 - x1 + 8) / 8 bytes.
+
+    x1, y1, x2 and y2 are inclusive and are the location of the area in the
+    page buffer.
+    */
+    void mono_pages_pack(uint8_t *page_buf, uint16_t page_width, const uint8_t *src,
+                         uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2);
+
+    /*
+    Copies the columns x1 to x2 of pages page1 to page2 out of page_buf so
+    they are next to each other in dst. That is the order the controller
+    wants the data in once the column and page window have been set.
+
+    returns the number of bytes written to dst.
+    */
+    uint32_t mono_pages_copy_window(uint8_t *dst, const uint8_t *page_buf, uint16_t page_width,
+                                    uint16_t x1, uint16_t x2, uint16_t page1, uint16_t page2);
+
+    extern const mp_obj_fun_builtin_var_t mp_lcd_utils_i1_to_pages_obj;
+
+#endif /* __MONO_PAGES_H__ */
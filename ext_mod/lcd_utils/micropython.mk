@@ -12,3 +12,4 @@ endif
 SRC_USERMOD_C += $(MOD_DIR)/src/lcd_utils.c
 SRC_USERMOD_C += $(MOD_DIR)/src/remap.c
 SRC_USERMOD_C += $(MOD_DIR)/src/binary_float.c
+SRC_USERMOD_C += $(MOD_DIR)/src/mono_pages.c
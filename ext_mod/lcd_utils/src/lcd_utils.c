@@ -2,6 +2,7 @@
 
 #include "../include/remap.h"
 #include "../include/binary_float.h"
+#include "../include/mono_pages.h"
 
 #include "py/obj.h"
 #include "py/runtime.h"
@@ -40,6 +41,7 @@ static const mp_rom_map_elem_t mp_lcd_utils_module_globals_table[] = {
     { MP_ROM_QSTR(MP_QSTR_int_float_converter),    MP_ROM_PTR(&mp_lcd_utils_int_float_converter_obj) },
     { MP_ROM_QSTR(MP_QSTR_spi_mode_to_polarity_phase),    MP_ROM_PTR(&spi_mode_to_polarity_phase_obj) },
     { MP_ROM_QSTR(MP_QSTR_spi_polarity_phase_to_mode),    MP_ROM_PTR(&spi_polarity_phase_to_mode_obj) },
+    { MP_ROM_QSTR(MP_QSTR_i1_to_pages),        MP_ROM_PTR(&mp_lcd_utils_i1_to_pages_obj) },
 
 };
 
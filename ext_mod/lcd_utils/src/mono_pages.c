@@ -0,0 +1,155 @@
+// Copyright (c) 2024 - 2025 Kevin G. Schlosser
+
+#include "../include/mono_pages.h"
+
+#include "py/obj.h"
+#include "py/runtime.h"
+
+#include <string.h>
+
+
+/*
+8 x 8 bit matrix transpose. Byte n of the input is row n, after the
+transpose byte n holds what was bit n of every row with row 0 in bit 0.
+*/
+static inline uint64_t transpose_8x8(uint64_t x)
+{
+    uint64_t t;
+
+    t = (x ^ (x >> 7)) & 0x00AA00AA00AA00AAULL;
+    x = x ^ t ^ (t << 7);
+    t = (x ^ (x >> 14)) & 0x0000CCCC0000CCCCULL;
+    x = x ^ t ^ (t << 14);
+    t = (x ^ (x >> 28)) & 0x00000000F0F0F0F0ULL;
+    x = x ^ t ^ (t << 28);
+
+    return x;
+}
+
+
+void mono_pages_pack(uint8_t *page_buf, uint16_t page_width, const uint8_t *src,
+                     uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2)
+{
+    uint16_t width = x2 - x1 + 1;
+    uint16_t src_stride = (width + 7) >> 3;
+
+    for (uint16_t page = y1 >> 3; page <= (y2 >> 3); page++) {
+        uint16_t row_start = MAX(y1, page << 3);
+        uint16_t row_end = MIN(y2, (page << 3) + 7);
+
+        // the bits in a page byte that belong to the rows in the area
+        uint8_t mask = (uint8_t)((0xFF << (row_start & 7)) & (0xFF >> (7 - (row_end & 7))));
+        const uint8_t *src_rows = src + (uint32_t)(row_start - y1) * src_stride;
+        uint8_t *dst = page_buf + (uint32_t)page * page_width + x1;
+
+        for (uint16_t src_col = 0; src_col < src_stride; src_col++) {
+            // 8 pixels wide by 8 rows tall block, missing rows stay 0 and get masked off
+            uint64_t block = 0;
+            const uint8_t *src_byte = src_rows + src_col;
+
+            for (uint16_t row = row_start; row <= row_end; row++) {
+                block |= (uint64_t)(*src_byte) << ((row & 7) << 3);
+                src_byte += src_stride;
+            }
+
+            block = transpose_8x8(block);
+
+            // bit 7 of an I1 byte is the left most pixel so the columns come out of the top byte first
+            uint8_t cols = (uint8_t)MIN(8, width - (src_col << 3));
+            uint8_t *dst_col = dst + (src_col << 3);
+
+            if (mask == 0xFF) {
+                for (uint8_t i = 0; i < cols; i++) {
+                    dst_col[i] = (uint8_t)(block >> ((7 - i) << 3));
+                }
+            } else {
+                for (uint8_t i = 0; i < cols; i++) {
+                    dst_col[i] = (dst_col[i] & (uint8_t)~mask) | ((uint8_t)(block >> ((7 - i) << 3)) & mask);
+                }
+            }
+        }
+    }
+}
+
+
+uint32_t mono_pages_copy_window(uint8_t *dst, const uint8_t *page_buf, uint16_t page_width,
+                                uint16_t x1, uint16_t x2, uint16_t page1, uint16_t page2)
+{
+    uint16_t width = x2 - x1 + 1;
+    uint32_t offset = 0;
+
+    for (uint16_t page = page1; page <= page2; page++) {
+        memcpy(dst + offset, page_buf + (uint32_t)page * page_width + x1, width);
+        offset += width;
+    }
+
+    return offset;
+}
+
+
+static mp_obj_t mp_lcd_utils_i1_to_pages(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args)
+{
+    enum { ARG_src, ARG_page_buf, ARG_page_width, ARG_x1, ARG_y1, ARG_x2, ARG_y2, ARG_out };
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_src,        MP_ARG_OBJ | MP_ARG_REQUIRED },
+        { MP_QSTR_page_buf,   MP_ARG_OBJ | MP_ARG_REQUIRED },
+        { MP_QSTR_page_width, MP_ARG_INT | MP_ARG_REQUIRED },
+        { MP_QSTR_x1,         MP_ARG_INT | MP_ARG_REQUIRED },
+        { MP_QSTR_y1,         MP_ARG_INT | MP_ARG_REQUIRED },
+        { MP_QSTR_x2,         MP_ARG_INT | MP_ARG_REQUIRED },
+        { MP_QSTR_y2,         MP_ARG_INT | MP_ARG_REQUIRED },
+        { MP_QSTR_out,        MP_ARG_OBJ | MP_ARG_KW_ONLY, { .u_obj = mp_const_none } },
+    };
+
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all(n_args, pos_args, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
+
+    mp_int_t page_width = args[ARG_page_width].u_int;
+    mp_int_t x1 = args[ARG_x1].u_int;
+    mp_int_t y1 = args[ARG_y1].u_int;
+    mp_int_t x2 = args[ARG_x2].u_int;
+    mp_int_t y2 = args[ARG_y2].u_int;
+
+    if (x1 < 0 || y1 < 0 || x2 < x1 || y2 < y1 || x2 >= page_width || page_width > UINT16_MAX || y2 > UINT16_MAX) {
+        mp_raise_msg(&mp_type_ValueError, MP_ERROR_TEXT("invalid area"));
+    }
+
+    mp_buffer_info_t src_info;
+    mp_get_buffer_raise(args[ARG_src].u_obj, &src_info, MP_BUFFER_READ);
+
+    mp_buffer_info_t page_info;
+    mp_get_buffer_raise(args[ARG_page_buf].u_obj, &page_info, MP_BUFFER_RW);
+
+    uint32_t src_size = (uint32_t)((x2 - x1 + 8) >> 3) * (uint32_t)(y2 - y1 + 1);
+
+    if (src_info.len < src_size) {
+        mp_raise_msg_varg(&mp_type_ValueError, MP_ERROR_TEXT("src is too small (%d)"), (int)src_size);
+    }
+
+    if (page_info.len < (size_t)page_width * (size_t)((y2 >> 3) + 1)) {
+        mp_raise_msg(&mp_type_ValueError, MP_ERROR_TEXT("page_buf is too small"));
+    }
+
+    mono_pages_pack((uint8_t *)page_info.buf, (uint16_t)page_width, (const uint8_t *)src_info.buf,
+                    (uint16_t)x1, (uint16_t)y1, (uint16_t)x2, (uint16_t)y2);
+
+    if (args[ARG_out].u_obj == mp_const_none) {
+        return mp_obj_new_int_from_uint(0);
+    }
+
+    mp_buffer_info_t out_info;
+    mp_get_buffer_raise(args[ARG_out].u_obj, &out_info, MP_BUFFER_WRITE);
+
+    uint32_t out_size = (uint32_t)(x2 - x1 + 1) * (uint32_t)((y2 >> 3) - (y1 >> 3) + 1);
+
+    if (out_info.len < out_size) {
+        mp_raise_msg_varg(&mp_type_ValueError, MP_ERROR_TEXT("out is too small (%d)"), (int)out_size);
+    }
+
+    out_size = mono_pages_copy_window((uint8_t *)out_info.buf, (const uint8_t *)page_info.buf, (uint16_t)page_width,
+                                      (uint16_t)x1, (uint16_t)x2, (uint16_t)(y1 >> 3), (uint16_t)(y2 >> 3));
+
+    return mp_obj_new_int_from_uint(out_size);
+}
+
+MP_DEFINE_CONST_FUN_OBJ_KW(mp_lcd_utils_i1_to_pages_obj, 7, mp_lcd_utils_i1_to_pages);
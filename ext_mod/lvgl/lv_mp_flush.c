@@ -0,0 +1,175 @@
+// Copyright (c) 2024 - 2025 Kevin G. Schlosser
+
+// The native flush. When it is turned on LVGL's flush callback sends the
+// area straight to the bus from C and the bus calls lv_display_flush_ready
+// when it is done sending, no Python code runs to flush an area. With LVGL
+// threads the render thread doesn't have to wait on the VM thread for every
+// area that gets flushed, only the callbacks the user added get handed over.
+//
+// The address window is sent the same way DisplayDriver._set_memory_location
+// does it, the start and end columns and rows as big endian 16 bit values.
+// Drivers that set the window any other way keep using the Python flush.
+
+#include "py/obj.h"
+#include "py/runtime.h"
+#include "py/mpstate.h"
+
+#include "lvgl/lvgl.h"
+#include "lv_mp_profiler.h"
+
+// ext_mod/lcd_bus
+#include "lcd_types.h"
+
+
+#ifndef LV_MP_FLUSH_DISPLAYS
+    // most displays that are able to use the native flush at the same time
+    #define LV_MP_FLUSH_DISPLAYS  (4)
+#endif
+
+typedef struct _lv_mp_flush_t {
+    mp_obj_base_t base;
+    lv_display_t *disp;
+    mp_obj_t bus;
+    int32_t offset_x;
+    int32_t offset_y;
+    int ramwr;
+    int caset;  // -1 when the bus doesn't need the window set (RGB)
+    int raset;
+    uint8_t param_buf[4];
+} lv_mp_flush_t;
+
+
+// the flush objects are GC objects, the slots are a root pointer so they
+// stay alive even if the bus they are registered with gets collected
+MP_REGISTER_ROOT_POINTER(struct _lv_mp_flush_t *lv_mp_flushes[LV_MP_FLUSH_DISPLAYS]);
+
+
+static lv_mp_flush_t **lv_mp_flush_find(lv_display_t *disp)
+{
+    lv_mp_flush_t **flushes = MP_STATE_VM(lv_mp_flushes);
+
+    for (uint8_t i = 0; i < LV_MP_FLUSH_DISPLAYS; i++) {
+        if (flushes[i] != NULL && flushes[i]->disp == disp) return &flushes[i];
+    }
+    return NULL;
+}
+
+
+static mp_lcd_err_t lv_mp_flush_tx_window(lv_mp_flush_t *self, int cmd, int32_t start, int32_t end)
+{
+    self->param_buf[0] = (uint8_t)((start >> 8) & 0xFF);
+    self->param_buf[1] = (uint8_t)(start & 0xFF);
+    self->param_buf[2] = (uint8_t)((end >> 8) & 0xFF);
+    self->param_buf[3] = (uint8_t)(end & 0xFF);
+
+    return lcd_panel_io_tx_param(self->bus, cmd, self->param_buf, sizeof(self->param_buf));
+}
+
+
+// LVGL calls this from the render thread when it runs on one
+static void lv_mp_flush_cb(lv_display_t *disp, const lv_area_t *area, uint8_t *px_map)
+{
+    lv_mp_flush_t **slot = lv_mp_flush_find(disp);
+    if (slot == NULL) {
+        lv_display_flush_ready(disp);
+        return;
+    }
+
+    lv_mp_flush_t *self = *slot;
+
+    LV_MP_PROFILER_BEGIN;
+
+    int32_t x1 = area->x1 + self->offset_x;
+    int32_t x2 = area->x2 + self->offset_x;
+    int32_t y1 = area->y1 + self->offset_y;
+    int32_t y2 = area->y2 + self->offset_y;
+
+    size_t size = (size_t)lv_area_get_size(area) * lv_color_format_get_size(lv_display_get_color_format(disp));
+
+    mp_lcd_err_t ret = LCD_OK;
+    if (self->caset >= 0) ret = lv_mp_flush_tx_window(self, self->caset, x1, x2);
+    if (ret == LCD_OK && self->raset >= 0) ret = lv_mp_flush_tx_window(self, self->raset, y1, y2);
+
+    if (ret == LCD_OK) {
+        ret = lcd_panel_io_tx_color(self->bus, self->ramwr, px_map, size, (int)x1, (int)y1, (int)x2, (int)y2,
+                                    (uint8_t)lv_display_get_rotation(disp), lv_display_flush_is_last(disp));
+    }
+
+    // nothing is able to be raised from here and the bus is not going to
+    // call back, LVGL would wait on the area forever
+    if (ret != LCD_OK) {
+        LV_LOG_ERROR("sending the area to the bus failed (%d)", (int)ret);
+        lv_display_flush_ready(disp);
+    }
+
+    LV_MP_PROFILER_END;
+}
+
+
+// the bus calls this once the area has been sent, on some ports from an ISR.
+// The RGB bus passes if the frame has been swapped in, that isn't used
+static mp_obj_t lv_mp_flush_call(mp_obj_t self_in, size_t n_args, size_t n_kw, const mp_obj_t *args)
+{
+    LV_UNUSED(n_args);
+    LV_UNUSED(n_kw);
+    LV_UNUSED(args);
+
+    lv_mp_flush_t *self = MP_OBJ_TO_PTR(self_in);
+    lv_display_flush_ready(self->disp);
+    return mp_const_none;
+}
+
+
+static MP_DEFINE_CONST_OBJ_TYPE(
+    lv_mp_flush_type,
+    MP_QSTR_native_flush,
+    MP_TYPE_FLAG_NONE,
+    call, lv_mp_flush_call
+);
+
+
+/*
+lv.display_set_native_flush(disp, bus, offset_x=0, offset_y=0, ramwr=0x2C, caset=-1, raset=-1)
+
+Sets LVGL's flush callback of disp to one that sends the areas to bus from
+C. The object that gets returned has to be registered as the callback of the
+bus, it tells LVGL the area has been sent. caset and raset are the commands
+that set the address window, -1 leaves the window alone. Passing None as bus
+turns it off again, the Python flush callback has to be set after that.
+
+The display is converted in the generated binding, this is called from there.
+*/
+mp_obj_t lv_mp_flush_set_native(lv_display_t *disp, size_t n_args, const mp_obj_t *args)
+{
+    lv_mp_flush_t **slot = lv_mp_flush_find(disp);
+
+    if (args[0] == mp_const_none) {
+        if (slot != NULL) *slot = NULL;
+        return mp_const_none;
+    }
+
+    lv_mp_flush_t **flushes = MP_STATE_VM(lv_mp_flushes);
+
+    for (uint8_t i = 0; slot == NULL && i < LV_MP_FLUSH_DISPLAYS; i++) {
+        if (flushes[i] == NULL) slot = &flushes[i];
+    }
+
+    if (slot == NULL) {
+        mp_raise_msg(&mp_type_RuntimeError, MP_ERROR_TEXT("too many displays are using the native flush"));
+    }
+
+    lv_mp_flush_t *self = m_new_obj(lv_mp_flush_t);
+    self->base.type = &lv_mp_flush_type;
+    self->disp = disp;
+    self->bus = args[0];
+    self->offset_x = n_args > 1 ? (int32_t)mp_obj_get_int(args[1]) : 0;
+    self->offset_y = n_args > 2 ? (int32_t)mp_obj_get_int(args[2]) : 0;
+    self->ramwr = n_args > 3 ? (int)mp_obj_get_int(args[3]) : 0x2C;
+    self->caset = n_args > 4 ? (int)mp_obj_get_int(args[4]) : -1;
+    self->raset = n_args > 5 ? (int)mp_obj_get_int(args[5]) : -1;
+
+    *slot = self;
+    lv_display_set_flush_cb(disp, lv_mp_flush_cb);
+
+    return MP_OBJ_FROM_PTR(self);
+}
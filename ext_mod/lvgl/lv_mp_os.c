@@ -0,0 +1,458 @@
+// Copyright (c) 2024 - 2025 Kevin G. Schlosser
+
+#include "lv_mp_os.h"
+
+#include "py/obj.h"
+#include "py/runtime.h"
+#include "py/mphal.h"
+#include "py/nlr.h"
+
+#if LV_USE_OS != LV_OS_NONE
+    #include "py/mpthread.h"
+
+    #if !MICROPY_PY_THREAD
+        #error LVGL threads require MICROPY_PY_THREAD
+    #endif
+
+    /*
+    os_mutex protects the state below. The render thread is the only thread
+    that ever waits with os_wait, everything else that has to wait (Python
+    code in lv.lock()) polls so it is able to run the calls the render thread
+    hands over while it waits.
+    */
+    #if LV_USE_OS == LV_OS_PTHREAD
+        #include <pthread.h>
+        #include <time.h>
+        #include <poll.h>
+        #include <fcntl.h>
+        #include <unistd.h>
+        #include <errno.h>
+
+        static pthread_mutex_t os_mutex = PTHREAD_MUTEX_INITIALIZER;
+        static pthread_cond_t os_cond = PTHREAD_COND_INITIALIZER;
+        static bool os_signaled = false;
+
+        /*
+        The render thread sleeps waiting on the read end of this pipe.
+        Nothing that is able to be used in a signal handler works with a
+        condition variable, writing to a pipe does. sem_post would too but
+        unnamed semaphores are not supported on macOS.
+        */
+        static int os_wake_pipe[2] = { -1, -1 };
+
+        #define OS_ENTER()  pthread_mutex_lock(&os_mutex)
+        #define OS_EXIT()   pthread_mutex_unlock(&os_mutex)
+
+        // only ever called from a thread that is running Python code before
+        // the render thread exists
+        static void os_init(void)
+        {
+            if (os_wake_pipe[0] != -1) return;
+
+            if (pipe(os_wake_pipe) != 0) {
+                mp_raise_OSError(errno);
+            }
+
+            // a full pipe already wakes the render thread so writing to it
+            // is never allowed to block
+            fcntl(os_wake_pipe[0], F_SETFL, fcntl(os_wake_pipe[0], F_GETFL) | O_NONBLOCK);
+            fcntl(os_wake_pipe[1], F_SETFL, fcntl(os_wake_pipe[1], F_GETFL) | O_NONBLOCK);
+        }
+
+        // os_mutex has to be held
+        static void os_wait(uint32_t ms)
+        {
+            if (!os_signaled) {
+                if (ms == UINT32_MAX) {
+                    pthread_cond_wait(&os_cond, &os_mutex);
+                } else {
+                    struct timespec ts;
+                    clock_gettime(CLOCK_REALTIME, &ts);
+                    ts.tv_sec += ms / 1000;
+                    ts.tv_nsec += (long)(ms % 1000) * 1000000L;
+                    if (ts.tv_nsec >= 1000000000L) {
+                        ts.tv_sec++;
+                        ts.tv_nsec -= 1000000000L;
+                    }
+                    pthread_cond_timedwait(&os_cond, &os_mutex, &ts);
+                }
+            }
+            os_signaled = false;
+        }
+
+        // os_mutex has to be held
+        static void os_signal(void)
+        {
+            os_signaled = true;
+            pthread_cond_signal(&os_cond);
+        }
+    #else
+        #include "freertos/FreeRTOS.h"
+        #include "freertos/task.h"
+        #include "freertos/semphr.h"
+
+        static SemaphoreHandle_t os_mutex = NULL;
+        static TaskHandle_t os_render_task = NULL;
+
+        #define OS_ENTER()  xSemaphoreTake(os_mutex, portMAX_DELAY)
+        #define OS_EXIT()   xSemaphoreGive(os_mutex)
+
+        // only ever called from a thread that is running Python code before
+        // the render thread exists
+        static void os_init(void)
+        {
+            if (os_mutex == NULL) os_mutex = xSemaphoreCreateMutex();
+        }
+
+        // os_mutex has to be held. Task notifications are remembered so
+        // nothing is lost between giving up the mutex and waiting
+        static void os_wait(uint32_t ms)
+        {
+            OS_EXIT();
+            ulTaskNotifyTake(pdTRUE, ms == UINT32_MAX ? portMAX_DELAY : pdMS_TO_TICKS(ms));
+            OS_ENTER();
+        }
+
+        static void os_signal(void)
+        {
+            if (os_render_task != NULL) xTaskNotifyGive(os_render_task);
+        }
+    #endif
+
+
+    typedef struct _os_call_t {
+        void (*func)(void *);
+        void *data;
+        bool done;
+    } os_call_t;
+
+
+    // the chunks LVGL's memory is handed out from, see mem_core.c
+    MP_REGISTER_ROOT_POINTER(void *lv_mp_mem_chunks);
+
+    static mp_state_thread_t *render_state = NULL;
+    static void (*render_func)(void *) = NULL;
+    static void *render_data = NULL;
+
+    static mp_state_thread_t *lock_owner = NULL;
+    static uint32_t lock_depth = 0;
+
+    static volatile bool render_woken = false;
+
+    static os_call_t *pending_call = NULL;
+    // the thread that is running a call for the render thread
+    static mp_state_thread_t *call_thread = NULL;
+
+
+    bool lv_mp_os_is_render_thread(void)
+    {
+        return render_state != NULL && mp_thread_get_state() == render_state;
+    }
+
+
+    // runs the call the render thread is waiting on, if there is one. This
+    // is only called from threads that run Python code
+    static void os_run_pending_call(void)
+    {
+        os_init();
+
+        OS_ENTER();
+        os_call_t *call = pending_call;
+        pending_call = NULL;
+        if (call != NULL) call_thread = mp_thread_get_state();
+        OS_EXIT();
+
+        if (call == NULL) return;
+
+        // an exception is not able to get to the render thread
+        nlr_buf_t nlr;
+        if (nlr_push(&nlr) == 0) {
+            call->func(call->data);
+            nlr_pop();
+        } else {
+            mp_obj_print_exception(&mp_plat_print, MP_OBJ_FROM_PTR(nlr.ret_val));
+        }
+
+        OS_ENTER();
+        call_thread = NULL;
+        call->done = true;
+        os_signal();
+        OS_EXIT();
+    }
+
+
+    static mp_obj_t os_run_pending_call_cb(mp_obj_t arg)
+    {
+        LV_UNUSED(arg);
+        os_run_pending_call();
+        return mp_const_none;
+    }
+
+    static MP_DEFINE_CONST_FUN_OBJ_1(os_run_pending_call_cb_obj, os_run_pending_call_cb);
+
+
+    void lv_mp_os_call_in_vm(void (*func)(void *), void *data)
+    {
+        os_call_t call = { func, data, false };
+        bool scheduled = false;
+
+        OS_ENTER();
+        pending_call = &call;
+
+        while (!call.done) {
+            // if the schedule queue is full it is tried again in a bit. The
+            // call is also picked up by Python code that waits in lv.lock()
+            if (!scheduled && pending_call == &call) {
+                scheduled = mp_sched_schedule(MP_OBJ_FROM_PTR(&os_run_pending_call_cb_obj), mp_const_none);
+            }
+            os_wait(scheduled ? UINT32_MAX : 1);
+        }
+
+        OS_EXIT();
+    }
+
+
+    // os_mutex has to be held
+    static bool os_lock_is_held_by(mp_state_thread_t *state)
+    {
+        // a callback that was handed over by the render thread runs while the
+        // render thread holds the lock and waits for it
+        return lock_owner == state || (
+            lock_owner == render_state && call_thread != NULL && call_thread == state
+        );
+    }
+
+
+    void lv_mp_os_lock(void)
+    {
+        mp_state_thread_t *state = mp_thread_get_state();
+        bool is_render = render_state != NULL && state == render_state;
+
+        os_init();
+        OS_ENTER();
+
+        while (lock_owner != NULL && !os_lock_is_held_by(state)) {
+            if (is_render) {
+                os_wait(UINT32_MAX);
+            } else {
+                OS_EXIT();
+
+                // the render thread could be holding the lock waiting for a
+                // Python callback to be run
+                os_run_pending_call();
+                mp_hal_delay_ms(1);
+
+                OS_ENTER();
+            }
+        }
+
+        if (lock_owner == NULL) lock_owner = state;
+        lock_depth++;
+
+        OS_EXIT();
+    }
+
+
+    void lv_mp_os_unlock(void)
+    {
+        os_init();
+        OS_ENTER();
+
+        if (lock_depth > 0 && os_lock_is_held_by(mp_thread_get_state())) {
+            lock_depth--;
+            if (lock_depth == 0) {
+                lock_owner = NULL;
+                os_signal();
+            }
+        }
+
+        OS_EXIT();
+    }
+
+
+    static void *os_render_thread_entry(void *arg)
+    {
+        LV_UNUSED(arg);
+
+        mp_state_thread_t ts;
+        mp_thread_init_state(&ts, LV_MP_OS_RENDER_STACK_SIZE - 1024, NULL, NULL);
+
+        #if LV_USE_OS == LV_OS_FREERTOS
+            os_render_task = xTaskGetCurrentTaskHandle();
+        #endif
+
+        OS_ENTER();
+        render_state = &ts;
+        OS_EXIT();
+
+        // the GIL is not taken, this thread doesn't run any Python code
+        mp_thread_start();
+
+        render_func(render_data);
+
+        // the thread is able to be started again once it has exited
+        OS_ENTER();
+        render_state = NULL;
+        render_func = NULL;
+        #if LV_USE_OS == LV_OS_FREERTOS
+            os_render_task = NULL;
+        #endif
+        OS_EXIT();
+
+        mp_thread_finish();
+        return NULL;
+    }
+
+
+    void lv_mp_os_start_render_thread(void (*func)(void *), void *data)
+    {
+        if (render_func != NULL) {
+            mp_raise_msg(&mp_type_RuntimeError, MP_ERROR_TEXT("LVGL render thread is already running"));
+        }
+
+        os_init();
+
+        render_func = func;
+        render_data = data;
+
+        size_t stack_size = LV_MP_OS_RENDER_STACK_SIZE;
+        mp_thread_create(os_render_thread_entry, NULL, &stack_size);
+    }
+
+
+    void lv_mp_os_stop_render_thread(void)
+    {
+        mp_state_thread_t *state = mp_thread_get_state();
+
+        os_init();
+        OS_ENTER();
+
+        // a callback the render thread is waiting on is not able to wait for
+        // it, the thread exits once the callback has returned
+        while (render_func != NULL && call_thread != state) {
+            OS_EXIT();
+
+            lv_mp_os_wake_render_thread();
+            os_run_pending_call();
+            mp_hal_delay_ms(1);
+
+            OS_ENTER();
+        }
+
+        OS_EXIT();
+    }
+
+
+    void lv_mp_os_render_sleep(uint32_t ms)
+    {
+        uint32_t start = mp_hal_ticks_ms();
+        uint32_t elapsed = 0;
+
+        #if LV_USE_OS == LV_OS_PTHREAD
+            struct pollfd pfd = { .fd = os_wake_pipe[0], .events = POLLIN };
+            uint8_t drain[16];
+
+            // a wake up that comes in after render_woken has been checked
+            // leaves a byte in the pipe so poll returns right away
+            while (!render_woken && elapsed < ms) {
+                poll(&pfd, 1, (int)(ms - elapsed));
+                while (read(os_wake_pipe[0], drain, sizeof(drain)) > 0) {}
+                elapsed = mp_hal_ticks_ms() - start;
+            }
+
+            render_woken = false;
+        #else
+            OS_ENTER();
+
+            // os_wait also returns when the lock is given back or a call has
+            // finished, only a wake up cuts the sleep short
+            while (!render_woken && elapsed < ms) {
+                os_wait(ms - elapsed);
+                elapsed = mp_hal_ticks_ms() - start;
+            }
+
+            render_woken = false;
+            OS_EXIT();
+        #endif
+    }
+
+
+    // this is able to be called from an ISR and, with pthreads, from a
+    // signal handler. Nothing in here takes a lock
+    void lv_mp_os_wake_render_thread(void)
+    {
+        render_woken = true;
+
+        #if LV_USE_OS == LV_OS_PTHREAD
+            if (os_wake_pipe[1] != -1) {
+                uint8_t c = 0;
+                // a full pipe is fine, the render thread is woken already
+                ssize_t ret = write(os_wake_pipe[1], &c, 1);
+                LV_UNUSED(ret);
+            }
+        #else
+            if (os_render_task != NULL) {
+                if (xPortInIsrContext()) vTaskNotifyGiveFromISR(os_render_task, NULL);
+                else xTaskNotifyGive(os_render_task);
+            }
+        #endif
+    }
+#endif /* LV_USE_OS != LV_OS_NONE */
+
+
+static mp_obj_t lv_mp_os_unlock_fun(void)
+{
+    #if LV_USE_OS != LV_OS_NONE
+        lv_mp_os_unlock();
+    #endif
+    return mp_const_none;
+}
+
+MP_DEFINE_CONST_FUN_OBJ_0(lv_mp_os_unlock_obj, lv_mp_os_unlock_fun);
+
+
+static mp_obj_t lv_mp_os_lock_enter(mp_obj_t self_in)
+{
+    return self_in;
+}
+
+static MP_DEFINE_CONST_FUN_OBJ_1(lv_mp_os_lock_enter_obj, lv_mp_os_lock_enter);
+
+
+// lv.lock() took the lock, leaving the with block gives it back
+static mp_obj_t lv_mp_os_lock_exit(size_t n_args, const mp_obj_t *args)
+{
+    LV_UNUSED(n_args);
+    LV_UNUSED(args);
+    return lv_mp_os_unlock_fun();
+}
+
+static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(lv_mp_os_lock_exit_obj, 4, 4, lv_mp_os_lock_exit);
+
+
+static const mp_rom_map_elem_t lv_mp_os_lock_locals_dict_table[] = {
+    { MP_ROM_QSTR(MP_QSTR___enter__), MP_ROM_PTR(&lv_mp_os_lock_enter_obj) },
+    { MP_ROM_QSTR(MP_QSTR___exit__),  MP_ROM_PTR(&lv_mp_os_lock_exit_obj)  },
+};
+
+static MP_DEFINE_CONST_DICT(lv_mp_os_lock_locals_dict, lv_mp_os_lock_locals_dict_table);
+
+static MP_DEFINE_CONST_OBJ_TYPE(
+    lv_mp_os_lock_type,
+    MP_QSTR_lock,
+    MP_TYPE_FLAG_NONE,
+    locals_dict, (mp_obj_dict_t *)&lv_mp_os_lock_locals_dict
+);
+
+static const mp_obj_base_t lv_mp_os_lock_singleton = { &lv_mp_os_lock_type };
+
+
+static mp_obj_t lv_mp_os_lock_fun(void)
+{
+    #if LV_USE_OS != LV_OS_NONE
+        lv_mp_os_lock();
+    #endif
+    return MP_OBJ_FROM_PTR(&lv_mp_os_lock_singleton);
+}
+
+MP_DEFINE_CONST_FUN_OBJ_0(lv_mp_os_lock_obj, lv_mp_os_lock_fun);
@@ -0,0 +1,60 @@
+// Copyright (c) 2024 - 2025 Kevin G. Schlosser
+
+#include "py/obj.h"
+#include "lvgl/lvgl.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifndef __LV_MP_OS_H__
+    #define __LV_MP_OS_H__
+
+    // lv.lock() and lv.unlock(). lock() returns an object that is able to be
+    // used as a context manager which calls unlock() when the block is left
+    extern const mp_obj_fun_builtin_fixed_t lv_mp_os_lock_obj;
+    extern const mp_obj_fun_builtin_fixed_t lv_mp_os_unlock_obj;
+
+    #if LV_USE_OS != LV_OS_NONE
+        #if LV_USE_OS != LV_OS_PTHREAD && LV_USE_OS != LV_OS_FREERTOS
+            #error LVGL threads are only supported with LV_OS_PTHREAD and LV_OS_FREERTOS
+        #endif
+
+        #ifndef LV_MP_OS_RENDER_STACK_SIZE
+            #define LV_MP_OS_RENDER_STACK_SIZE  (16 * 1024)
+        #endif
+
+        /*
+        When LVGL is built with an OS the refresh loop runs on a thread of its
+        own, the render thread. It is registered with MicroPython so memory
+        is able to be allocated from it and its stack gets scanned by the GC
+        but it never runs any Python code.
+
+        Python callbacks that LVGL calls from the render thread are handed
+        over to the thread the VM is running on using lv_mp_os_call_in_vm.
+        The render thread waits until the callback has finished.
+
+        lv_mp_os_lock/lv_mp_os_unlock is the lock the render thread holds
+        while it is running LVGL. Python code holds it using lv.lock(). The
+        lock is recursive and a callback that was handed over from the render
+        thread is allowed to take it while the render thread is waiting.
+        */
+        bool lv_mp_os_is_render_thread(void);
+
+        void lv_mp_os_call_in_vm(void (*func)(void *), void *data);
+
+        void lv_mp_os_lock(void);
+        void lv_mp_os_unlock(void);
+
+        void lv_mp_os_start_render_thread(void (*func)(void *), void *data);
+        // wakes the render thread and waits until it has exited, func has to
+        // return once it wakes up. The calls the render thread hands over
+        // are run while waiting
+        void lv_mp_os_stop_render_thread(void);
+
+        // sleeps the render thread for ms milliseconds or until
+        // lv_mp_os_wake_render_thread gets called. Waking it doesn't take a
+        // lock so it is able to be done from an ISR or a signal handler
+        void lv_mp_os_render_sleep(uint32_t ms);
+        void lv_mp_os_wake_render_thread(void);
+    #endif /* LV_USE_OS != LV_OS_NONE */
+#endif /* __LV_MP_OS_H__ */
@@ -0,0 +1,213 @@
+// Copyright (c) 2024 - 2025 Kevin G. Schlosser
+
+#include "py/obj.h"
+#include "py/runtime.h"
+#include "py/mphal.h"
+#include "py/nlr.h"
+#include "py/stream.h"
+#include "py/builtin.h"
+
+#include "lvgl/lvgl.h"
+
+#include "lv_mp_profiler.h"
+
+#include <string.h>
+
+#if LV_USE_PROFILER
+    #if LV_USE_PROFILER_BUILTIN
+        #error LV_USE_PROFILER_BUILTIN has to be 0, the events are recorded by lv_mp_profiler
+    #endif
+
+    #if (LV_MP_PROFILER_BUF_SIZE & (LV_MP_PROFILER_BUF_SIZE - 1)) != 0
+        #error LV_MP_PROFILER_BUF_SIZE has to be a power of 2
+    #endif
+
+    // the copy task of the RGB bus and the render thread are not threads
+    // that MicroPython knows about, the thread id comes from the OS
+    #if defined(ESP_PLATFORM)
+        #include "freertos/FreeRTOS.h"
+        #include "freertos/task.h"
+
+        #define PROFILER_TID()  ((uint32_t)(uintptr_t)xTaskGetCurrentTaskHandle())
+    #elif defined(__unix__) || defined(__APPLE__)
+        #include <pthread.h>
+
+        #define PROFILER_TID()  ((uint32_t)(uintptr_t)pthread_self())
+    #else
+        #define PROFILER_TID()  0
+    #endif
+
+
+    typedef struct _profiler_event_t {
+        const char *name;
+        uint32_t time_us;
+        uint32_t tid;
+        char phase;
+    } profiler_event_t;
+
+
+    static profiler_event_t events[LV_MP_PROFILER_BUF_SIZE];
+    // number of events that have been written, the oldest ones get written
+    // over once the buffer is full
+    static uint32_t event_count = 0;
+    static volatile bool paused = false;
+
+
+    // events are written from more than one thread, each one gets a slot of
+    // its own so no lock is needed
+    static void profiler_add(const char *name, char phase)
+    {
+        if (paused) return;
+
+        uint32_t index = __atomic_fetch_add(&event_count, 1, __ATOMIC_RELAXED);
+        profiler_event_t *event = &events[index & (LV_MP_PROFILER_BUF_SIZE - 1)];
+
+        event->name = name;
+        event->time_us = (uint32_t)mp_hal_ticks_us();
+        event->tid = PROFILER_TID();
+        event->phase = phase;
+    }
+
+
+    void lv_mp_profiler_begin(const char *name)
+    {
+        profiler_add(name, 'B');
+    }
+
+
+    void lv_mp_profiler_end(const char *name)
+    {
+        profiler_add(name, 'E');
+    }
+
+
+    static uint32_t profiler_write_trace(const mp_print_t *print)
+    {
+        uint32_t count = __atomic_load_n(&event_count, __ATOMIC_RELAXED);
+        uint32_t first = 0;
+
+        if (count > LV_MP_PROFILER_BUF_SIZE) {
+            first = count - LV_MP_PROFILER_BUF_SIZE;
+            count = LV_MP_PROFILER_BUF_SIZE;
+        }
+
+        // threads get their slot before they read the clock so the events
+        // are not always in order, the time stamps start at the earliest one
+        uint32_t base = events[first & (LV_MP_PROFILER_BUF_SIZE - 1)].time_us;
+        for (uint32_t i = 1; i < count; i++) {
+            uint32_t time_us = events[(first + i) & (LV_MP_PROFILER_BUF_SIZE - 1)].time_us;
+            if ((int32_t)(time_us - base) < 0) base = time_us;
+        }
+
+        mp_print_str(print, "{\"traceEvents\":[");
+
+        for (uint32_t i = 0; i < count; i++) {
+            profiler_event_t *event = &events[(first + i) & (LV_MP_PROFILER_BUF_SIZE - 1)];
+
+            mp_printf(print, "%s\n{\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%u,\"pid\":1,\"tid\":%u}",
+                i == 0 ? "" : ",", event->name, event->phase,
+                (unsigned int)(event->time_us - base), (unsigned int)event->tid);
+        }
+
+        mp_print_str(print, "\n],\"displayTimeUnit\":\"ms\"}\n");
+        return count;
+    }
+
+
+    // writing to a file one event at a time is slow on flash
+    typedef struct _profiler_writer_t {
+        mp_print_t print;
+        mp_obj_t stream;
+        size_t len;
+        char buf[256];
+    } profiler_writer_t;
+
+
+    static void profiler_writer_flush(profiler_writer_t *writer)
+    {
+        if (writer->len == 0) return;
+
+        mp_stream_write(writer->stream, writer->buf, writer->len, MP_STREAM_RW_WRITE);
+        writer->len = 0;
+    }
+
+
+    static void profiler_writer_strn(void *data, const char *str, size_t len)
+    {
+        profiler_writer_t *writer = (profiler_writer_t *)data;
+
+        while (len > 0) {
+            if (writer->len == sizeof(writer->buf)) profiler_writer_flush(writer);
+
+            size_t chunk = MIN(len, sizeof(writer->buf) - writer->len);
+            memcpy(writer->buf + writer->len, str, chunk);
+            writer->len += chunk;
+            str += chunk;
+            len -= chunk;
+        }
+    }
+
+
+    /*
+    lv.profiler_dump(file=None)
+
+    Writes the events in the buffer as Chrome trace JSON. file is either a
+    path that gets written to or an opened stream, the JSON is printed when
+    it is not given. Returns the number of events that were written. Nothing
+    gets recorded while the buffer is being written.
+    */
+    static mp_obj_t lv_mp_profiler_dump(size_t n_args, const mp_obj_t *args)
+    {
+        mp_obj_t file = n_args == 1 ? args[0] : mp_const_none;
+        uint32_t count = 0;
+
+        paused = true;
+
+        if (file == mp_const_none) {
+            count = profiler_write_trace(&mp_plat_print);
+            paused = false;
+            return mp_obj_new_int_from_uint(count);
+        }
+
+        bool is_path = mp_obj_is_str(file);
+        if (is_path) {
+            mp_obj_t open_args[2] = { file, MP_OBJ_NEW_QSTR(MP_QSTR_w) };
+            file = mp_builtin_open(2, open_args, (mp_map_t *)&mp_const_empty_map);
+        }
+
+        profiler_writer_t writer;
+        writer.print.data = &writer;
+        writer.print.print_strn = profiler_writer_strn;
+        writer.stream = file;
+        writer.len = 0;
+
+        nlr_buf_t nlr;
+        if (nlr_push(&nlr) == 0) {
+            mp_get_stream_raise(file, MP_STREAM_OP_WRITE);
+            count = profiler_write_trace(&writer.print);
+            profiler_writer_flush(&writer);
+            nlr_pop();
+        } else {
+            paused = false;
+            if (is_path) mp_stream_close(file);
+            nlr_jump(nlr.ret_val);
+        }
+
+        paused = false;
+        if (is_path) mp_stream_close(file);
+
+        return mp_obj_new_int_from_uint(count);
+    }
+
+    MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(lv_mp_profiler_dump_obj, 0, 1, lv_mp_profiler_dump);
+
+
+    // lv.profiler_reset() throws away the events in the buffer
+    static mp_obj_t lv_mp_profiler_reset(void)
+    {
+        __atomic_store_n(&event_count, 0, __ATOMIC_RELAXED);
+        return mp_const_none;
+    }
+
+    MP_DEFINE_CONST_FUN_OBJ_0(lv_mp_profiler_reset_obj, lv_mp_profiler_reset);
+#endif /* LV_USE_PROFILER */
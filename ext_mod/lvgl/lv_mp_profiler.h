@@ -0,0 +1,39 @@
+// Copyright (c) 2024 - 2025 Kevin G. Schlosser
+
+#ifndef __LV_MP_PROFILER_H__
+    #define __LV_MP_PROFILER_H__
+
+    /*
+    The profiler LVGL gets built with when LV_USE_PROFILER is set, this is
+    the header LV_PROFILER_INCLUDE points to. Begin and end events are
+    written into a ring buffer along with a microsecond time stamp and the
+    thread that wrote them. lv.profiler_dump() writes the buffer out as
+    Chrome trace JSON that is able to be opened in chrome://tracing or
+    Perfetto.
+
+    lcd_bus includes this header as well so sending the frame to the display
+    shows up in the same trace. It doesn't include anything from LVGL or
+    MicroPython and the macros do nothing when the profiler is not built in.
+    */
+    #if defined(LV_USE_PROFILER) && LV_USE_PROFILER
+        // number of events the ring buffer holds, has to be a power of 2
+        #ifndef LV_MP_PROFILER_BUF_SIZE
+            #define LV_MP_PROFILER_BUF_SIZE  1024
+        #endif
+
+        #ifndef PYCPARSER
+            void lv_mp_profiler_begin(const char *name);
+            void lv_mp_profiler_end(const char *name);
+        #endif
+
+        // name has to stay valid, only the pointer gets stored
+        #define LV_MP_PROFILER_BEGIN_TAG(name)  lv_mp_profiler_begin(name)
+        #define LV_MP_PROFILER_END_TAG(name)    lv_mp_profiler_end(name)
+    #else
+        #define LV_MP_PROFILER_BEGIN_TAG(name)
+        #define LV_MP_PROFILER_END_TAG(name)
+    #endif
+
+    #define LV_MP_PROFILER_BEGIN  LV_MP_PROFILER_BEGIN_TAG(__func__)
+    #define LV_MP_PROFILER_END    LV_MP_PROFILER_END_TAG(__func__)
+#endif /* __LV_MP_PROFILER_H__ */
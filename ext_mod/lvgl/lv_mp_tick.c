@@ -0,0 +1,73 @@
+// Copyright (c) 2024 - 2025 Kevin G. Schlosser
+
+// LVGL's clock. lv.init() hands LVGL mp_hal_ticks_ms as its tick source so
+// nothing has to call lv_tick_inc to keep LVGL's time and animations run
+// off of the same clock as the rest of MicroPython.
+//
+// Code that steps LVGL's clock itself (benchmarks, tests) still calls
+// lv.tick_inc(). The first call hands the clock back to lv_tick_inc, it
+// carries on from the time it was at so timers and animations don't jump.
+// lv.tick_set_native() goes back to mp_hal_ticks_ms, again carrying on from
+// the time LVGL's clock is at.
+
+#include "py/obj.h"
+#include "py/runtime.h"
+#include "py/mphal.h"
+
+#include "lvgl/lvgl.h"
+
+
+static bool native_tick = false;
+// difference between LVGL's clock and mp_hal_ticks_ms after going back to it
+static uint32_t tick_offset = 0;
+
+
+static uint32_t lv_mp_tick_get(void)
+{
+    return (uint32_t)mp_hal_ticks_ms() + tick_offset;
+}
+
+
+static mp_obj_t lv_mp_tick_init(void)
+{
+    lv_init();
+    tick_offset = 0;
+    lv_tick_set_cb(lv_mp_tick_get);
+    native_tick = true;
+    return mp_const_none;
+}
+
+MP_DEFINE_CONST_FUN_OBJ_0(lv_mp_tick_init_obj, lv_mp_tick_init);
+
+
+static mp_obj_t lv_mp_tick_inc(mp_obj_t tick_period_in)
+{
+    uint32_t tick_period = (uint32_t)mp_obj_get_int_truncated(tick_period_in);
+
+    if (native_tick) {
+        uint32_t now = lv_tick_get();
+        lv_tick_set_cb(NULL);
+        native_tick = false;
+        // lv_tick_get returns the time lv_tick_inc has counted up to now
+        lv_tick_inc(now - lv_tick_get());
+    }
+
+    lv_tick_inc(tick_period);
+    return mp_const_none;
+}
+
+MP_DEFINE_CONST_FUN_OBJ_1(lv_mp_tick_inc_obj, lv_mp_tick_inc);
+
+
+static mp_obj_t lv_mp_tick_set_native(void)
+{
+    if (!native_tick) {
+        tick_offset = lv_tick_get() - (uint32_t)mp_hal_ticks_ms();
+        lv_tick_set_cb(lv_mp_tick_get);
+        native_tick = true;
+    }
+
+    return mp_const_none;
+}
+
+MP_DEFINE_CONST_FUN_OBJ_0(lv_mp_tick_set_native_obj, lv_mp_tick_set_native);
@@ -10,21 +10,134 @@
 #include <py/mpconfig.h>
 #include <py/misc.h>
 #include <py/gc.h>
+
+#if LV_USE_OS != LV_OS_NONE
+#include <string.h>
+#include <py/obj.h>
+#include <py/runtime.h>
+#include <py/mpstate.h>
+#include <py/mpthread.h>
+#include "lv_mp_os.h"
+
+#if LV_USE_OS == LV_OS_PTHREAD
+#include <pthread.h>
+#include <unistd.h>
+#else
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#endif
+#endif
 /*********************
  *      DEFINES
  *********************/
 
+#if LV_USE_OS != LV_OS_NONE && MICROPY_PY_THREAD_GIL
+/*When the GIL is used the GC relies on it. The render thread doesn't hold the
+ *GIL because it doesn't run Python code so it takes the GIL for as long as
+ *it takes to get the memory*/
+#define MEM_ENTER() bool take_gil = lv_mp_os_is_render_thread(); if(take_gil) MP_THREAD_GIL_ENTER()
+#define MEM_EXIT()  if(take_gil) MP_THREAD_GIL_EXIT()
+#else
+#define MEM_ENTER()
+#define MEM_EXIT()
+#endif
+
+#if LV_USE_OS != LV_OS_NONE
+#ifndef LV_MP_MEM_CHUNK_SIZE
+/*Size of the chunks LVGL's memory is handed out from, a chunk is made larger
+ *when an allocation doesn't fit in it*/
+#define LV_MP_MEM_CHUNK_SIZE    (32 * 1024)
+#endif
+
+#ifndef LV_MP_MEM_RESERVE_SIZE
+/*Only the threads MicroPython knows about are able to add chunks. They keep
+ *at least this much free so the draw threads (decoding an image) normally
+ *don't run out. Chunks that become completely free are handed back to the
+ *GC as long as this much is left after it*/
+#define LV_MP_MEM_RESERVE_SIZE  LV_MP_MEM_CHUNK_SIZE
+#endif
+
+#ifndef LV_MP_MEM_REQUEST_TIMEOUT_MS
+/*When the reserve isn't large enough a draw thread asks the VM thread for a
+ *chunk and waits this long for it before the allocation fails*/
+#define LV_MP_MEM_REQUEST_TIMEOUT_MS  (500)
+#endif
+
+#define MEM_ALIGN               (8)
+#define MEM_ALIGN_UP(x)         (((x) + MEM_ALIGN - 1) & ~(size_t)(MEM_ALIGN - 1))
+#define MEM_HEADER_SIZE         MEM_ALIGN_UP(sizeof(size_t))
+#define MEM_MIN_BLOCK_SIZE      MEM_ALIGN_UP(sizeof(mem_block_t))
+#define MEM_CHUNK_HEADER_SIZE   MEM_ALIGN_UP(sizeof(mem_chunk_t))
+
+#if LV_USE_OS == LV_OS_PTHREAD
+#define MEM_LOCK()      pthread_mutex_lock(&mem_mutex)
+#define MEM_UNLOCK()    pthread_mutex_unlock(&mem_mutex)
+#define MEM_SLEEP_MS(ms) usleep((ms) * 1000)
+#else
+#define MEM_LOCK()      xSemaphoreTake(mem_mutex, portMAX_DELAY)
+#define MEM_UNLOCK()    xSemaphoreGive(mem_mutex)
+#define MEM_SLEEP_MS(ms) vTaskDelay(pdMS_TO_TICKS(ms) > 0 ? pdMS_TO_TICKS(ms) : 1)
+#endif
+#endif
+
 /**********************
  *      TYPEDEFS
  **********************/
+#if LV_USE_OS != LV_OS_NONE
+/*size is the size of the whole block including the header. Only the size
+ *is kept while the block is in use, the memory after it is handed out*/
+typedef struct mem_block_t {
+    size_t size;
+    struct mem_block_t * next;
+} mem_block_t;
+
+typedef struct mem_chunk_t {
+    struct mem_chunk_t * next;
+    size_t size;
+} mem_chunk_t;
+#endif
 
 /**********************
  *  STATIC PROTOTYPES
  **********************/
+#if LV_USE_OS != LV_OS_NONE
+static bool mem_is_foreign_thread(void);
+static void * mem_alloc(size_t size);
+static void mem_free(void * p);
+static mem_chunk_t * mem_free_block(mem_block_t * block, bool release);
+static mem_chunk_t * mem_unlink_chunk(mem_block_t * block, mem_block_t ** block_prev);
+static void mem_release_chunks(void);
+static bool mem_add_chunk(size_t size);
+static void mem_fill_reserve(void);
+static void * mem_request_alloc(size_t size);
+static void mem_serve_request(void);
+#endif
 
 /**********************
  *  STATIC VARIABLES
  **********************/
+#if LV_USE_OS != LV_OS_NONE
+#if LV_USE_OS == LV_OS_PTHREAD
+static pthread_mutex_t mem_mutex = PTHREAD_MUTEX_INITIALIZER;
+#else
+static SemaphoreHandle_t mem_mutex = NULL;
+#endif
+
+/*free blocks of all of the chunks sorted by address. The chunks are kept
+ *alive by the lv_mp_mem_chunks root pointer*/
+static mem_block_t * mem_free_list = NULL;
+/*number of bytes in the free blocks*/
+static size_t mem_free_size = 0;
+/*set when a draw thread freed memory, a chunk might be completely free*/
+static bool mem_release_pending = false;
+
+/*the largest chunk the draw threads are waiting on, 0 when none are.
+ *mem_request_served goes up every time the requests have been handled*/
+static size_t mem_request_size = 0;
+static uint32_t mem_request_served = 0;
+static bool mem_request_scheduled = false;
+#endif
 
 /**********************
  *      MACROS
@@ -36,13 +149,26 @@
 
 void lv_mem_init(void)
 {
-    return; /*Nothing to init*/
+#if LV_USE_OS == LV_OS_FREERTOS
+    if(mem_mutex == NULL) mem_mutex = xSemaphoreCreateMutex();
+#endif
+    return;
 }
 
 void lv_mem_deinit(void)
 {
-    return; /*Nothing to deinit*/
-
+#if LV_USE_OS != LV_OS_NONE
+    /*The chunks get collected by the GC*/
+    MEM_LOCK();
+    mem_free_list = NULL;
+    mem_free_size = 0;
+    mem_release_pending = false;
+    mem_request_size = 0;
+    mem_request_served++;
+    MP_STATE_VM(lv_mp_mem_chunks) = NULL;
+    MEM_UNLOCK();
+#endif
+    return;
 }
 
 lv_mem_pool_t lv_mem_add_pool(void * mem, size_t bytes)
@@ -62,31 +188,74 @@ void lv_mem_remove_pool(lv_mem_pool_t pool)
 
 void * lv_malloc_core(size_t size)
 {
+    void * p;
+
+#if LV_USE_OS != LV_OS_NONE
+    p = mem_alloc(size);
+
+    /*The draw threads are not able to use the GC so only the other threads
+     *add chunks, a draw thread waits for one of them to do it*/
+    if(mem_is_foreign_thread()) {
+        if(p == NULL) p = mem_request_alloc(size);
+    }
+    else {
+        if(p == NULL && mem_add_chunk(size)) p = mem_alloc(size);
+        mem_serve_request();
+        mem_fill_reserve();
+        mem_release_chunks();
+    }
+#else
+    MEM_ENTER();
 #if MICROPY_MALLOC_USES_ALLOCATED_SIZE
-    return gc_alloc(size, true);
+    p = gc_alloc(size, true);
 #else
-    return m_malloc(size);
+    p = m_malloc(size);
+#endif
+    MEM_EXIT();
 #endif
+
+    return p;
 }
 
 void * lv_realloc_core(void * p, size_t new_size)
 {
+#if LV_USE_OS != LV_OS_NONE
+    if(p == NULL) return lv_malloc_core(new_size);
+
+    size_t size = ((mem_block_t *)((uint8_t *)p - MEM_HEADER_SIZE))->size - MEM_HEADER_SIZE;
+    if(new_size <= size) return p;
 
+    void * new_p = lv_malloc_core(new_size);
+    if(new_p != NULL) {
+        memcpy(new_p, p, size);
+        mem_free(p);
+    }
+    p = new_p;
+#else
+    MEM_ENTER();
 #if MICROPY_MALLOC_USES_ALLOCATED_SIZE
-    return gc_realloc(p, new_size, true);
+    p = gc_realloc(p, new_size, true);
 #else
-    return m_realloc(p, new_size);
+    p = m_realloc(p, new_size);
+#endif
+    MEM_EXIT();
 #endif
+
+    return p;
 }
 
 void lv_free_core(void * p)
 {
-
+#if LV_USE_OS != LV_OS_NONE
+    mem_free(p);
+#else
+    MEM_ENTER();
 #if MICROPY_MALLOC_USES_ALLOCATED_SIZE
     gc_free(p);
-
 #else
     m_free(p);
+#endif
+    MEM_EXIT();
 #endif
 }
 
@@ -107,4 +276,294 @@ lv_result_t lv_mem_test_core(void)
  *   STATIC FUNCTIONS
  **********************/
 
+#if LV_USE_OS != LV_OS_NONE
+
+/*LVGL's draw threads are not known to MicroPython. The GC is not able to be
+ *used from them and their stacks don't get scanned, yet the draw threads
+ *put memory they allocate into structures that are shared with the other
+ *threads (the image cache, linked lists) and that point into the GC heap.
+ *So all of LVGL's memory comes from one heap: chunks that are allocated from
+ *the GC heap and handed out by the allocator below, which is able to be used
+ *from any thread. The chunks are never collected while LVGL is initialized
+ *and the GC scans all of them, so anything LVGL points to stays alive no
+ *matter which thread allocated the memory it is pointed to from.*/
+static bool mem_is_foreign_thread(void)
+{
+    return mp_thread_get_state() == NULL;
+}
+
+static void * mem_alloc(size_t size)
+{
+    size = MEM_ALIGN_UP(size + MEM_HEADER_SIZE);
+    if(size < MEM_MIN_BLOCK_SIZE) size = MEM_MIN_BLOCK_SIZE;
+
+    MEM_LOCK();
+
+    mem_block_t ** prev = &mem_free_list;
+    mem_block_t * block = mem_free_list;
+
+    while(block != NULL && block->size < size) {
+        prev = &block->next;
+        block = block->next;
+    }
+
+    if(block != NULL) {
+        if(block->size - size >= MEM_MIN_BLOCK_SIZE) {
+            mem_block_t * rest = (mem_block_t *)((uint8_t *)block + size);
+            rest->size = block->size - size;
+            rest->next = block->next;
+            block->size = size;
+            *prev = rest;
+        }
+        else {
+            *prev = block->next;
+        }
+        mem_free_size -= block->size;
+    }
+
+    MEM_UNLOCK();
+
+    if(block == NULL) return NULL;
+    return (uint8_t *)block + MEM_HEADER_SIZE;
+}
+
+static void mem_free(void * p)
+{
+    if(p == NULL) return;
+
+    mem_block_t * block = (mem_block_t *)((uint8_t *)p - MEM_HEADER_SIZE);
+
+    /*the GC would keep whatever is still pointed to from here alive*/
+    memset(p, 0, block->size - MEM_HEADER_SIZE);
+
+    /*the draw threads are not able to give memory back to the GC*/
+    mem_chunk_t * chunk = mem_free_block(block, !mem_is_foreign_thread());
+
+    if(chunk != NULL) {
+        MEM_ENTER();
+        gc_free(chunk);
+        MEM_EXIT();
+    }
+}
+
+/*Puts the block back into the free list. When release is set and the block
+ *ends up covering a whole chunk the chunk is taken out and returned so it is
+ *able to be handed back to the GC*/
+static mem_chunk_t * mem_free_block(mem_block_t * block, bool release)
+{
+    MEM_LOCK();
+
+    mem_free_size += block->size;
+
+    mem_block_t * prev = NULL;
+    mem_block_t * next = mem_free_list;
+
+    while(next != NULL && next < block) {
+        prev = next;
+        next = next->next;
+    }
+
+    /*the chunk header is between 2 chunks so blocks of different chunks
+     *never get merged*/
+    if(next != NULL && (uint8_t *)block + block->size == (uint8_t *)next) {
+        block->size += next->size;
+        block->next = next->next;
+    }
+    else {
+        block->next = next;
+    }
+
+    if(prev != NULL && (uint8_t *)prev + prev->size == (uint8_t *)block) {
+        prev->size += block->size;
+        prev->next = block->next;
+        block = prev;
+    }
+    else if(prev != NULL) {
+        prev->next = block;
+    }
+    else {
+        mem_free_list = block;
+    }
+
+    mem_chunk_t * chunk = NULL;
+
+    if(release) chunk = mem_unlink_chunk(block, NULL);
+    else mem_release_pending = true;
+
+    MEM_UNLOCK();
+
+    return chunk;
+}
+
+/*Takes the chunk out if the free block covers all of it and the reserve is
+ *still there without it. Has to be called with the lock held. block_prev
+ *points to where the block is linked from, NULL to look for it*/
+static mem_chunk_t * mem_unlink_chunk(mem_block_t * block, mem_block_t ** block_prev)
+{
+    if(block->size < LV_MP_MEM_CHUNK_SIZE - MEM_CHUNK_HEADER_SIZE) return NULL;
+    if(mem_free_size - block->size < LV_MP_MEM_RESERVE_SIZE) return NULL;
+
+    mem_chunk_t ** chunk_prev = (mem_chunk_t **)&MP_STATE_VM(lv_mp_mem_chunks);
+    mem_chunk_t * chunk = *chunk_prev;
+
+    while(chunk != NULL && (uint8_t *)chunk + MEM_CHUNK_HEADER_SIZE != (uint8_t *)block) {
+        chunk_prev = &chunk->next;
+        chunk = chunk->next;
+    }
+
+    if(chunk == NULL || block->size != chunk->size - MEM_CHUNK_HEADER_SIZE) return NULL;
+
+    *chunk_prev = chunk->next;
+
+    if(block_prev == NULL) {
+        block_prev = &mem_free_list;
+        while(*block_prev != block) block_prev = &(*block_prev)->next;
+    }
+    *block_prev = block->next;
+
+    mem_free_size -= block->size;
+
+    return chunk;
+}
+
+/*Hands a chunk the draw threads have freed back to the GC, one per call.
+ *Only called from the threads MicroPython knows about*/
+static void mem_release_chunks(void)
+{
+    mem_chunk_t * chunk = NULL;
+
+    MEM_LOCK();
+
+    if(mem_release_pending) {
+        mem_release_pending = false;
+
+        mem_block_t ** block_prev = &mem_free_list;
+        while(*block_prev != NULL && chunk == NULL) {
+            chunk = mem_unlink_chunk(*block_prev, block_prev);
+            if(chunk == NULL) block_prev = &(*block_prev)->next;
+        }
+
+        /*there might be more of them*/
+        if(chunk != NULL) mem_release_pending = true;
+    }
+
+    MEM_UNLOCK();
+
+    if(chunk != NULL) {
+        MEM_ENTER();
+        gc_free(chunk);
+        MEM_EXIT();
+    }
+}
+
+static bool mem_add_chunk(size_t size)
+{
+    size = MEM_CHUNK_HEADER_SIZE + MEM_ALIGN_UP(size + MEM_HEADER_SIZE);
+    if(size < LV_MP_MEM_CHUNK_SIZE) size = LV_MP_MEM_CHUNK_SIZE;
+
+    MEM_ENTER();
+    /*m_malloc raises MemoryError, that isn't able to get out of the render thread*/
+    mem_chunk_t * chunk = gc_alloc(size, false);
+    MEM_EXIT();
+
+    if(chunk == NULL) return false;
+
+    mem_block_t * block = (mem_block_t *)((uint8_t *)chunk + MEM_CHUNK_HEADER_SIZE);
+
+    MEM_LOCK();
+    chunk->size = size;
+    chunk->next = MP_STATE_VM(lv_mp_mem_chunks);
+    MP_STATE_VM(lv_mp_mem_chunks) = chunk;
+    MEM_UNLOCK();
+
+    /*the memory after the header becomes one free block*/
+    block->size = size - MEM_CHUNK_HEADER_SIZE;
+    mem_free_block(block, false);
+
+    return true;
+}
+
+/*only called from the threads MicroPython knows about*/
+static void mem_fill_reserve(void)
+{
+    MEM_LOCK();
+    bool low = mem_free_size < LV_MP_MEM_RESERVE_SIZE;
+    MEM_UNLOCK();
+
+    if(low) mem_add_chunk(LV_MP_MEM_RESERVE_SIZE);
+}
+
+static mp_obj_t mem_serve_request_cb(mp_obj_t arg)
+{
+    LV_UNUSED(arg);
+    mem_serve_request();
+    return mp_const_none;
+}
+
+static MP_DEFINE_CONST_FUN_OBJ_1(mem_serve_request_cb_obj, mem_serve_request_cb);
+
+/*Called from a draw thread. The chunk gets added by the VM thread or by the
+ *next allocation the render thread makes. Another draw thread is able to
+ *take the memory first so it keeps asking until the allocation fits or
+ *LV_MP_MEM_REQUEST_TIMEOUT_MS has passed*/
+static void * mem_request_alloc(size_t size)
+{
+    void * p = NULL;
+    uint32_t waited = 0;
+
+    while(p == NULL && waited < LV_MP_MEM_REQUEST_TIMEOUT_MS) {
+        MEM_LOCK();
+        if(size > mem_request_size) mem_request_size = size;
+        uint32_t served = mem_request_served;
+        MEM_UNLOCK();
+
+        bool done = false;
+
+        while(!done && waited < LV_MP_MEM_REQUEST_TIMEOUT_MS) {
+            MEM_LOCK();
+            done = mem_request_served != served;
+            bool schedule = !done && !mem_request_scheduled;
+            if(schedule) mem_request_scheduled = true;
+            MEM_UNLOCK();
+
+            if(done) break;
+
+            /*if the schedule queue is full it is tried again in a bit*/
+            if(schedule && !mp_sched_schedule(MP_OBJ_FROM_PTR(&mem_serve_request_cb_obj), mp_const_none)) {
+                MEM_LOCK();
+                mem_request_scheduled = false;
+                MEM_UNLOCK();
+            }
+
+            MEM_SLEEP_MS(1);
+            waited++;
+        }
+
+        p = mem_alloc(size);
+    }
+
+    return p;
+}
+
+/*only called from the threads MicroPython knows about*/
+static void mem_serve_request(void)
+{
+    MEM_LOCK();
+    size_t size = mem_request_size;
+    mem_request_size = 0;
+    if(size == 0) mem_request_scheduled = false;
+    MEM_UNLOCK();
+
+    if(size == 0) return;
+
+    mem_add_chunk(size);
+
+    MEM_LOCK();
+    mem_request_scheduled = false;
+    mem_request_served++;
+    MEM_UNLOCK();
+}
+
+#endif /*LV_USE_OS != LV_OS_NONE*/
+
 #endif /*LV_STDLIB_MICROPYTHON*/
\ No newline at end of file
@@ -31,7 +31,7 @@ if(${SECOND_BUILD_ENV} EQUAL "0")
 
     execute_process(
         COMMAND
-            ${Python3_EXECUTABLE} ${BINDING_DIR}/gen/$ENV{GEN_SCRIPT}_api_gen_mpy.py ${LV_CFLAGS} --output=${CMAKE_BINARY_DIR}/lv_mp.c --include=${BINDING_DIR}/lib --include=${BINDING_DIR}/lib/lvgl --board=$ENV{LV_PORT} --module_name=lvgl --module_prefix=lv --metadata=${CMAKE_BINARY_DIR}/lv_mp.c.json --header_file=${LVGL_DIR}/lvgl.h
+            ${Python3_EXECUTABLE} ${BINDING_DIR}/gen/$ENV{GEN_SCRIPT}_api_gen_mpy.py ${LV_CFLAGS} --output=${CMAKE_BINARY_DIR}/lv_mp.c --include=${BINDING_DIR}/lib --include=${BINDING_DIR}/lib/lvgl --include=${BINDING_DIR}/ext_mod/lvgl --board=$ENV{LV_PORT} --module_name=lvgl --module_prefix=lv --metadata=${CMAKE_BINARY_DIR}/lv_mp.c.json --header_file=${LVGL_DIR}/lvgl.h
         WORKING_DIRECTORY
             ${CMAKE_CURRENT_LIST_DIR}
 
@@ -62,10 +62,19 @@ set(LVGL_MPY_INCLUDES
     ${BINDING_DIR}/lib/micropython
     ${BINDING_DIR}/lib
     ${BINDING_DIR}/lib/lvgl
+    ${BINDING_DIR}/ext_mod/lvgl
+    ${BINDING_DIR}/ext_mod/lcd_bus
 )
 
 add_library(usermod_lvgl INTERFACE)
-target_sources(usermod_lvgl INTERFACE ${CMAKE_BINARY_DIR}/lv_mp.c)
+target_sources(usermod_lvgl INTERFACE
+    ${CMAKE_BINARY_DIR}/lv_mp.c
+    ${BINDING_DIR}/ext_mod/lvgl/task_handler.c
+    ${BINDING_DIR}/ext_mod/lvgl/lv_mp_os.c
+    ${BINDING_DIR}/ext_mod/lvgl/lv_mp_tick.c
+    ${BINDING_DIR}/ext_mod/lvgl/lv_mp_profiler.c
+    ${BINDING_DIR}/ext_mod/lvgl/lv_mp_flush.c
+)
 target_include_directories(usermod_lvgl INTERFACE ${LVGL_MPY_INCLUDES})
 target_link_libraries(usermod_lvgl INTERFACE lvgl_interface)
 target_link_libraries(usermod INTERFACE usermod_lvgl)
@@ -13,6 +13,9 @@ LVGL_DIR = $(LVGL_BINDING_DIR)/lib/lvgl
 CURRENT_DIR = $(LVGL_BINDING_DIR)/ext_mod/lvgl
 CFLAGS_USERMOD += -I$(LVGL_DIR)
 CFLAGS_USERMOD += -I$(LIB_DIR)
+CFLAGS_USERMOD += -I$(CURRENT_DIR)
+# lv_mp_flush.c uses lcd_types.h
+CFLAGS_USERMOD += -I$(LVGL_BINDING_DIR)/ext_mod/lcd_bus
 
 
 ifdef LV_CFLAGS
@@ -33,12 +36,17 @@ LVGL_MPY_METADATA = $(BUILD)/lv_mpy.json
 SRC_USERMOD_LIB_C += $(shell find $(LVGL_DIR)/src -type f -name "*.c")
 SRC_USERMOD_LIB_C += $(CURRENT_DIR)/mem_core.c
 SRC_USERMOD_C += $(LVGL_MPY)
+SRC_USERMOD_C += $(CURRENT_DIR)/task_handler.c
+SRC_USERMOD_C += $(CURRENT_DIR)/lv_mp_os.c
+SRC_USERMOD_C += $(CURRENT_DIR)/lv_mp_tick.c
+SRC_USERMOD_C += $(CURRENT_DIR)/lv_mp_profiler.c
+SRC_USERMOD_C += $(CURRENT_DIR)/lv_mp_flush.c
 
 $(LVGL_MPY): $(ALL_LVGL_SRC) $(LVGL_BINDING_DIR)/gen/$(GEN_SCRIPT)_api_gen_mpy.py
 	$(ECHO) "LVGL-GEN $@"
 	$(Q)mkdir -p $(dir $@)
 
-	$(Q)$(PYTHON) $(LVGL_BINDING_DIR)/gen/$(GEN_SCRIPT)_api_gen_mpy.py $(LV_CFLAGS) --board=$(LV_PORT) --output=$(LVGL_MPY)  --include=$(LIB_DIR) --include=$(LVGL_DIR)  --module_name=lvgl --module_prefix=lv --metadata=$(LVGL_MPY_METADATA) --header_file=$(LVGL_DIR)/lvgl.h
+	$(Q)$(PYTHON) $(LVGL_BINDING_DIR)/gen/$(GEN_SCRIPT)_api_gen_mpy.py $(LV_CFLAGS) --board=$(LV_PORT) --output=$(LVGL_MPY)  --include=$(LIB_DIR) --include=$(LVGL_DIR) --include=$(CURRENT_DIR)  --module_name=lvgl --module_prefix=lv --metadata=$(LVGL_MPY_METADATA) --header_file=$(LVGL_DIR)/lvgl.h
 
 .PHONY: LVGL_MPY
 LVGL_MPY: $(LVGL_MPY)
@@ -0,0 +1,612 @@
+// Copyright (c) 2024 - 2025 Kevin G. Schlosser
+
+// Native part of the task_handler module. The timer callback, scheduling the
+// update and calling lv_timer_handler all happen here so no Python code runs
+// for a frame unless callbacks have been registered. LVGL's clock is
+// mp_hal_ticks_ms, it gets set by lv.init() (see lv_mp_tick.c).
+//
+// The timer period follows what lv_timer_handler returns, which is the time
+// until the next LVGL timer is due. It never goes below `duration` and never
+// above `max_period`. When LVGL has nothing to do the handler sleeps until
+// an LVGL timer gets resumed or created (this is what happens when an area
+// is invalidated), `wake()` is called or `max_period` has passed.
+//
+// The read timers of the indevs run every LV_DEF_REFR_PERIOD, which would
+// keep the handler from ever sleeping. Once none of the indevs that are
+// read by a timer are pressed or scrolling their read timers get paused and
+// the handler reads them itself every `input_idle_period` or when `wake()`
+// is called. The read timers are resumed as soon as one of them has input.
+//
+// When LVGL is built with an OS (LV_USE_OS) there is no machine.Timer. The
+// same loop runs on the render thread from lv_mp_os.c holding the LVGL lock,
+// and the Python callbacks are handed over to the VM thread.
+
+#include "py/obj.h"
+#include "py/runtime.h"
+#include "py/nlr.h"
+
+#include "lvgl/lvgl.h"
+#include "lv_mp_os.h"
+
+#include <stdbool.h>
+
+
+#define TASK_HANDLER_STARTED   (0x01)
+#define TASK_HANDLER_FINISHED  (0x02)
+
+// most indevs that are able to have their read timers paused
+#define TASK_HANDLER_IDLE_INDEVS  (8)
+
+// number of threads the software renderer draws with
+#if LV_USE_DRAW_SW
+    #define TASK_HANDLER_DRAW_UNITS  LV_DRAW_SW_DRAW_UNIT_CNT
+#else
+    #define TASK_HANDLER_DRAW_UNITS  0
+#endif
+
+// defined in the generated LVGL binding. It is not 0 while LVGL is calling
+// into Python code
+extern int lv_mp_get_nesting(void);
+
+
+typedef struct _mp_task_handler_obj_t {
+    mp_obj_base_t base;
+
+    mp_obj_t callbacks;                // list of (callback, event, user_data)
+    mp_obj_t exception_hook;
+    mp_obj_t callback_exception_hook;  // None prints the exception
+
+    mp_obj_t timer;
+    mp_obj_t timer_cb;
+    mp_obj_t timer_periodic;
+
+    uint32_t duration;
+    uint32_t max_period;
+    uint32_t period;
+
+    // indevs that have had their read timers paused, see task_handler_pause_indevs
+    uint32_t input_idle_period;
+    uint32_t input_read_time;
+    lv_indev_t *idle_indevs[TASK_HANDLER_IDLE_INDEVS];
+    uint8_t idle_indev_count;
+    volatile bool input_woken;
+
+    mp_int_t disabled;
+
+    bool active;
+    bool scheduled;
+    bool running;
+} mp_task_handler_obj_t;
+
+
+static mp_obj_t task_handler_run(mp_obj_t self_in);
+static MP_DEFINE_CONST_FUN_OBJ_1(task_handler_run_obj, task_handler_run);
+
+static mp_obj_t task_handler_timer_cb(mp_obj_t self_in, mp_obj_t timer);
+static MP_DEFINE_CONST_FUN_OBJ_2(task_handler_timer_cb_obj, task_handler_timer_cb);
+
+#if LV_USE_OS != LV_OS_NONE
+    static void task_handler_render_loop(void *data);
+#endif
+
+
+// (re)starts the machine.Timer, this only gets done when the period changes
+static void task_handler_set_period(mp_task_handler_obj_t *self, uint32_t period)
+{
+    if (period == self->period) return;
+
+    #if LV_USE_OS == LV_OS_NONE
+        mp_obj_t args[9];
+        mp_load_method(self->timer, MP_QSTR_init, args);
+        args[2] = MP_OBJ_NEW_QSTR(MP_QSTR_mode);
+        args[3] = self->timer_periodic;
+        args[4] = MP_OBJ_NEW_QSTR(MP_QSTR_period);
+        args[5] = mp_obj_new_int_from_uint(period);
+        args[6] = MP_OBJ_NEW_QSTR(MP_QSTR_callback);
+        args[7] = self->timer_cb;
+        mp_call_method_n_kw(0, 3, args);
+    #endif
+
+    self->period = period;
+}
+
+
+static void task_handler_schedule(mp_task_handler_obj_t *self)
+{
+    #if LV_USE_OS != LV_OS_NONE
+        if (self->active) lv_mp_os_wake_render_thread();
+    #else
+        if (self->active && !self->scheduled && !self->running && self->disabled <= 0) {
+            // if the schedule queue is full the update gets picked up the next
+            // time the timer fires
+            if (mp_sched_schedule(MP_OBJ_FROM_PTR(&task_handler_run_obj), MP_OBJ_FROM_PTR(self))) {
+                self->scheduled = true;
+            }
+        }
+    #endif
+}
+
+
+// LVGL calls this when a timer gets resumed or created while the handler is
+// sleeping
+static void task_handler_resume_cb(void *data)
+{
+    mp_task_handler_obj_t *self = (mp_task_handler_obj_t *)data;
+
+    if (self->period > self->duration && !self->running) task_handler_schedule(self);
+}
+
+
+static mp_obj_t task_handler_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *all_args)
+{
+    enum {
+        ARG_timer,
+        ARG_callbacks,
+        ARG_exception_hook,
+        ARG_callback_exception_hook,
+        ARG_duration,
+        ARG_max_period,
+        ARG_input_idle_period
+    };
+
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_timer,                   MP_ARG_OBJ | MP_ARG_REQUIRED                           },
+        { MP_QSTR_callbacks,               MP_ARG_OBJ | MP_ARG_REQUIRED                           },
+        { MP_QSTR_exception_hook,          MP_ARG_OBJ | MP_ARG_REQUIRED                           },
+        { MP_QSTR_callback_exception_hook, MP_ARG_OBJ,                  { .u_obj = mp_const_none } },
+        { MP_QSTR_duration,                MP_ARG_INT | MP_ARG_KW_ONLY, { .u_int = 33            } },
+        { MP_QSTR_max_period,              MP_ARG_INT | MP_ARG_KW_ONLY, { .u_int = 1000          } },
+        { MP_QSTR_input_idle_period,       MP_ARG_INT | MP_ARG_KW_ONLY, { .u_int = 100           } },
+    };
+
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all_kw_array(n_args, n_kw, all_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
+
+    if (!mp_obj_is_type(args[ARG_callbacks].u_obj, &mp_type_list)) {
+        mp_raise_TypeError(MP_ERROR_TEXT("callbacks must be a list"));
+    }
+
+    if (args[ARG_duration].u_int <= 0) {
+        mp_raise_ValueError(MP_ERROR_TEXT("duration must be greater than 0"));
+    }
+
+    if (args[ARG_max_period].u_int < args[ARG_duration].u_int) {
+        args[ARG_max_period].u_int = args[ARG_duration].u_int;
+    }
+
+    if (args[ARG_input_idle_period].u_int < 0) {
+        mp_raise_ValueError(MP_ERROR_TEXT("input_idle_period can't be negative"));
+    }
+
+    mp_task_handler_obj_t *self = m_new_obj(mp_task_handler_obj_t);
+    self->base.type = type;
+    self->callbacks = args[ARG_callbacks].u_obj;
+    self->exception_hook = args[ARG_exception_hook].u_obj;
+    self->callback_exception_hook = args[ARG_callback_exception_hook].u_obj;
+    self->timer = args[ARG_timer].u_obj;
+    self->timer_cb = mp_const_none;
+    self->timer_periodic = mp_const_none;
+    self->duration = (uint32_t)args[ARG_duration].u_int;
+    self->max_period = (uint32_t)args[ARG_max_period].u_int;
+    self->period = 0;
+    self->input_idle_period = (uint32_t)args[ARG_input_idle_period].u_int;
+    self->input_read_time = 0;
+    self->idle_indev_count = 0;
+    self->input_woken = false;
+    self->disabled = 0;
+    self->active = true;
+    self->scheduled = false;
+    self->running = false;
+
+    #if LV_USE_OS != LV_OS_NONE
+        self->period = self->duration;
+        lv_mp_os_start_render_thread(task_handler_render_loop, self);
+    #else
+        self->timer_cb = mp_obj_new_bound_meth(MP_OBJ_FROM_PTR(&task_handler_timer_cb_obj), MP_OBJ_FROM_PTR(self));
+        self->timer_periodic = mp_load_attr(self->timer, MP_QSTR_PERIODIC);
+        task_handler_set_period(self, self->duration);
+    #endif
+
+    lv_timer_handler_set_resume_cb(task_handler_resume_cb, self);
+
+    return MP_OBJ_FROM_PTR(self);
+}
+
+
+static bool task_handler_has_callbacks(mp_task_handler_obj_t *self)
+{
+    size_t len;
+    mp_obj_t *items;
+
+    mp_obj_list_get(self->callbacks, &len, &items);
+    return len != 0;
+}
+
+
+// returns false if one of the STARTED callbacks asked for the update to be
+// skipped
+static bool task_handler_call_callbacks(mp_task_handler_obj_t *self, mp_int_t event)
+{
+    bool run_update = true;
+    size_t len;
+    mp_obj_t *items;
+
+    // a callback is able to add or remove callbacks so the list is fetched
+    // again every time around
+    for (size_t i = 0;; i++) {
+        mp_obj_list_get(self->callbacks, &len, &items);
+        if (i >= len) break;
+
+        size_t n;
+        mp_obj_t *cb;
+        mp_obj_tuple_get(items[i], &n, &cb);
+
+        if (n != 3 || !(mp_obj_get_int(cb[1]) & event)) continue;
+
+        nlr_buf_t nlr;
+        if (nlr_push(&nlr) == 0) {
+            mp_obj_t ret = mp_call_function_2(cb[0], MP_OBJ_NEW_SMALL_INT(event), cb[2]);
+            if (ret == mp_const_false) run_update = false;
+            nlr_pop();
+        } else if (self->callback_exception_hook != mp_const_none) {
+            mp_call_function_1(self->callback_exception_hook, MP_OBJ_FROM_PTR(nlr.ret_val));
+        } else {
+            mp_obj_print_exception(&mp_plat_print, MP_OBJ_FROM_PTR(nlr.ret_val));
+        }
+    }
+
+    return run_update;
+}
+
+
+#if LV_USE_OS != LV_OS_NONE
+    typedef struct _task_handler_call_t {
+        mp_task_handler_obj_t *self;
+        mp_int_t event;
+        bool result;
+    } task_handler_call_t;
+
+
+    static void task_handler_callbacks_in_vm(void *data)
+    {
+        task_handler_call_t *call = (task_handler_call_t *)data;
+        call->result = task_handler_call_callbacks(call->self, call->event);
+    }
+#endif
+
+
+static bool task_handler_callbacks(mp_task_handler_obj_t *self, mp_int_t event)
+{
+    #if LV_USE_OS != LV_OS_NONE
+        if (lv_mp_os_is_render_thread()) {
+            task_handler_call_t call = { self, event, true };
+            lv_mp_os_call_in_vm(task_handler_callbacks_in_vm, &call);
+            return call.result;
+        }
+    #endif
+
+    return task_handler_call_callbacks(self, event);
+}
+
+
+// an indev that is released still gets read while a scroll throw is running
+static bool task_handler_indev_active(lv_indev_t *indev)
+{
+    return lv_indev_get_state(indev) == LV_INDEV_STATE_PRESSED || lv_indev_get_scroll_obj(indev) != NULL;
+}
+
+
+// an indev is able to be deleted while its read timer is paused
+static bool task_handler_indev_exists(lv_indev_t *indev)
+{
+    for (lv_indev_t *i = lv_indev_get_next(NULL); i != NULL; i = lv_indev_get_next(i)) {
+        if (i == indev) return true;
+    }
+    return false;
+}
+
+
+// gives the indevs back to their read timers
+static void task_handler_resume_indevs(mp_task_handler_obj_t *self)
+{
+    for (uint8_t i = 0; i < self->idle_indev_count; i++) {
+        if (task_handler_indev_exists(self->idle_indevs[i])) {
+            lv_timer_resume(lv_indev_get_read_timer(self->idle_indevs[i]));
+        }
+    }
+
+    self->idle_indev_count = 0;
+}
+
+
+// reads the indevs that have had their read timers paused. If any of them
+// has input all of them go back to being read by their timers
+static void task_handler_read_idle_indevs(mp_task_handler_obj_t *self)
+{
+    bool active = false;
+
+    for (uint8_t i = 0; i < self->idle_indev_count; i++) {
+        lv_indev_t *indev = self->idle_indevs[i];
+        if (!task_handler_indev_exists(indev)) continue;
+
+        lv_indev_read(indev);
+        if (task_handler_indev_active(indev)) active = true;
+    }
+
+    self->input_read_time = lv_tick_get();
+    if (active) task_handler_resume_indevs(self);
+}
+
+
+// pauses the read timers of the indevs in timer mode once none of them have
+// input. Indevs in event mode are left alone, they don't use their timer
+static void task_handler_pause_indevs(mp_task_handler_obj_t *self)
+{
+    if (!self->active || self->input_idle_period == 0 || self->idle_indev_count != 0) return;
+
+    uint8_t count = 0;
+
+    for (lv_indev_t *indev = lv_indev_get_next(NULL); indev != NULL; indev = lv_indev_get_next(indev)) {
+        if (lv_indev_get_mode(indev) != LV_INDEV_MODE_TIMER || lv_indev_get_read_timer(indev) == NULL) continue;
+        if (task_handler_indev_active(indev) || count == TASK_HANDLER_IDLE_INDEVS) return;
+
+        self->idle_indevs[count++] = indev;
+    }
+
+    for (uint8_t i = 0; i < count; i++) lv_timer_pause(lv_indev_get_read_timer(self->idle_indevs[i]));
+
+    self->idle_indev_count = count;
+    self->input_read_time = lv_tick_get();
+}
+
+
+// one pass of the handler, returns how long to wait until the next one
+static uint32_t task_handler_update(mp_task_handler_obj_t *self)
+{
+    bool has_callbacks = task_handler_has_callbacks(self);
+    bool run_update = true;
+
+    if (has_callbacks) run_update = task_handler_callbacks(self, TASK_HANDLER_STARTED);
+
+    if (!run_update) return self->duration;
+
+    if (self->idle_indev_count != 0 &&
+        (self->input_woken || lv_tick_elaps(self->input_read_time) >= self->input_idle_period)
+    ) {
+        self->input_woken = false;
+        task_handler_read_idle_indevs(self);
+    }
+
+    uint32_t next = lv_timer_handler();
+    if (has_callbacks) task_handler_callbacks(self, TASK_HANDLER_FINISHED);
+
+    task_handler_pause_indevs(self);
+
+    // the handler has to wake up to read the indevs that are paused
+    if (self->idle_indev_count != 0) {
+        uint32_t elapsed = lv_tick_elaps(self->input_read_time);
+        uint32_t input_next = elapsed >= self->input_idle_period ? 0 : self->input_idle_period - elapsed;
+
+        if (input_next < next) next = input_next;
+    }
+
+    // LV_NO_TIMER_READY is UINT32_MAX so it ends up as max_period
+    return LV_CLAMP(self->duration, next, self->max_period);
+}
+
+
+static void task_handler_handle_exception(mp_task_handler_obj_t *self, mp_obj_t exc)
+{
+    if (self->exception_hook != mp_const_none) {
+        mp_call_function_1(self->exception_hook, exc);
+    }
+}
+
+
+static mp_obj_t task_handler_run(mp_obj_t self_in)
+{
+    mp_task_handler_obj_t *self = MP_OBJ_TO_PTR(self_in);
+
+    self->scheduled = false;
+
+    if (!self->active || self->disabled > 0 || self->running) {
+        return mp_const_none;
+    }
+
+    // LVGL is not reentrant, if it is calling into Python code right now the
+    // update is left for the next time the timer fires
+    if (lv_mp_get_nesting() != 0) {
+        task_handler_set_period(self, self->duration);
+        return mp_const_none;
+    }
+
+    #if LV_USE_OS != LV_OS_NONE
+        lv_mp_os_lock();
+    #endif
+
+    self->running = true;
+
+    nlr_buf_t nlr;
+    if (nlr_push(&nlr) == 0) {
+        task_handler_set_period(self, task_handler_update(self));
+        nlr_pop();
+    } else {
+        self->running = false;
+        #if LV_USE_OS != LV_OS_NONE
+            lv_mp_os_unlock();
+        #endif
+
+        task_handler_handle_exception(self, MP_OBJ_FROM_PTR(nlr.ret_val));
+        return mp_const_none;
+    }
+
+    self->running = false;
+    #if LV_USE_OS != LV_OS_NONE
+        lv_mp_os_unlock();
+    #endif
+
+    return mp_const_none;
+}
+
+
+#if LV_USE_OS != LV_OS_NONE
+    typedef struct _task_handler_exception_t {
+        mp_task_handler_obj_t *self;
+        mp_obj_t exc;
+    } task_handler_exception_t;
+
+
+    static void task_handler_exception_in_vm(void *data)
+    {
+        task_handler_exception_t *call = (task_handler_exception_t *)data;
+        task_handler_handle_exception(call->self, call->exc);
+    }
+
+
+    // runs on the render thread until the handler is deinitialized
+    static void task_handler_render_loop(void *data)
+    {
+        mp_task_handler_obj_t *self = (mp_task_handler_obj_t *)data;
+
+        while (self->active) {
+            uint32_t period = self->duration;
+
+            if (self->disabled <= 0) {
+                lv_mp_os_lock();
+                self->running = true;
+
+                nlr_buf_t nlr;
+                if (nlr_push(&nlr) == 0) {
+                    period = task_handler_update(self);
+                    nlr_pop();
+                } else {
+                    task_handler_exception_t call = { self, MP_OBJ_FROM_PTR(nlr.ret_val) };
+                    lv_mp_os_call_in_vm(task_handler_exception_in_vm, &call);
+                }
+
+                self->running = false;
+                lv_mp_os_unlock();
+            }
+
+            self->period = period;
+            lv_mp_os_render_sleep(period);
+        }
+    }
+#endif
+
+
+// this is what machine.Timer calls. It is able to be called from an ISR on
+// some ports so all it does is schedule the update if one isn't waiting
+static mp_obj_t task_handler_timer_cb(mp_obj_t self_in, mp_obj_t timer)
+{
+    LV_UNUSED(timer);
+    task_handler_schedule(MP_OBJ_TO_PTR(self_in));
+    return mp_const_none;
+}
+
+
+// runs the handler as soon as possible, input drivers that get interrupts
+// use this so input isn't left waiting for the timer. Indevs that have their
+// read timers paused get read right away. Safe to call from an ISR
+static mp_obj_t task_handler_wake(mp_obj_t self_in)
+{
+    mp_task_handler_obj_t *self = MP_OBJ_TO_PTR(self_in);
+
+    self->input_woken = true;
+    task_handler_schedule(self);
+    return mp_const_none;
+}
+
+static MP_DEFINE_CONST_FUN_OBJ_1(task_handler_wake_obj, task_handler_wake);
+
+
+static mp_obj_t task_handler_disable(mp_obj_t self_in)
+{
+    mp_task_handler_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    self->disabled++;
+    return mp_const_none;
+}
+
+static MP_DEFINE_CONST_FUN_OBJ_1(task_handler_disable_obj, task_handler_disable);
+
+
+static mp_obj_t task_handler_enable(mp_obj_t self_in)
+{
+    mp_task_handler_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    if (self->disabled > 0) self->disabled--;
+
+    if (self->disabled == 0) task_handler_schedule(self);
+    return mp_const_none;
+}
+
+static MP_DEFINE_CONST_FUN_OBJ_1(task_handler_enable_obj, task_handler_enable);
+
+
+static mp_obj_t task_handler_deinit(mp_obj_t self_in)
+{
+    mp_task_handler_obj_t *self = MP_OBJ_TO_PTR(self_in);
+
+    if (self->active) {
+        self->active = false;
+        lv_timer_handler_set_resume_cb(NULL, NULL);
+
+        #if LV_USE_OS != LV_OS_NONE
+            // the render thread exits once it wakes up, a new handler is
+            // not able to be made until it has
+            lv_mp_os_stop_render_thread();
+
+            lv_mp_os_lock();
+            task_handler_resume_indevs(self);
+            lv_mp_os_unlock();
+        #else
+            mp_obj_t args[2];
+            mp_load_method(self->timer, MP_QSTR_deinit, args);
+            mp_call_method_n_kw(0, 0, args);
+
+            task_handler_resume_indevs(self);
+        #endif
+    }
+    return mp_const_none;
+}
+
+static MP_DEFINE_CONST_FUN_OBJ_1(task_handler_deinit_obj, task_handler_deinit);
+
+
+static const mp_rom_map_elem_t task_handler_locals_dict_table[] = {
+    { MP_ROM_QSTR(MP_QSTR_run),      MP_ROM_PTR(&task_handler_run_obj)      },
+    { MP_ROM_QSTR(MP_QSTR_timer_cb), MP_ROM_PTR(&task_handler_timer_cb_obj) },
+    { MP_ROM_QSTR(MP_QSTR_wake),     MP_ROM_PTR(&task_handler_wake_obj)     },
+    { MP_ROM_QSTR(MP_QSTR_disable),  MP_ROM_PTR(&task_handler_disable_obj)  },
+    { MP_ROM_QSTR(MP_QSTR_enable),   MP_ROM_PTR(&task_handler_enable_obj)   },
+    { MP_ROM_QSTR(MP_QSTR_deinit),   MP_ROM_PTR(&task_handler_deinit_obj)   },
+};
+
+static MP_DEFINE_CONST_DICT(task_handler_locals_dict, task_handler_locals_dict_table);
+
+MP_DEFINE_CONST_OBJ_TYPE(
+    mp_task_handler_type,
+    MP_QSTR_TaskHandler,
+    MP_TYPE_FLAG_NONE,
+    make_new, task_handler_make_new,
+    locals_dict, (mp_obj_dict_t *)&task_handler_locals_dict
+);
+
+
+static const mp_rom_map_elem_t mp_module_task_handler_globals_table[] = {
+    { MP_ROM_QSTR(MP_QSTR___name__),              MP_OBJ_NEW_QSTR(MP_QSTR__task_handler)           },
+    { MP_ROM_QSTR(MP_QSTR_TaskHandler),           MP_ROM_PTR(&mp_task_handler_type)                },
+    { MP_ROM_QSTR(MP_QSTR_TASK_HANDLER_STARTED),  MP_ROM_INT(TASK_HANDLER_STARTED)                 },
+    { MP_ROM_QSTR(MP_QSTR_TASK_HANDLER_FINISHED), MP_ROM_INT(TASK_HANDLER_FINISHED)                },
+    { MP_ROM_QSTR(MP_QSTR_THREADED),              MP_ROM_INT(LV_USE_OS != LV_OS_NONE)              },
+    { MP_ROM_QSTR(MP_QSTR_DRAW_UNITS),            MP_ROM_INT(TASK_HANDLER_DRAW_UNITS)              },
+};
+
+static MP_DEFINE_CONST_DICT(mp_module_task_handler_globals, mp_module_task_handler_globals_table);
+
+
+const mp_obj_module_t mp_module_task_handler = {
+    .base    = {&mp_type_module},
+    .globals = (mp_obj_dict_t *)&mp_module_task_handler_globals,
+};
+
+MP_REGISTER_MODULE(MP_QSTR__task_handler, mp_module_task_handler);
@@ -2054,6 +2054,49 @@ static void *mp_lv_callback(mp_obj_t mp_callback, void *lv_callback, qstr callba
 
 static int _nesting = 0;
 
+// the native task handler needs to know if LVGL is calling into Python and
+// it is in a different compilation unit
+int lv_mp_get_nesting(void)
+{
+    return _nesting;
+}
+
+// lv.lock() and lv.unlock() and handing callbacks over to the thread the VM
+// is running on, these are in ext_mod/lvgl/lv_mp_os.c
+extern const mp_obj_fun_builtin_fixed_t lv_mp_os_lock_obj;
+extern const mp_obj_fun_builtin_fixed_t lv_mp_os_unlock_obj;
+
+#if LV_USE_OS != LV_OS_NONE
+bool lv_mp_os_is_render_thread(void);
+void lv_mp_os_call_in_vm(void (*func)(void *), void *data);
+#endif
+
+// lv.init(), lv.tick_inc() and lv.tick_set_native(), these are in
+// ext_mod/lvgl/lv_mp_tick.c
+extern const mp_obj_fun_builtin_fixed_t lv_mp_tick_init_obj;
+extern const mp_obj_fun_builtin_fixed_t lv_mp_tick_inc_obj;
+extern const mp_obj_fun_builtin_fixed_t lv_mp_tick_set_native_obj;
+
+// lv.profiler_dump() and lv.profiler_reset(), these are in
+// ext_mod/lvgl/lv_mp_profiler.c
+#include "lv_mp_profiler.h"
+
+#if LV_USE_PROFILER
+extern const mp_obj_fun_builtin_var_t lv_mp_profiler_dump_obj;
+extern const mp_obj_fun_builtin_fixed_t lv_mp_profiler_reset_obj;
+#endif
+
+// lv.display_set_native_flush(), the flush is in ext_mod/lvgl/lv_mp_flush.c.
+// The display gets converted here because mp_to_ptr is only in this file
+mp_obj_t lv_mp_flush_set_native(lv_display_t *disp, size_t n_args, const mp_obj_t *args);
+
+static mp_obj_t mp_lv_display_set_native_flush(size_t n_args, const mp_obj_t *args)
+{
+    return lv_mp_flush_set_native(mp_to_ptr(args[0]), n_args - 1, args + 1);
+}
+
+static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(mp_lv_display_set_native_flush_obj, 2, 7, mp_lv_display_set_native_flush);
+
 // Function pointers wrapper
 
 static mp_obj_t mp_lv_funcptr(const mp_lv_obj_fun_builtin_var_t *mp_fun, void *lv_fun, void *lv_callback, qstr func_name, void *user_data)
@@ -2959,19 +3002,57 @@ def gen_callback_func(func, func_name = None, user_data_argument = False):
 
     callback_metadata[func_name]['c_rtype'] = return_type
     callback_metadata[func_name]['py_rtype'] = get_py_type(return_type)
+
+    # the arguments and the result of a callback that is handed over from
+    # the render thread to the thread the VM is running on
+    call_fields = []
+    for arg in enumerated_args:
+        field = copy.deepcopy(arg)
+        convert_array_to_ptr(field)
+        call_fields.append('%s;' % gen.visit(field))
+    if return_type != 'void':
+        call_fields.append('%s result;' % return_type)
+    if not call_fields:
+        call_fields.append('char unused;')
+
     print("""
 /*
  * Callback function {func_name}
  * {func_prototype}
  */
 
+GENMPY_UNUSED static {return_type} {func_name}_callback({func_args});
+
+#if LV_USE_OS != LV_OS_NONE
+typedef struct {{
+    {call_fields}
+}} {func_name}_call_t;
+
+GENMPY_UNUSED static void {func_name}_call_in_vm(void *data)
+{{
+    {func_name}_call_t *call = data;
+    {call_result_assignment}{func_name}_callback({call_args});
+}}
+#endif
+
 GENMPY_UNUSED static {return_type} {func_name}_callback({func_args})
 {{
+#if LV_USE_OS != LV_OS_NONE
+    // LVGL is running on a thread of its own, the callback gets run by the
+    // thread the VM is running on
+    if (lv_mp_os_is_render_thread()) {{
+        {func_name}_call_t call = {{ {call_init} }};
+        lv_mp_os_call_in_vm({func_name}_call_in_vm, &call);
+        return{call_return};
+    }}
+#endif
     mp_obj_t mp_args[{num_args}];
     {build_args}
     mp_obj_t callbacks = get_callback_dict_from_user_data({user_data});
     _nesting++;
+    LV_MP_PROFILER_BEGIN_TAG("{func_name}");
     {return_value_assignment}mp_call_function_n_kw(mp_obj_dict_get(callbacks, MP_OBJ_NEW_QSTR(MP_QSTR_{func_name})) , {num_args}, 0, mp_args);
+    LV_MP_PROFILER_END_TAG("{func_name}");
     _nesting--;
     return{return_value};
 }}
@@ -2984,7 +3065,12 @@ GENMPY_UNUSED static {return_type} {func_name}_callback({func_args})
         build_args="\n    ".join([build_callback_func_arg(arg, i, func, func_name=func_name) for i,arg in enumerate(args)]),
         user_data=full_user_data,
         return_value_assignment = '' if return_type == 'void' else 'mp_obj_t callback_result = ',
-        return_value='' if return_type == 'void' else ' %s(callback_result)' % mp_to_lv[return_type]))
+        return_value='' if return_type == 'void' else ' %s(callback_result)' % mp_to_lv[return_type],
+        call_fields='\n    '.join(call_fields),
+        call_args=', '.join(['call->arg%d' % i for i in range(len(args))]),
+        call_init=', '.join(['arg%d' % i for i in range(len(args))]) or '0',
+        call_result_assignment='' if return_type == 'void' else 'call->result = ',
+        call_return='' if return_type == 'void' else ' call.result'))
     generated_callbacks[func_name] = True
 
 
@@ -3564,6 +3650,18 @@ print("""
 
 # eprint("/* Generating global module functions /*")
 module_funcs = [func for func in funcs if not func.name in generated_funcs]
+
+# functions that are replaced by ones in ext_mod/lvgl.
+# LVGL's own lock is taken by lv_timer_handler on the render thread and the
+# render thread waits on Python callbacks while it holds it. Python code gets
+# the binding's lock instead, it is able to be used as a context manager.
+# lv.init() also sets MicroPython's clock as LVGL's tick source.
+native_funcs = {
+    'lv_lock': 'lv_mp_os_lock_obj',
+    'lv_unlock': 'lv_mp_os_unlock_obj',
+    'lv_init': 'lv_mp_tick_init_obj',
+    'lv_tick_inc': 'lv_mp_tick_inc_obj'
+}
 for module_func in module_funcs[:]: # clone list because we are changing it in the loop.
     if module_func.name in generated_funcs:
         continue # generated_funcs could change inside the loop so need to recheck.
@@ -3640,13 +3738,19 @@ static const mp_rom_map_elem_t {module_name}_globals_table[] = {{
 #ifdef LV_OBJ_T
     {{ MP_ROM_QSTR(MP_QSTR_LvReferenceError), MP_ROM_PTR(&mp_type_LvReferenceError) }},
 #endif // LV_OBJ_T
+    {{ MP_ROM_QSTR(MP_QSTR_tick_set_native), MP_ROM_PTR(&lv_mp_tick_set_native_obj) }},
+    {{ MP_ROM_QSTR(MP_QSTR_display_set_native_flush), MP_ROM_PTR(&mp_lv_display_set_native_flush_obj) }},
+#if LV_USE_PROFILER
+    {{ MP_ROM_QSTR(MP_QSTR_profiler_dump), MP_ROM_PTR(&lv_mp_profiler_dump_obj) }},
+    {{ MP_ROM_QSTR(MP_QSTR_profiler_reset), MP_ROM_PTR(&lv_mp_profiler_reset_obj) }},
+#endif // LV_USE_PROFILER
 }};
 """.format(
         module_name = sanitize(module_name),
         objects = ''.join(['{{ MP_ROM_QSTR(MP_QSTR_{obj}), MP_ROM_PTR(&mp_lv_{obj}_type_base) }},\n    '.
             format(obj = sanitize(o)) for o in obj_names]),
-        functions =  ''.join(['{{ MP_ROM_QSTR(MP_QSTR_{name}), MP_ROM_PTR(&mp_{func}_mpobj) }},\n    '.
-            format(name = sanitize(simplify_identifier(f.name)), func = f.name) for f in module_funcs]),
+        functions =  ''.join(['{{ MP_ROM_QSTR(MP_QSTR_{name}), MP_ROM_PTR(&{func}) }},\n    '.
+            format(name = sanitize(simplify_identifier(f.name)), func = native_funcs.get(f.name, 'mp_%s_mpobj' % f.name)) for f in module_funcs]),
         enums = ''.join(['{{ MP_ROM_QSTR(MP_QSTR_{name}), MP_ROM_PTR(&mp_lv_{enum}_type_base) }},\n    '.
             format(name = sanitize(get_enum_name(enum_name)), enum=enum_name) for enum_name in enums.keys() if enum_name not in enum_referenced]),
         structs = ''.join(['{{ MP_ROM_QSTR(MP_QSTR_{name}), MP_ROM_PTR(&mp_{struct_name}_type) }},\n    '.
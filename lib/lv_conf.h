@@ -142,8 +142,12 @@ extern void *mp_lv_roots;
  * - LV_OS_RTTHREAD
  * - LV_OS_WINDOWS
  * - LV_OS_MQX
- * - LV_OS_CUSTOM */
-#define LV_USE_OS   LV_OS_NONE
+ * - LV_OS_CUSTOM
+ *Only LV_OS_PTHREAD and LV_OS_FREERTOS are supported by the binding, it is
+ *set using `--lvgl-threads` when building*/
+#ifndef LV_USE_OS
+    #define LV_USE_OS   LV_OS_NONE
+#endif
 
 #if LV_USE_OS == LV_OS_CUSTOM
     #define LV_OS_CUSTOM_INCLUDE <stdint.h>
@@ -193,8 +197,11 @@ extern void *mp_lv_roots;
 
 	/* Set the number of draw unit.
      * > 1 requires an operating system enabled in `LV_USE_OS`
-     * > 1 means multiply threads will render the screen in parallel */
-    #define LV_DRAW_SW_DRAW_UNIT_CNT    1
+     * > 1 means multiply threads will render the screen in parallel
+     * It is set using `--draw-units` when building */
+    #ifndef LV_DRAW_SW_DRAW_UNIT_CNT
+        #define LV_DRAW_SW_DRAW_UNIT_CNT    1
+    #endif
 
     /* Use Arm-2D to accelerate the sw render */
     #define LV_USE_DRAW_ARM2D_SYNC      0
@@ -894,30 +901,29 @@ extern void *mp_lv_roots;
 
 #endif /*LV_USE_SYSMON*/
 
-/*1: Enable the runtime performance profiler*/
-#define LV_USE_PROFILER 0
+/*1: Enable the runtime performance profiler
+ *set using `--profiler` when building so lcd_bus gets built with it as well*/
+#ifndef LV_USE_PROFILER
+    #define LV_USE_PROFILER 0
+#endif
 #if LV_USE_PROFILER
-    /*1: Enable the built-in profiler*/
-    #define LV_USE_PROFILER_BUILTIN 1
-    #if LV_USE_PROFILER_BUILTIN
-        /*Default profiler trace buffer size*/
-        #define LV_PROFILER_BUILTIN_BUF_SIZE (16 * 1024)     /*[bytes]*/
-    #endif
+    /*The binding records the events itself, see ext_mod/lvgl/lv_mp_profiler.h*/
+    #define LV_USE_PROFILER_BUILTIN 0
 
     /*Header to include for the profiler*/
-    #define LV_PROFILER_INCLUDE "lvgl/src/misc/lv_profiler_builtin.h"
+    #define LV_PROFILER_INCLUDE "lv_mp_profiler.h"
 
     /*Profiler start point function*/
-    #define LV_PROFILER_BEGIN    LV_PROFILER_BUILTIN_BEGIN
+    #define LV_PROFILER_BEGIN    LV_MP_PROFILER_BEGIN
 
     /*Profiler end point function*/
-    #define LV_PROFILER_END      LV_PROFILER_BUILTIN_END
+    #define LV_PROFILER_END      LV_MP_PROFILER_END
 
     /*Profiler start point function with custom tag*/
-    #define LV_PROFILER_BEGIN_TAG LV_PROFILER_BUILTIN_BEGIN_TAG
+    #define LV_PROFILER_BEGIN_TAG LV_MP_PROFILER_BEGIN_TAG
 
     /*Profiler end point function with custom tag*/
-    #define LV_PROFILER_END_TAG   LV_PROFILER_BUILTIN_END_TAG
+    #define LV_PROFILER_END_TAG   LV_MP_PROFILER_END_TAG
 #endif
 
 /*1: Enable Monkey test*/
@@ -181,6 +181,40 @@ argParser.add_argument(
     action='store_true'
 )
 
+argParser.add_argument(
+    '--lvgl-threads',
+    dest='lvgl_threads',
+    help=(
+        'run the LVGL refresh loop on a thread of its own. '
+        'Supported by unix, macOS, raspberry_pi and esp32'
+    ),
+    default=False,
+    action='store_true'
+)
+
+argParser.add_argument(
+    '--draw-units',
+    dest='draw_units',
+    help=(
+        'number of threads the software renderer draws with. More than 1 '
+        'turns on --lvgl-threads. Default is 1'
+    ),
+    default=1,
+    type=int,
+    action='store'
+)
+
+argParser.add_argument(
+    '--profiler',
+    dest='profiler',
+    help=(
+        'build LVGL, the binding and lcd_bus with the profiler. '
+        'lv.profiler_dump() writes the events out as Chrome trace JSON'
+    ),
+    default=False,
+    action='store_true'
+)
+
 
 args2, extra_args = argParser.parse_known_args(extra_args)
 
@@ -193,6 +227,7 @@ indevs = args2.indevs
 expanders = args2.expanders
 imus = args2.imus
 builder.DO_NOT_SCRUB_BUILD_FOLDER = args2.no_scrub
+builder.DRAW_UNITS = args2.draw_units
 
 if imus:
     os.environ['FUSION'] = "1"
@@ -208,6 +243,32 @@ if lv_cflags is None:
     lv_cflags = ''
 
 
+if args2.draw_units < 1:
+    raise RuntimeError('--draw-units has to be 1 or more')
+
+# LVGL needs an OS to run more than one draw unit
+if args2.draw_units > 1:
+    args2.lvgl_threads = True
+    lv_cflags += f' -DLV_DRAW_SW_DRAW_UNIT_CNT={args2.draw_units}'
+
+
+if args2.profiler:
+    lv_cflags += ' -DLV_USE_PROFILER=1'
+
+
+if args2.lvgl_threads:
+    if target.lower() in ('unix', 'macos', 'raspberry_pi'):
+        lv_cflags += ' -DLV_USE_OS=LV_OS_PTHREAD'
+    elif target.lower() == 'esp32':
+        lv_cflags += ' -DLV_USE_OS=LV_OS_FREERTOS'
+    else:
+        raise RuntimeError(
+            f'--lvgl-threads is not supported by the {target} target'
+        )
+
+lv_cflags = lv_cflags.strip()
+
+
 extra_args.append(f'FROZEN_MANIFEST="{SCRIPT_DIR}/build/manifest.py"')
 extra_args.append(f'GEN_SCRIPT=python')
 
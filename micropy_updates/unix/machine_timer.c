@@ -2,6 +2,7 @@
 
 #include "py/obj.h"
 #include "py/runtime.h"
+#include "py/mpstate.h"
 #include "mphalport.h"
 #include "machine_timer.h"
 
@@ -18,26 +19,133 @@
 #include <string.h>
 
 #include <pthread.h>
+#include <time.h>
 #include <unistd.h>
 
 #include <termios.h>
 #include <fcntl.h>
 
-static const useconds_t TIMER_POLL_INTERVAL_US = 1000;  // 1 millisecond
+#define NS_PER_MS  (1000000ULL)
+#define NS_PER_S   (1000000000ULL)
+
+/*
+The active timers are kept in a min heap that is ordered by the absolute time
+each timer is due. The timer thread sleeps until the deadline of the timer at
+the top of the heap, or until it is woken up because a timer was started or
+stopped. Nothing gets polled, when no timer is running the thread stays
+asleep, and periods that are less than 1 millisecond are able to be used.
+
+A timer that repeats gets its next deadline by adding the period to the last
+deadline instead of to the time it actually ran so it doesn't drift. If the
+process fell more than a period behind the missed periods get dropped.
+*/
 
 static pthread_t timer_poll_thread_id;
 
 bool timer_polling = false;
 pthread_mutex_t timer_lock;
+static pthread_cond_t timer_cond;
+
+static machine_timer_obj_t **timer_heap = NULL;
+static size_t timer_heap_len = 0;
+static size_t timer_heap_size = 0;
 
 
 const mp_obj_type_t machine_timer_type;
 
-static machine_timer_obj_t *timer_objs[TIMER_COUNT];
+// all of the timers that have been created so they are able to be found by id
+// and so the GC doesn't collect a timer that is running.
+MP_REGISTER_ROOT_POINTER(struct _machine_timer_obj_t *machine_timer_obj_head);
 
 
 static void machine_timer_disable(machine_timer_obj_t *self);
-static void machine_timer_init_helper(machine_timer_obj_t *self, int16_t mode, mp_obj_t callback, int32_t period);
+static void machine_timer_init_helper(machine_timer_obj_t *self, int16_t mode, mp_obj_t callback, int64_t period_ns);
+
+
+static uint64_t timer_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * NS_PER_S + (uint64_t)ts.tv_nsec;
+}
+
+
+/* deadline heap, timer_lock has to be held */
+static void timer_heap_swap(size_t a, size_t b)
+{
+    machine_timer_obj_t *timer = timer_heap[a];
+
+    timer_heap[a] = timer_heap[b];
+    timer_heap[b] = timer;
+
+    timer_heap[a]->heap_index = a;
+    timer_heap[b]->heap_index = b;
+}
+
+
+static void timer_heap_sift_up(size_t index)
+{
+    while (index > 0) {
+        size_t parent = (index - 1) / 2;
+
+        if (timer_heap[parent]->deadline_ns <= timer_heap[index]->deadline_ns) break;
+
+        timer_heap_swap(index, parent);
+        index = parent;
+    }
+}
+
+
+static void timer_heap_sift_down(size_t index)
+{
+    for (;;) {
+        size_t smallest = index;
+        size_t left = index * 2 + 1;
+        size_t right = left + 1;
+
+        if (left < timer_heap_len && timer_heap[left]->deadline_ns < timer_heap[smallest]->deadline_ns) smallest = left;
+        if (right < timer_heap_len && timer_heap[right]->deadline_ns < timer_heap[smallest]->deadline_ns) smallest = right;
+        if (smallest == index) break;
+
+        timer_heap_swap(index, smallest);
+        index = smallest;
+    }
+}
+
+
+static bool timer_heap_push(machine_timer_obj_t *timer)
+{
+    if (timer_heap_len == timer_heap_size) {
+        size_t size = timer_heap_size ? timer_heap_size * 2 : 8;
+        machine_timer_obj_t **heap = realloc(timer_heap, size * sizeof(machine_timer_obj_t *));
+
+        if (heap == NULL) return false;
+
+        timer_heap = heap;
+        timer_heap_size = size;
+    }
+
+    timer->heap_index = timer_heap_len;
+    timer_heap[timer_heap_len++] = timer;
+    timer_heap_sift_up(timer->heap_index);
+
+    return true;
+}
+
+
+static void timer_heap_remove(machine_timer_obj_t *timer)
+{
+    size_t index = timer->heap_index;
+
+    timer_heap_len--;
+
+    if (index != timer_heap_len) {
+        timer_heap_swap(index, timer_heap_len);
+        timer_heap_sift_down(index);
+        timer_heap_sift_up(index);
+    }
+}
+/* end deadline heap */
 
 
 static void *timer_poll_thread(void *arg)
@@ -45,75 +153,112 @@ static void *timer_poll_thread(void *arg)
     (void)arg;
 
     machine_timer_obj_t *timer;
+    struct timespec deadline;
 
-    while (timer_polling) {
-        usleep(TIMER_POLL_INTERVAL_US);
-
-        pthread_mutex_lock(&timer_lock);
+    pthread_mutex_lock(&timer_lock);
 
-        for (uint8_t i=0;i<TIMER_COUNT;i++) {
-            timer = timer_objs[i];
+    while (timer_polling) {
+        if (timer_heap_len == 0) {
+            pthread_cond_wait(&timer_cond, &timer_lock);
+            continue;
+        }
 
-            if (timer != NULL && timer->active) {
-                timer->ms_ticks += 1;
+        timer = timer_heap[0];
+        uint64_t now = timer_now_ns();
 
-                if (timer->ms_ticks >= timer->period) {
-                    timer->ms_ticks = 0;
+        if (timer->deadline_ns > now) {
+            deadline.tv_sec = (time_t)(timer->deadline_ns / NS_PER_S);
+            deadline.tv_nsec = (long)(timer->deadline_ns % NS_PER_S);
+            // the heap gets checked again no matter why this returns
+            pthread_cond_timedwait(&timer_cond, &timer_lock, &deadline);
+            continue;
+        }
 
-                    if (timer->callback != NULL && timer->callback != mp_const_none) {
-                        if (!timer->repeat) timer->active = false;
+        if (timer->repeat) {
+            timer->deadline_ns += timer->period_ns;
+            if (timer->deadline_ns <= now) timer->deadline_ns = now + timer->period_ns;
+            timer_heap_sift_down(0);
+        } else {
+            timer_heap_remove(timer);
+            timer->active = false;
+        }
 
-                        mp_sched_schedule(timer->callback, MP_OBJ_FROM_PTR(timer));
-                    }
-                }
-            }
+        if (timer->callback != NULL && timer->callback != mp_const_none) {
+            mp_sched_schedule(timer->callback, MP_OBJ_FROM_PTR(timer));
         }
-        pthread_mutex_unlock(&timer_lock);
     }
 
+    pthread_mutex_unlock(&timer_lock);
+
     return NULL;
 }
 
 
 void machine_timer_deinit_all(void)
 {
+    if (!timer_polling) return;
+
     // Disable, deallocate and remove all timers from list
     machine_timer_obj_t *timer;
     pthread_mutex_lock(&timer_lock);
 
-    for (uint8_t i=0;i<TIMER_COUNT;i++) {
-        timer = timer_objs[i];
-        if (timer != NULL) {
-            machine_timer_disable(timer);
-        }
+    for (timer = MP_STATE_PORT(machine_timer_obj_head); timer != NULL; timer = timer->next) {
+        machine_timer_disable(timer);
     }
 
+    timer_polling = false;
+    pthread_cond_signal(&timer_cond);
     pthread_mutex_unlock(&timer_lock);
 
-    timer_polling = false;
     pthread_join(timer_poll_thread_id, NULL);
+    pthread_cond_destroy(&timer_cond);
     pthread_mutex_destroy(&timer_lock);
 
-    timer = NULL;
+    free(timer_heap);
+    timer_heap = NULL;
+    timer_heap_len = 0;
+    timer_heap_size = 0;
+
+    while (MP_STATE_PORT(machine_timer_obj_head) != NULL) {
+        timer = MP_STATE_PORT(machine_timer_obj_head);
+        MP_STATE_PORT(machine_timer_obj_head) = timer->next;
+        m_del_obj(machine_timer_obj_t, timer);
+    }
+}
+
+
+/*
+period is in milliseconds and freq is in hertz. If freq is given it is used
+instead of period, it is how a period that is shorter than a millisecond gets
+set. -1 is returned when neither of them have been given.
+*/
+static int64_t machine_timer_period_ns(mp_int_t period, mp_obj_t freq)
+{
+    if (freq != mp_const_none) {
+        mp_float_t hz = mp_obj_get_float(freq);
 
-    for (uint8_t i=0;i<TIMER_COUNT;i++) {
-        timer = timer_objs[i];
-        if (timer != NULL) {
-            m_del_obj(machine_timer_obj_t, timer);
-            timer_objs[i] = NULL;
+        if (hz <= 0) {
+            mp_raise_msg(&mp_type_ValueError, MP_ERROR_TEXT("freq must be > 0"));
         }
+
+        return (int64_t)((mp_float_t)NS_PER_S / hz);
     }
+
+    if (period < 0) return -1;
+
+    return (int64_t)period * (int64_t)NS_PER_MS;
 }
 
 
 static mp_obj_t machine_timer_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *all_args)
 {
-    enum { ARG_id, ARG_mode, ARG_callback, ARG_period };
+    enum { ARG_id, ARG_mode, ARG_callback, ARG_period, ARG_freq };
     static const mp_arg_t allowed_args[] = {
         { MP_QSTR_id,           MP_ARG_INT  | MP_ARG_REQUIRED },
         { MP_QSTR_mode,         MP_ARG_KW_ONLY | MP_ARG_INT, { .u_int = 1 } },
         { MP_QSTR_callback,     MP_ARG_KW_ONLY | MP_ARG_OBJ, { .u_obj = mp_const_none } },
-        { MP_QSTR_period,       MP_ARG_KW_ONLY | MP_ARG_INT, { .u_int = 0 } }
+        { MP_QSTR_period,       MP_ARG_KW_ONLY | MP_ARG_INT, { .u_int = 0 } },
+        { MP_QSTR_freq,         MP_ARG_KW_ONLY | MP_ARG_OBJ, { .u_obj = mp_const_none } }
     };
 
     mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
@@ -126,31 +271,33 @@ static mp_obj_t machine_timer_make_new(const mp_obj_type_t *type, size_t n_args,
         args
     );
 
-    uint8_t id = (uint8_t)args[ARG_id].u_int;
+    mp_int_t id = args[ARG_id].u_int;
 
-    if (id >= TIMER_COUNT) {
-        mp_raise_msg_varg(
-            &mp_type_ValueError,
-            MP_ERROR_TEXT("Timer ID must be in range 0 - %d"),
-            TIMER_COUNT
-        );
+    if (id < 0) {
+        mp_raise_msg(&mp_type_ValueError, MP_ERROR_TEXT("Timer ID must be >= 0"));
         return mp_const_none;
     }
 
+    int64_t period_ns = machine_timer_period_ns(args[ARG_period].u_int, args[ARG_freq].u_obj);
+
     if (!timer_polling) {
+        pthread_condattr_t cond_attr;
+        pthread_condattr_init(&cond_attr);
+        pthread_condattr_setclock(&cond_attr, CLOCK_MONOTONIC);
+        pthread_cond_init(&timer_cond, &cond_attr);
+        pthread_condattr_destroy(&cond_attr);
+
         pthread_mutex_init(&timer_lock, NULL);
         timer_polling = true;
-        pthread_attr_t attr;
-        pthread_attr_init(&attr);
-        pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
-        pthread_create(&timer_poll_thread_id, &attr, &timer_poll_thread, NULL);
+        pthread_create(&timer_poll_thread_id, NULL, &timer_poll_thread, NULL);
     }
 
     int16_t mode = (int16_t)args[ARG_mode].u_int;
-    int32_t period = (int32_t)args[ARG_period].u_int;
 
     pthread_mutex_lock(&timer_lock);
-    machine_timer_obj_t *self = timer_objs[id];
+    machine_timer_obj_t *self = MP_STATE_PORT(machine_timer_obj_head);
+
+    while (self != NULL && self->id != id) self = self->next;
 
     // Check whether the timer is already initialized, if so use it
     // The timer does not exist, create it.
@@ -159,38 +306,56 @@ static mp_obj_t machine_timer_make_new(const mp_obj_type_t *type, size_t n_args,
         self->base.type = &machine_timer_type;
 
         self->id = id;
+        self->active = false;
         self->callback = NULL;
-        timer_objs[id] = self;
+        self->next = MP_STATE_PORT(machine_timer_obj_head);
+        MP_STATE_PORT(machine_timer_obj_head) = self;
     } else {
         machine_timer_disable(self);
     }
     pthread_mutex_unlock(&timer_lock);
 
-    machine_timer_init_helper(self, mode, args[ARG_callback].u_obj, period);
+    machine_timer_init_helper(self, mode, args[ARG_callback].u_obj, period_ns);
 
     return self;
 }
 
 
+// timer_lock has to be held
 static void machine_timer_disable(machine_timer_obj_t *self)
 {
-    self->active = false;
+    if (self->active) {
+        timer_heap_remove(self);
+        self->active = false;
+        pthread_cond_signal(&timer_cond);
+    }
 }
 
 
+// timer_lock has to be held
 static void machine_timer_enable(machine_timer_obj_t *self)
 {
-    self->ms_ticks = 0;
-	self->active = true;
+    self->deadline_ns = timer_now_ns() + self->period_ns;
+
+    if (!timer_heap_push(self)) {
+        pthread_mutex_unlock(&timer_lock);
+        mp_raise_msg(&mp_type_MemoryError, MP_ERROR_TEXT("Unable to start timer"));
+    }
+
+    self->active = true;
+    pthread_cond_signal(&timer_cond);
 }
 
 
-static void machine_timer_init_helper(machine_timer_obj_t *self, int16_t mode, mp_obj_t callback, int32_t period)
+static void machine_timer_init_helper(machine_timer_obj_t *self, int16_t mode, mp_obj_t callback, int64_t period_ns)
 {
     pthread_mutex_lock(&timer_lock);
     machine_timer_disable(self);
 
-    if (period != -1) self->period = (uint16_t)period;
+    if (period_ns != -1) {
+        // a period of 0 runs the timer as often as the old 1 millisecond tick did
+        self->period_ns = period_ns > 0 ? (uint64_t)period_ns : NS_PER_MS;
+    }
     if (mode != -1) self->repeat = (uint8_t)mode;
     if (callback != NULL) self->callback = callback;
 
@@ -206,8 +371,12 @@ static mp_obj_t machine_timer_del(mp_obj_t self_in)
     pthread_mutex_lock(&timer_lock);
     machine_timer_disable(self);
 
-    if (timer_objs[self->id] != NULL) {
-        timer_objs[self->id] = NULL;
+    machine_timer_obj_t **link = &MP_STATE_PORT(machine_timer_obj_head);
+
+    while (*link != NULL && *link != self) link = &(*link)->next;
+
+    if (*link != NULL) {
+        *link = self->next;
         m_del_obj(machine_timer_obj_t, self);
     }
 
@@ -236,12 +405,13 @@ static MP_DEFINE_CONST_FUN_OBJ_1(machine_timer_deinit_obj, machine_timer_deinit)
 static mp_obj_t machine_timer_init(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args)
 {
 
-    enum { ARG_self, ARG_mode, ARG_callback, ARG_period };
+    enum { ARG_self, ARG_mode, ARG_callback, ARG_period, ARG_freq };
     static const mp_arg_t allowed_args[] = {
         { MP_QSTR_self,         MP_ARG_REQUIRED | MP_ARG_OBJ },
         { MP_QSTR_mode,         MP_ARG_KW_ONLY  | MP_ARG_INT, { .u_int = -1 } },
         { MP_QSTR_callback,     MP_ARG_KW_ONLY  | MP_ARG_OBJ, { .u_obj = NULL } },
-        { MP_QSTR_period,       MP_ARG_KW_ONLY  | MP_ARG_INT, { .u_int = -1 } }
+        { MP_QSTR_period,       MP_ARG_KW_ONLY  | MP_ARG_INT, { .u_int = -1 } },
+        { MP_QSTR_freq,         MP_ARG_KW_ONLY  | MP_ARG_OBJ, { .u_obj = mp_const_none } }
     };
 
     mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
@@ -251,7 +421,7 @@ static mp_obj_t machine_timer_init(size_t n_args, const mp_obj_t *pos_args, mp_m
         (machine_timer_obj_t *)args[ARG_self].u_obj,
         (int16_t)args[ARG_mode].u_int,
         args[ARG_callback].u_obj,
-        (int32_t)args[ARG_period].u_int
+        machine_timer_period_ns(args[ARG_period].u_int, args[ARG_freq].u_obj)
     );
 
     return mp_const_none;
@@ -6,20 +6,22 @@
 #ifndef __MACHINE_TIMER_H__
     #define __MACHINE_TIMER_H__
 
-    #define TIMER_COUNT    20
-
     typedef struct _machine_timer_obj_t {
         mp_obj_base_t base;
-        uint8_t id;
+        mp_int_t id;
         bool active;
 
         uint8_t repeat;
-        uint16_t period;
-        uint16_t ms_ticks;
+        uint64_t period_ns;
+        // absolute CLOCK_MONOTONIC time the timer fires next
+        uint64_t deadline_ns;
+        // position in the deadline heap while the timer is active
+        size_t heap_index;
         mp_obj_t callback;
 
+        struct _machine_timer_obj_t *next;
     } machine_timer_obj_t;
 
     void machine_timer_deinit_all(void);
 
-#endif // __MACHINE_TIMER_H__
\ No newline at end of file
+#endif // __MACHINE_TIMER_H__
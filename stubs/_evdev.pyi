@@ -0,0 +1,56 @@
+# Copyright (c) 2024 - 2025 Kevin G. Schlosser
+
+# Linux only, unix port
+
+import lvgl as lv  # NOQA
+
+
+class Device(object):
+    """
+    evdev input device (/dev/input/eventN) that is opened non-blocking.
+
+    All events that are waiting get read each time one of the read methods
+    is called and the result is written to the `lv.indev_data_t` object LVGL
+    passes to the read callback.
+    """
+
+    def __init__(
+        self,
+        path: str,
+        /,
+        *,
+        hor_res: int,
+        ver_res: int,
+        swap_xy: bool = False,
+        mirror_x: bool = False,
+        mirror_y: bool = False,
+        grab: bool = False
+    ):
+        ...
+
+    def read_pointer(self, data: lv.indev_data_t, /) -> None:
+        """
+        Fills point, state and continue_reading of data.
+        """
+        ...
+
+    def read_key(self, data: lv.indev_data_t, /) -> None:
+        """
+        Fills key, state and continue_reading of data.
+        """
+        ...
+
+    def get_name(self) -> str:
+        ...
+
+    def has_multitouch(self) -> bool:
+        ...
+
+    def set_resolution(self, hor_res: int, ver_res: int, /) -> None:
+        ...
+
+    def fileno(self) -> int:
+        ...
+
+    def close(self) -> None:
+        ...
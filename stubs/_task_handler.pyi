@@ -0,0 +1,62 @@
+# Copyright (c) 2024 - 2025 Kevin G. Schlosser
+
+from typing import Any, Callable, List, Optional, Tuple
+
+TASK_HANDLER_STARTED: int = ...
+TASK_HANDLER_FINISHED: int = ...
+# True when LVGL was built with an OS and runs on a thread of its own
+THREADED: bool = ...
+# number of threads LVGL's software renderer draws with
+DRAW_UNITS: int = ...
+
+
+class TaskHandler(object):
+    """
+    Native part of `task_handler.TaskHandler`.
+
+    `timer_cb` is given to `timer` and schedules `run` if an update is not
+    already waiting. `run` calls `lv.task_handler()`, the callbacks are only
+    called if the list is not empty. LVGL's clock is `time.ticks_ms()`, it
+    is set by `lv.init()`. After each update the timer period is set to the time until the
+    next LVGL timer is due, limited to `duration` and `max_period`.
+
+    The read timers of the input devices are paused while none of them is
+    pressed or scrolling, they are read every `input_idle_period`
+    milliseconds and by `wake` until one of them has input again. 0 leaves
+    the read timers running.
+
+    When `THREADED` is True `timer` is not used and the updates are done by
+    LVGL's render thread instead.
+    """
+
+    def __init__(
+        self,
+        timer: Optional[Any],
+        callbacks: List[Tuple[Callable[[int, Any], Optional[bool]], int, Any]],
+        exception_hook: Optional[Callable[[Exception], None]],
+        callback_exception_hook: Optional[Callable[[Exception], None]] = None,
+        /,
+        *,
+        duration: int = 33,
+        max_period: int = 1000,
+        input_idle_period: int = 100
+    ):
+        ...
+
+    def run(self) -> None:
+        ...
+
+    def timer_cb(self, timer: Any, /) -> None:
+        ...
+
+    def wake(self) -> None:
+        ...
+
+    def disable(self) -> None:
+        ...
+
+    def enable(self) -> None:
+        ...
+
+    def deinit(self) -> None:
+        ...
@@ -59,6 +59,10 @@ class DisplayDriver:
     _frame_buffer2: Optional[_BufferType] = ...
     _backup_set_memory_location: Optional[Callable] = ...
     _rotation: int = ...
+    _coalesce_overhead: int = ...
+    _coalesce_areas: list[Tuple[int, int, int, int, int]] = ...
+    _coalesce_count: int = ...
+    _native_flush: Optional[Callable] = ...
     _spi_3wire: lcd_bus.SPI3Wire = None
 
     # Default values of "power" and "backlight" are reversed logic! 0 means ON.
@@ -229,6 +233,31 @@ class DisplayDriver:
     def set_default(self) -> None:
         ...
 
+    def set_flush_coalescing(self, enable: bool, cmd_overhead: int = 96) -> None:
+        """
+        Merges areas invalidated during a refresh when sending one larger
+        window costs less than sending each area on its own. The cost of an
+        area is the number of bytes in it plus `cmd_overhead`, which is what
+        setting up a window (CASET, RASET and RAMWR) costs in bytes of pixel
+        data. Use the bus `stats()` to compare before and after.
+        """
+        ...
+
+    def set_native_flush(self, enable: bool) -> None:
+        """
+        Sends the areas LVGL renders to the bus from C instead of calling
+        `_flush_cb`, the bus tells LVGL the area has been sent from C as well.
+        This gets turned on by itself when LVGL runs on a thread of its own
+        (`task_handler.THREADED`).
+
+        Only drivers that use the flush and the address window of this class
+        are able to use it, NotImplementedError is raised for the others.
+        """
+        ...
+
+    def get_coalesce_count(self) -> int:
+        ...
+
     def get_rotation(self) -> int:
         ...
 
@@ -1,6 +1,6 @@
 # Copyright (c) 2024 - 2025 Kevin G. Schlosser
 
-from typing import Any, Callable, Optional, Union, ClassVar, Final
+from typing import Any, Callable, Optional, Union, ClassVar, Final, Tuple
 import array
 import machine
 
@@ -13,6 +13,15 @@ MEMORY_SPIRAM: Final[int] = ...
 MEMORY_INTERNAL: Final[int] = ...
 MEMORY_DEFAULT: Final[int] = ...
 DEBUG_ENABLED: Final[int] = ...
+DITHER_NONE: Final[int] = ...
+DITHER_ORDERED: Final[int] = ...
+DITHER_ERROR_DIFFUSION: Final[int] = ...
+WIRE_RGB565: Final[int] = ...
+WIRE_BGR565: Final[int] = ...
+WIRE_RGB666: Final[int] = ...
+WIRE_BGR666: Final[int] = ...
+WIRE_RGB888: Final[int] = ...
+WIRE_BGR888: Final[int] = ...
 
 
 class I2CBus:
@@ -61,6 +70,28 @@ class I2CBus:
     def free_framebuffer(self, framebuffer: memoryview, /) -> None:
         ...
 
+    def set_rgb565_conversion(self, src_bpp: int, dither: int = DITHER_NONE, /) -> None:
+        ...
+
+    def set_wire_format(self, format: int, bounce_size: int = 4095, /) -> None:
+        ...
+
+    def stats(self) -> dict:
+        """
+        Performance counters for the bus.
+
+        keys: `bytes_sent`, `tx_color_count`, `flush_count`, `tx_param_count`,
+        `param_bytes_sent`, `blocked_time_us`, `copy_time_us`, `copy_count`, `latency_avg_us`, `latency_max_us`,
+        `latency_histogram` and `latency_bounds_us`.
+
+        `latency_bounds_us` holds the upper bound of each histogram bucket,
+        the last bucket in `latency_histogram` has no upper bound.
+        """
+        ...
+
+    def reset_stats(self) -> None:
+        ...
+
 
 class SPIBus:
 
@@ -108,6 +139,203 @@ class SPIBus:
     def free_framebuffer(self, framebuffer: memoryview, /) -> None:
         ...
 
+    def set_rgb565_conversion(self, src_bpp: int, dither: int = DITHER_NONE, /) -> None:
+        ...
+
+    def set_wire_format(self, format: int, bounce_size: int = 4095, /) -> None:
+        ...
+
+    def stats(self) -> dict:
+        """
+        Performance counters for the bus.
+
+        keys: `bytes_sent`, `tx_color_count`, `flush_count`, `tx_param_count`,
+        `param_bytes_sent`, `blocked_time_us`, `copy_time_us`, `copy_count`, `latency_avg_us`, `latency_max_us`,
+        `latency_histogram` and `latency_bounds_us`.
+
+        `latency_bounds_us` holds the upper bound of each histogram bucket,
+        the last bucket in `latency_histogram` has no upper bound.
+        """
+        ...
+
+    def reset_stats(self) -> None:
+        ...
+
+
+class MemoryBus:
+    """
+    Display bus without a display. The areas sent using `tx_color` are copied
+    into a frame buffer the size of the display. The frame buffer is
+    available using the buffer protocol, `memoryview(bus)`, once `init` has
+    been called. Not available on the ESP32.
+    """
+
+    def __init__(
+        self,
+        *,
+        delay_us: int = 0,
+        crc: bool = True
+    ):
+        """
+        :param delay_us: time each transfer takes before it finishes, 0 finishes
+                         as soon as the data has been copied.
+        :param crc: calculate a CRC-32 of the frame buffer after each frame.
+                    It is the same value `binascii.crc32(memoryview(bus))` returns.
+        """
+        ...
+
+    def init(
+        self, width: int, height: int, bpp: int, buffer_size: int,
+        rgb565_byte_swap: bool, cmd_bits: int, param_bits: int, /
+    ) -> None:
+        ...
+
+    def deinit(self) -> None:
+        ...
+
+    def get_crc(self) -> int:
+        """
+        CRC-32 of the frame buffer after the last frame was finished.
+        """
+        ...
+
+    def get_frame_count(self) -> int:
+        ...
+
+    def set_delay(self, delay_us: int, /) -> None:
+        ...
+
+    def register_callback(
+        self,
+        callback: Callable[[Any, Any], None],
+        /
+    ) -> None:
+        ...
+
+    def tx_param(
+        self,
+        cmd: int,
+        params: Optional[_BufferType] = None,
+        /
+    ) -> None:
+        ...
+
+    def rx_param(self, cmd: int, data: _BufferType, /) -> None:
+        ...
+
+    def tx_color(self, cmd: int, data: _BufferType, start_x: int, start_y: int, end_x: int, end_y: int, rotation: int, last_update: bool, /) -> None:
+        ...
+
+    def get_lane_count(self) -> int:
+        ...
+
+    def allocate_framebuffer(self, size: int, caps: int, /) -> Union[None, memoryview]:
+        ...
+
+    def free_framebuffer(self, framebuffer: memoryview, /) -> None:
+        ...
+
+    def set_rgb565_conversion(self, src_bpp: int, dither: int = DITHER_NONE, /) -> None:
+        ...
+
+    def set_wire_format(self, format: int, bounce_size: int = 4095, /) -> None:
+        ...
+
+    def stats(self) -> dict:
+        ...
+
+    def reset_stats(self) -> None:
+        ...
+
+
+class FBDevBus:
+    """
+    Linux frame buffer device. The device memory gets mapped by `init` and
+    `allocate_framebuffer` returns the pages of it so LVGL is able to render
+    in direct mode right into the memory that is being shown. Only
+    available on Linux builds of the unix port.
+    """
+
+    def __init__(
+        self,
+        *,
+        device: str = '/dev/fb0',
+        vsync: bool = False,
+        page_flip: bool = False
+    ):
+        """
+        :param device: frame buffer device. Any file that can be mapped is
+                       able to be used for testing, it gets made large enough
+                       to hold the display.
+        :param vsync: wait for the vertical blanking period before a finished
+                      frame is shown.
+        :param page_flip: make the device 2 screens tall and pan between them
+                          so the second screen is able to be used as the second
+                          frame buffer.
+        """
+        ...
+
+    def init(
+        self, width: int, height: int, bpp: int, buffer_size: int,
+        rgb565_byte_swap: bool, cmd_bits: int, param_bits: int, /
+    ) -> None:
+        """
+        width, height and bpp have to match the mode the device is set to.
+        """
+        ...
+
+    def deinit(self) -> None:
+        ...
+
+    def get_page_count(self) -> int:
+        """
+        Number of screens the mapped memory holds, 2 when page flipping is
+        being used.
+        """
+        ...
+
+    def register_callback(
+        self,
+        callback: Callable[[Any, Any], None],
+        /
+    ) -> None:
+        ...
+
+    def tx_param(
+        self,
+        cmd: int,
+        params: Optional[_BufferType] = None,
+        /
+    ) -> None:
+        ...
+
+    def rx_param(self, cmd: int, data: _BufferType, /) -> None:
+        ...
+
+    def tx_color(self, cmd: int, data: _BufferType, start_x: int, start_y: int, end_x: int, end_y: int, rotation: int, last_update: bool, /) -> None:
+        ...
+
+    def get_lane_count(self) -> int:
+        ...
+
+    def allocate_framebuffer(self, size: int, caps: int, /) -> Union[None, memoryview]:
+        ...
+
+    def free_framebuffer(self, framebuffer: memoryview, /) -> None:
+        ...
+
+    def set_rgb565_conversion(self, src_bpp: int, dither: int = DITHER_NONE, /) -> None:
+        ...
+
+    def set_wire_format(self, format: int, bounce_size: int = 4095, /) -> None:
+        ...
+
+    def stats(self) -> dict:
+        ...
+
+    def reset_stats(self) -> None:
+        ...
+
 
 class SDLBus:
     WINDOW_FULLSCREEN: ClassVar[int] = ...
@@ -125,8 +353,16 @@ class SDLBus:
     def __init__(
         self,
         *,
-        flags: int
+        flags: int,
+        render_thread: bool = False
     ):
+        """
+        :param flags: SDL window flags
+        :param render_thread: present from a separate thread. Flushed areas
+                              are copied into one of 2 staging buffers and the
+                              thread uploads and presents the frame while the
+                              next one is being rendered.
+        """
         ...
 
     def init(
@@ -166,6 +402,19 @@ class SDLBus:
     ) -> None:
         ...
 
+    def read_pointer(self) -> Optional[Tuple[int, int, int, int, int, int]]:
+        """
+        Oldest queued pointer event as
+        (state, x, y, wheel_x, wheel_y, pending) or None.
+        """
+        ...
+
+    def read_key(self) -> Optional[Tuple[int, int, int, int]]:
+        """
+        Oldest queued key event as (state, key, mod, pending) or None.
+        """
+        ...
+
     def set_window_size(
         self,
         width: int,
@@ -203,6 +452,28 @@ class SDLBus:
     def free_framebuffer(self, framebuffer: memoryview, /) -> None:
         ...
 
+    def set_rgb565_conversion(self, src_bpp: int, dither: int = DITHER_NONE, /) -> None:
+        ...
+
+    def set_wire_format(self, format: int, bounce_size: int = 4095, /) -> None:
+        ...
+
+    def stats(self) -> dict:
+        """
+        Performance counters for the bus.
+
+        keys: `bytes_sent`, `tx_color_count`, `flush_count`, `tx_param_count`,
+        `param_bytes_sent`, `blocked_time_us`, `copy_time_us`, `copy_count`, `latency_avg_us`, `latency_max_us`,
+        `latency_histogram` and `latency_bounds_us`.
+
+        `latency_bounds_us` holds the upper bound of each histogram bucket,
+        the last bucket in `latency_histogram` has no upper bound.
+        """
+        ...
+
+    def reset_stats(self) -> None:
+        ...
+
     def poll_events(self):
         ...
 
@@ -245,7 +516,8 @@ class RGBBus:
         pclk_active_low: bool = False,
         disp_active_low: bool = False,
         refresh_on_demand: bool = False,
-        rgb565_dither: bool = False
+        rgb565_dither: bool = False,
+        vsync_refresh: bool = False
     ):
         ...
 
@@ -276,6 +548,41 @@ class RGBBus:
     def free_framebuffer(self, framebuffer: memoryview, /) -> None:
         ...
 
+    def set_rgb565_conversion(self, src_bpp: int, dither: int = DITHER_NONE, /) -> None:
+        ...
+
+    def set_wire_format(self, format: int, bounce_size: int = 4095, /) -> None:
+        ...
+
+    def stats(self) -> dict:
+        """
+        Performance counters for the bus.
+
+        keys: `bytes_sent`, `tx_color_count`, `flush_count`, `tx_param_count`,
+        `param_bytes_sent`, `blocked_time_us`, `copy_time_us`, `copy_count`, `latency_avg_us`, `latency_max_us`,
+        `latency_histogram` and `latency_bounds_us`.
+
+        `latency_bounds_us` holds the upper bound of each histogram bucket,
+        the last bucket in `latency_histogram` has no upper bound.
+        """
+        ...
+
+    def reset_stats(self) -> None:
+        ...
+
+    def get_vsync_stats(self) -> dict:
+        """
+        Frame pacing counters for the bus.
+
+        keys: `enabled` (vsync_refresh), `refresh_period_us`, `vsync_count`,
+        `frames`, `late` and `skipped`.
+
+        A frame is late when it gets shown more than one refresh after LVGL
+        started on it, `skipped` is the number of refreshes that showed the
+        previous frame again because of late frames.
+        """
+        ...
+
 
 class I80Bus:
 
@@ -341,6 +648,28 @@ class I80Bus:
     def free_framebuffer(self, framebuffer: memoryview, /) -> None:
         ...
 
+    def set_rgb565_conversion(self, src_bpp: int, dither: int = DITHER_NONE, /) -> None:
+        ...
+
+    def set_wire_format(self, format: int, bounce_size: int = 4095, /) -> None:
+        ...
+
+    def stats(self) -> dict:
+        """
+        Performance counters for the bus.
+
+        keys: `bytes_sent`, `tx_color_count`, `flush_count`, `tx_param_count`,
+        `param_bytes_sent`, `blocked_time_us`, `copy_time_us`, `copy_count`, `latency_avg_us`, `latency_max_us`,
+        `latency_histogram` and `latency_bounds_us`.
+
+        `latency_bounds_us` holds the upper bound of each histogram bucket,
+        the last bucket in `latency_histogram` has no upper bound.
+        """
+        ...
+
+    def reset_stats(self) -> None:
+        ...
+
 
 def _pump_main_thread() -> None:
     ...
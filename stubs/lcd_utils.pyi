@@ -49,4 +49,36 @@ def spi_polarity_phase_to_mode(polarity: int, phase: int, /) -> int:
 
     :returns: 0, 1, 2 or 3
     :rtype: `int`
-    """
\ No newline at end of file
+    """
+
+def i1_to_pages(
+    src: memoryview,
+    page_buf: bytearray | memoryview,
+    page_width: int,
+    x1: int,
+    y1: int,
+    x2: int,
+    y2: int,
+    *,
+    out: bytearray | memoryview | None = None
+) -> int:
+    """
+    Packs an area rendered by LVGL in the I1 color format into the vertical
+    8 pixels per byte page format used by monochrome controllers like the
+    SSD1306 and the ST7565.
+
+    :param src: area data without the 8 byte palette LVGL puts in front of it
+    :param page_buf: copy of the display ram, `page_width` bytes per page.
+                     Only the rows that are in the area are changed.
+    :param page_width: number of columns in a page
+    :param x1: left of the area (inclusive)
+    :param y1: top of the area (inclusive)
+    :param x2: right of the area (inclusive)
+    :param y2: bottom of the area (inclusive)
+    :param out: if given the columns `x1` to `x2` of the pages the area
+                touches get copied into it one page after another.
+
+    :returns: number of bytes written to `out`
+    :rtype: `int`
+    """
+    ...
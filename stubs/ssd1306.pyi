@@ -15,6 +15,8 @@ BYTE_ORDER_BGR: Final[int]
 
 class SSD1306(display_driver_framework.DisplayDriver):
     _pages: int
+    _page_buf: bytearray
+    _tx_buf: memoryview
 
     def __init__(
         self,
@@ -13,4 +13,9 @@ BYTE_ORDER_BGR: Final[int]
 
 
 class ST7565(display_driver_framework.DisplayDriver):
-    ...
+    _pages: int
+    _page_buf: bytearray
+    _tx_buf: memoryview
+
+    def _flush_cb(self, _, area, color_p) -> None:
+        ...
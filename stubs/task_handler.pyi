@@ -1,8 +1,13 @@
 # MIT license; Copyright (c) 2021 Amir Gonnen
 # Copyright (c) 2024 - 2025 Kevin G. Schlosser
 
-from typing import Callable, ClassVar, Optional
+from typing import Any, Callable, ClassVar, List, Optional, Tuple
 from machine import Timer
+import _task_handler
+
+TASK_HANDLER_STARTED: int = ...
+TASK_HANDLER_FINISHED: int = ...
+THREADED: bool = ...
 
 _default_timer_id: int = ...
 
@@ -16,24 +21,34 @@ class TaskHandler(object):
     _current_instance: Optional[ClassVar["TaskHandler"]] = ...
 
     duration: int = ...
-    refresh_cb: Optional[Callable] = ...
-    _timer: Timer = ...
-    _task_handler_ref: Callable = ...
+    _timer: Optional[Timer] = ...
+    _handler: _task_handler.TaskHandler = ...
+    _callbacks: List[Tuple[Callable[[int, Any], Optional[bool]], int, Any]] = ...
 
     exception_hook: Callable[[Exception], None] = ...
-    max_scheduled: int = ...
-    _scheduled: int = ...
 
     def __init__(
         self,
         duration: int = 33,
         timer_id: int = _default_timer_id,
         max_scheduled: int = 2,
-        refresh_cb: Optional[Callable] = None,
-        exception_hook: Callable[[Exception], None] = _default_exception_hook
+        exception_hook: Callable[[Exception], None] = _default_exception_hook,
+        max_period: int = 1000,
+        input_idle_period: int = 100
     ):
         ...
 
+    def add_event_cb(
+        self,
+        callback: Callable[[int, Any], Optional[bool]],
+        event: int,
+        user_data: Any = ...
+    ) -> None:
+        ...
+
+    def remove_event_cb(self, callback: Callable[[int, Any], Optional[bool]]) -> None:
+        ...
+
     def deinit(self) -> None:
         ...
 
@@ -43,12 +58,9 @@ class TaskHandler(object):
     def enable(self) -> None:
         ...
 
-    @classmethod
-    def is_running(cls) -> bool:
-        ...
-
-    def _task_handler(self, _) -> None:
+    def wake(self) -> None:
         ...
 
-    def _timer_cb(self, _) -> None:
+    @classmethod
+    def is_running(cls) -> bool:
         ...